@@ -569,9 +569,36 @@ extern "C"
 				? _st_dst : _st_lnk;
 		}
 
+		void Finalize(const char *name)
+		{
+#if defined(__APPLE__) || defined(__FreeBSD__)  || defined(__DragonFly__)
+			if (DereferencedStat().st_flags & UF_HIDDEN) { // chflags hidden FILENAME
+				_attr|= FILE_ATTRIBUTE_HIDDEN;
+			}
+#endif
+			_attr|= EvaluateAttributesT(DereferencedStat().st_mode, name);
+		}
+
 	public:
-		Statocaster(const char *pathname, const char *name = nullptr)
+		// If <dirfd> given then <name> is stat'ed relatively to it, saving kernel from resolving
+		// whole <pathname> again for each directory entry; <pathname> still used as fallback
+		// cuz it may need sudo that only path-based calls can go through.
+		Statocaster(const char *pathname, const char *name = nullptr, int dirfd = -1)
 		{
+			if (dirfd != -1 && name && fstatat(dirfd, name, &_st_lnk, AT_SYMLINK_NOFOLLOW) == 0) {
+				if ((_st_lnk.st_mode & S_IFMT) != S_IFLNK) {
+					_attr = 0;
+				} else if (fstatat(dirfd, name, &_st_dst, 0) == 0
+						|| os_call_int(sdc_stat, pathname, &_st_dst) == 0) {
+					_attr = FILE_ATTRIBUTE_REPARSE_POINT;
+				} else {
+					_attr = FILE_ATTRIBUTE_REPARSE_POINT | FILE_ATTRIBUTE_BROKEN;
+					_st_lnk.st_size = 0;
+				}
+				Finalize(name);
+				return;
+			}
+
 			if (os_call_int(sdc_lstat, pathname, &_st_lnk) < 0) {
 				_attr = INVALID_FILE_ATTRIBUTES;
 				return;
@@ -592,12 +619,7 @@ extern "C"
 				_attr = FILE_ATTRIBUTE_REPARSE_POINT;
 			}
 
-#if defined(__APPLE__) || defined(__FreeBSD__)  || defined(__DragonFly__)
-			if (DereferencedStat().st_flags & UF_HIDDEN) { // chflags hidden FILENAME
-				_attr|= FILE_ATTRIBUTE_HIDDEN;
-			}
-#endif
-			_attr|= EvaluateAttributesT(DereferencedStat().st_mode, name);
+			Finalize(name);
 		}
 
 		inline DWORD Attributes() const
@@ -716,11 +738,15 @@ extern "C"
 			_d = os_call_pv<DIR>(sdc_opendir, _root.c_str());
 			if (!_d) {
 				fprintf(stderr, "opendir failed on %s\n", _root.c_str());
+			} else {
+				// not dirfd(_d): DIR opened via sudo is backed by unrelated local descriptor
+				_dfd = open(_root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
 			}
 		}
 
 		~UnixFindFile()
 		{
+			if (_dfd != -1) close(_dfd);
 			if (_d) os_call_int(sdc_closedir, _d);
 		}
 
@@ -791,7 +817,7 @@ extern "C"
 			_tmp.path+= name;
 
 			SudoSilentQueryRegion ssqr(hint_mode_type !=0 && (_flags & FIND_FILE_FLAG_NOT_ANNOYING) != 0);
-			if (!Statocaster(_tmp.path.c_str(), name).FillWFD(wfd)) {
+			if (!Statocaster(_tmp.path.c_str(), name, _dfd).FillWFD(wfd)) {
 				fprintf(stderr, "UnixFindFile: errno=%u hmt=0%o on '%s'\n",
 					errno, hint_mode_type, _tmp.path.c_str());
 				ZeroFillWFD(wfd);
@@ -845,6 +871,7 @@ extern "C"
 		}
 
 		DIR *_d = nullptr;
+		int _dfd = -1;
 
 #ifndef __HAIKU__
 		bool PreMatchDType(unsigned char d_type)
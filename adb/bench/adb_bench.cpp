@@ -0,0 +1,264 @@
+// adb_bench: measures ADBDevice/ADBShell against fake_adb.py — a scripted `adb` whose "device" is this host behind a
+// simulated link — so plugin changes can be compared without a phone. Not a test: it prints numbers, it doesn't judge.
+//
+//   adb_bench [--scale N] [--latency MS] [--bandwidth BYTES_PER_SEC] [--spawn MS] [--fake PATH] [--report] [--keep]
+
+// Standard library includes
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// System includes
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+// Local includes
+#include "ADBDevice.h"
+#include "ADBStats.h"
+
+#ifndef ADB_BENCH_FAKE_ADB
+#define ADB_BENCH_FAKE_ADB "fake_adb.py"
+#endif
+
+namespace {
+
+constexpr const char* kSerial = "bench-0001";
+
+struct Options {
+    unsigned scale = 1;
+    std::string latency_ms = "2";
+    std::string bandwidth = "40000000";
+    std::string spawn_ms = "5";
+    std::string fake = ADB_BENCH_FAKE_ADB;
+    bool report = false;
+    bool keep = false;
+};
+
+bool MakeFile(const std::string& path, uint64_t size) {
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    std::vector<char> buf(64 * 1024, 'x');
+    bool ok = true;
+    while (ok && size > 0) {
+        const size_t n = (size_t)std::min<uint64_t>(size, buf.size());
+        ok = write(fd, buf.data(), n) == (ssize_t)n;
+        size -= n;
+    }
+    return (close(fd) == 0) && ok;
+}
+
+bool MakeDir(const std::string& path) {
+    return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+// Tree of `depth` levels, `fanout` subdirs and `files` small files per directory; collects every directory.
+void MakeDeepTree(const std::string& root, int depth, int fanout, int files, std::vector<std::string>& dirs) {
+    MakeDir(root);
+    dirs.push_back(root);
+    for (int f = 0; f < files; ++f) MakeFile(root + "/f" + std::to_string(f) + ".dat", 512);
+    if (depth == 0) return;
+    for (int d = 0; d < fanout; ++d) MakeDeepTree(root + "/d" + std::to_string(d), depth - 1, fanout, files, dirs);
+}
+
+struct Row {
+    std::string name;
+    double ms = 0;
+    uint64_t items = 0;
+    uint64_t bytes = 0;
+    uint64_t shell_commands = 0;
+    uint64_t spawns = 0;
+};
+
+// Runs fn `repeat` times; wall time is the average, counters are per run.
+Row Measure(const std::string& name, int repeat, const std::function<uint64_t(uint64_t&)>& fn) {
+    Row row;
+    row.name = name;
+    const uint64_t cmds0 = ADBStats::Get(ADBStats::SHELL_COMMANDS);
+    const uint64_t spawns0 = ADBStats::Get(ADBStats::PROCESS_SPAWNS);
+    const auto started = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; ++i) {
+        uint64_t bytes = 0;
+        row.items = fn(bytes);
+        row.bytes = bytes;
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - started;
+    row.ms = std::chrono::duration<double, std::milli>(elapsed).count() / repeat;
+    row.shell_commands = (ADBStats::Get(ADBStats::SHELL_COMMANDS) - cmds0) / repeat;
+    row.spawns = (ADBStats::Get(ADBStats::PROCESS_SPAWNS) - spawns0) / repeat;
+    return row;
+}
+
+void PrintRow(const Row& r) {
+    char mibs[32] = "-";
+    if (r.bytes && r.ms > 0) snprintf(mibs, sizeof(mibs), "%.1f", (double)r.bytes / (1024.0 * 1024.0) / (r.ms / 1000.0));
+    printf("%-28s %10.1f %8llu %10s %8llu %8llu\n", r.name.c_str(), r.ms, (unsigned long long)r.items, mibs,
+           (unsigned long long)r.shell_commands, (unsigned long long)r.spawns);
+    fflush(stdout);
+}
+
+bool ParseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        auto value = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : nullptr; };
+        const char* v = nullptr;
+        if (a == "--report") opt.report = true;
+        else if (a == "--keep") opt.keep = true;
+        else if (a == "--scale" && (v = value())) opt.scale = (unsigned)std::max(1, atoi(v));
+        else if (a == "--latency" && (v = value())) opt.latency_ms = v;
+        else if (a == "--bandwidth" && (v = value())) opt.bandwidth = v;
+        else if (a == "--spawn" && (v = value())) opt.spawn_ms = v;
+        else if (a == "--fake" && (v = value())) opt.fake = v;
+        else return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!ParseArgs(argc, argv, opt)) {
+        fprintf(stderr, "usage: %s [--scale N] [--latency MS] [--bandwidth BYTES_PER_SEC] [--spawn MS] "
+                        "[--fake PATH] [--report] [--keep]\n", argv[0]);
+        return 2;
+    }
+
+    char tmpl[] = "/tmp/adb_bench.XXXXXX";
+    if (!mkdtemp(tmpl)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    const std::string work = tmpl;
+    const std::string bin = work + "/bin", dev = work + "/device", host = work + "/host";
+    MakeDir(bin);
+    MakeDir(dev);
+    MakeDir(host);
+
+    // `adb` on PATH is the fake; an unsupported server spec keeps the plugin off the real adb server.
+    char fake_abs[PATH_MAX];
+    if (!realpath(opt.fake.c_str(), fake_abs) || symlink(fake_abs, (bin + "/adb").c_str()) != 0) {
+        fprintf(stderr, "cannot use fake adb '%s'\n", opt.fake.c_str());
+        return 1;
+    }
+    const char* path = getenv("PATH");
+    setenv("PATH", (bin + ":" + (path ? path : "/usr/bin:/bin")).c_str(), 1);
+    setenv("ADB_SERVER_SOCKET", "bench:", 1);
+    setenv("FAKE_ADB_SERIAL", kSerial, 1);
+    setenv("FAKE_ADB_LATENCY_MS", opt.latency_ms.c_str(), 1);
+    setenv("FAKE_ADB_BANDWIDTH", opt.bandwidth.c_str(), 1);
+    setenv("FAKE_ADB_SPAWN_MS", opt.spawn_ms.c_str(), 1);
+
+    // Representative trees: one wide folder, a deep tree, many small files, a few large ones.
+    const unsigned s = opt.scale;
+    const std::string wide = dev + "/wide", deep = dev + "/deep", small = dev + "/small", large = dev + "/large";
+    MakeDir(wide);
+    for (unsigned i = 0; i < 5000 * s; ++i) MakeFile(wide + "/IMG_" + std::to_string(i) + ".jpg", 0);
+    std::vector<std::string> deep_dirs;
+    MakeDeepTree(deep, 5, 3, 4, deep_dirs);
+    MakeDir(small);
+    for (unsigned i = 0; i < 500 * s; ++i) MakeFile(small + "/note_" + std::to_string(i) + ".txt", 4096);
+    MakeDir(large);
+    for (unsigned i = 0; i < 4; ++i) MakeFile(large + "/video_" + std::to_string(i) + ".mp4", (uint64_t)8 * s << 20);
+
+    printf("fake adb: latency %s ms, bandwidth %s B/s, spawn %s ms, scale %u\n\n",
+           opt.latency_ms.c_str(), opt.bandwidth.c_str(), opt.spawn_ms.c_str(), s);
+
+    ADBDevice device(kSerial);
+    if (!device.Connect()) {
+        fprintf(stderr, "cannot connect through fake adb\n");
+        return 1;
+    }
+
+    printf("%-28s %10s %8s %10s %8s %8s\n", "scenario", "ms", "items", "MiB/s", "shell", "spawns");
+    std::vector<PluginPanelItem> items;
+    std::shared_ptr<const ADBItemStrings> strings;
+
+    PrintRow(Measure("list wide (cold)", 3, [&](uint64_t&) {
+        device.RefreshListing(wide);
+        device.DirectoryEnum(wide, items, strings);
+        const uint64_t n = items.size();
+        return n;
+    }));
+    PrintRow(Measure("list wide (cached)", 10, [&](uint64_t&) {
+        device.DirectoryEnum(wide, items, strings);
+        const uint64_t n = items.size();
+        return n;
+    }));
+    PrintRow(Measure("browse deep (every dir)", 1, [&](uint64_t&) {
+        uint64_t n = 0;
+        for (const auto& d : deep_dirs) {
+            device.RefreshListing(d);
+            device.DirectoryEnum(d, items, strings);
+            n += items.size();
+        }
+        return n;
+    }));
+    PrintRow(Measure("manifest deep (one find)", 3, [&](uint64_t& bytes) {
+        std::map<std::string, FileManifest> manifests;
+        device.BatchDirectoryManifests({deep}, manifests);
+        uint64_t n = 0;
+        for (const auto& f : manifests[deep]) { ++n; bytes += f.second.size; }
+        return n;
+    }));
+    // Selecting a folder starts the fetch; by the time F5 is pressed the pre-scan is a cache read.
+    device.PrefetchDirectoryTotals({deep});
+    usleep(500 * 1000);
+    PrintRow(Measure("sizes deep (prefetched)", 1, [&](uint64_t& bytes) {
+        std::map<std::string, std::unordered_map<std::string, uint64_t>> sizes;
+        device.BatchDirectoryFileSizes({deep}, sizes);
+        for (const auto& f : sizes[deep]) bytes += f.second;
+        return (uint64_t)sizes[deep].size();
+    }));
+    PrintRow(Measure("stat many (wide, 1000)", 3, [&](uint64_t&) {
+        std::vector<std::string> paths;
+        for (unsigned i = 0; i < 1000; ++i) paths.push_back(wide + "/IMG_" + std::to_string(i) + ".jpg");
+        std::vector<RemoteStat> out;
+        device.StatMany(paths, out);
+        return (uint64_t)out.size();
+    }));
+    PrintRow(Measure("shell cat (8 MiB reply)", 3, [&](uint64_t& bytes) {
+        const std::string out = device.RunShellCommand("cat " + ADBUtils::ShellQuote(large + "/video_0.mp4"));
+        bytes = out.size();
+        if (bytes != ((uint64_t)8 * s << 20)) fprintf(stderr, "cat: got %llu bytes\n", (unsigned long long)bytes);
+        return (uint64_t)1;
+    }));
+    // Command-line path: same reply handed out line by line (newline-less data in 1 MiB pieces) as it arrives.
+    PrintRow(Measure("shell cat (8 MiB, streamed)", 3, [&](uint64_t& bytes) {
+        bytes = 0;
+        device.RunShellLinesInCwd("cat " + ADBUtils::ShellQuote(large + "/video_0.mp4"),
+                                  [&](std::string_view piece) { bytes += piece.size(); });
+        if (bytes != ((uint64_t)8 * s << 20)) fprintf(stderr, "cat streamed: got %llu bytes\n", (unsigned long long)bytes);
+        return (uint64_t)1;
+    }));
+
+    auto transfer = [&](const char* name, const std::string& src, unsigned files, uint64_t file_size, bool push) {
+        const std::string pulled = host + "/" + std::string(name);
+        const std::string pushed = dev + "/pushed_" + std::string(name);
+        PrintRow(Measure(std::string(push ? "push " : "pull ") + name, 1, [&](uint64_t& bytes) {
+            const int rc = push ? device.PushDirectory(pulled, pushed, [](int, const std::string&) {})
+                                : device.PullDirectory(src, pulled, [](int, const std::string&) {});
+            if (rc != 0) fprintf(stderr, "%s %s: %s\n", push ? "push" : "pull", name, strerror(rc));
+            bytes = (uint64_t)files * file_size;
+            return (uint64_t)files;
+        }));
+    };
+    transfer("many-small", small, 500 * s, 4096, false);
+    transfer("many-small", small, 500 * s, 4096, true);
+    transfer("few-large", large, 4, (uint64_t)8 * s << 20, false);
+    transfer("few-large", large, 4, (uint64_t)8 * s << 20, true);
+
+    if (opt.report) printf("\n%s", ADBStats::Report().c_str());
+
+    if (!opt.keep) {
+        const std::string cmd = "rm -rf '" + work + "'";
+        if (system(cmd.c_str()) != 0) fprintf(stderr, "could not remove %s\n", work.c_str());
+    } else {
+        printf("\nwork tree kept in %s\n", work.c_str());
+    }
+    return 0;
+}
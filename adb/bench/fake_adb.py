@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+"""Stand-in `adb` client for adb_bench: the "device" is this host, reached through a simulated link.
+
+Emulates what the plugin runs: `version`, `devices -l`, `get-state`, `shell -T` (persistent session), `shell <cmd>`,
+`pull [-p] [-a]` and `push [-p]`. Shell commands run in the local /bin/sh with toybox-like `ls` output.
+Link shape comes from the environment:
+  FAKE_ADB_LATENCY_MS   one-way delay added to each shell chunk and each transfer (default 2)
+  FAKE_ADB_BANDWIDTH    bytes/s for shell output and file data (default 40000000, ~USB 2.0)
+  FAKE_ADB_SPAWN_MS     extra start-up cost per client invocation, like the real client's (default 5)
+  FAKE_ADB_SERIAL       serial reported by `devices -l` (default bench-0001)
+"""
+
+import os
+import queue
+import shutil
+import subprocess
+import sys
+import threading
+import time
+
+LATENCY = float(os.environ.get("FAKE_ADB_LATENCY_MS", "2")) / 1000.0
+BANDWIDTH = float(os.environ.get("FAKE_ADB_BANDWIDTH", "40000000"))
+SPAWN = float(os.environ.get("FAKE_ADB_SPAWN_MS", "5")) / 1000.0
+SERIAL = os.environ.get("FAKE_ADB_SERIAL", "bench-0001")
+CHUNK = 64 * 1024
+
+# toybox prints ISO dates ("2024-01-31 12:00"), which is what the plugin's `ls -la` parser expects.
+SHELL_PRELUDE = 'ls() { command ls --time-style=+%Y-%m-%d\\ %H:%M "$@"; }\n'
+
+
+class Link:
+    """One direction of the simulated link: each chunk leaves after the latency and its share of the bandwidth."""
+
+    def __init__(self, sink):
+        self._sink = sink
+        self._queue = queue.Queue()
+        self._free_at = 0.0
+        self._thread = threading.Thread(target=self._run, daemon=True)
+        self._thread.start()
+
+    def send(self, data):
+        now = time.monotonic()
+        self._free_at = max(self._free_at, now) + len(data) / BANDWIDTH
+        self._queue.put((max(now + LATENCY, self._free_at), data))
+
+    def close(self):
+        self._queue.put((0.0, None))
+        self._thread.join()
+
+    def _run(self):
+        while True:
+            due, data = self._queue.get()
+            if data is None:
+                return
+            delay = due - time.monotonic()
+            if delay > 0:
+                time.sleep(delay)
+            try:
+                self._sink(data)
+            except (BrokenPipeError, OSError):
+                return
+
+
+def write_stdout(data):
+    sys.stdout.buffer.write(data)
+    sys.stdout.buffer.flush()
+
+
+def pump(src_fd, link):
+    while True:
+        data = os.read(src_fd, CHUNK)
+        if not data:
+            return
+        link.send(data)
+
+
+def run_shell(command):
+    """`shell -T` without a command is the plugin's persistent session; with one it is a one-shot."""
+    argv = ["/bin/sh", "-c", SHELL_PRELUDE + command] if command else ["/bin/sh"]
+    proc = subprocess.Popen(argv, stdin=subprocess.PIPE if not command else subprocess.DEVNULL,
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT, cwd="/")
+    down = Link(write_stdout)
+    reader = threading.Thread(target=pump, args=(proc.stdout.fileno(), down), daemon=True)
+    reader.start()
+    if not command:
+        proc.stdin.write(SHELL_PRELUDE.encode())
+        proc.stdin.flush()
+
+        def to_shell(data):
+            proc.stdin.write(data)
+            proc.stdin.flush()
+
+        up = Link(to_shell)
+        try:
+            pump(sys.stdin.fileno(), up)
+        finally:
+            up.close()
+            proc.stdin.close()
+    reader.join()
+    down.close()
+    return proc.wait()
+
+
+def list_files(src):
+    if os.path.isdir(src):
+        for root, _, names in os.walk(src):
+            for n in sorted(names):
+                yield os.path.join(root, n)
+    else:
+        yield src
+
+
+def transfer(args, verb):
+    progress = "-p" in args
+    paths = [a for a in args if not a.startswith("-")]
+    if len(paths) != 2:
+        print("adb: usage: %s SRC DST" % verb)
+        return 1
+    src, dst = paths
+    if not os.path.exists(src):
+        print("adb: error: failed to stat remote object '%s': No such file or directory" % src)
+        return 1
+    if os.path.isdir(dst):
+        dst = os.path.join(dst, os.path.basename(src.rstrip("/")))
+
+    started = time.monotonic()
+    time.sleep(LATENCY)
+    files = 0
+    total = 0
+    for path in list_files(src):
+        rel = os.path.relpath(path, src) if os.path.isdir(src) else ""
+        target = os.path.join(dst, rel) if rel else dst
+        os.makedirs(os.path.dirname(target) or ".", exist_ok=True)
+        size = os.path.getsize(path)
+        done = 0
+        last = -1
+        # One round-trip per file, like the sync protocol's STAT/RECV.
+        time.sleep(2 * LATENCY)
+        with open(path, "rb") as fin, open(target, "wb") as fout:
+            while True:
+                data = fin.read(CHUNK)
+                if not data:
+                    break
+                time.sleep(len(data) / BANDWIDTH)
+                fout.write(data)
+                done += len(data)
+                pct = done * 100 // size if size else 100
+                if progress and pct != last:
+                    last = pct
+                    sys.stdout.write("[%3d%%] %s\n" % (pct, path))
+                    sys.stdout.flush()
+        shutil.copystat(path, target)
+        files += 1
+        total += size
+    secs = max(time.monotonic() - started, 1e-6)
+    sys.stdout.write("%s: %d file%s %s, 0 skipped. %.1f MB/s (%d bytes in %.3fs)\n"
+                     % (src, files, "" if files == 1 else "s", verb + "ed", total / secs / 1e6, total, secs))
+    return 0
+
+
+def main():
+    args = sys.argv[1:]
+    if len(args) >= 2 and args[0] == "-s":
+        args = args[2:]
+    time.sleep(SPAWN)
+    if not args:
+        return 1
+    cmd, rest = args[0], args[1:]
+    if cmd == "version":
+        print("Android Debug Bridge version 1.0.41 (fake_adb for adb_bench)")
+        return 0
+    if cmd == "devices":
+        print("List of devices attached")
+        print("%s\tdevice product:bench model:Bench_Device device:bench transport_id:1" % SERIAL)
+        return 0
+    if cmd == "get-state":
+        print("device")
+        return 0
+    if cmd == "shell":
+        if rest and rest[0] == "-T":
+            rest = rest[1:]
+        return run_shell(" ".join(rest))
+    if cmd in ("pull", "push"):
+        return transfer(rest, cmd)
+    print("adb: unknown command %s" % cmd)
+    return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
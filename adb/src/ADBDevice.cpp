@@ -1,6 +1,13 @@
 #include "ADBDevice.h"
 #include "ADBShell.h"
+#include "ADBShellPool.h"
+#include "ADBSocket.h"
+#include "ADBDirCache.h"
+#include "ADBItemStrings.h"
+#include "ADBDirTotals.h"
+#include "ADBTar.h"
 #include "ADBLog.h"
+#include "ADBStats.h"
 #include <sstream>
 #include <cstring>
 #include <stdexcept>
@@ -55,6 +62,19 @@ void TrimTrailingNewlines(std::string& s)
     }
 }
 
+void ForEachLine(std::string_view text, const std::function<void(std::string_view)>& fn)
+{
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t eol = text.find('\n', pos);
+        if (eol == std::string_view::npos) eol = text.size();
+        std::string_view line = text.substr(pos, eol - pos);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        fn(line);
+        pos = eol + 1;
+    }
+}
+
 int CheckConnection(bool connected)
 {
     return connected ? 0 : EIO;
@@ -219,7 +239,7 @@ bool ProgressParser::ExtractProgress(const std::string &s, int &percent, std::st
 }
 
 ADBDevice::ADBDevice(const std::string &device_serial)
-    : _device_serial(device_serial), _current_path("/"), _adb_shell(nullptr), _connected(false)
+    : _device_serial(device_serial), _current_path("/"), _adb_shell(nullptr), _dir_cache(ADBDirCache::ForDevice(device_serial)), _dir_totals(ADBDirTotals::ForDevice(device_serial)), _shell_pool(ADBShellPool::ForDevice(device_serial)), _sync_enabled(false), _connected(false)
 {
     
     
@@ -256,6 +276,9 @@ bool ADBDevice::Connect()
             return false;
         }
         _current_path = ExtractPathFromPwd(pwd_response);
+        _shell_cwd = _current_path;
+        // The shell just started the adb server if it wasn't running, so sync sessions can connect lazily from here on.
+        _sync_enabled = true;
         _connected = true;
         
         
@@ -272,9 +295,34 @@ void ADBDevice::Disconnect()
         _adb_shell->stop();
         _adb_shell.reset();
     }
+    {
+        std::lock_guard<std::mutex> lock(_sync_mutex);
+        _sync_enabled = false;
+        _sync_idle.clear();
+    }
     _connected = false;
 }
 
+// Bound on idle sessions kept open; extra ones from a wide burst of lanes are closed on release.
+static constexpr size_t kMaxIdleSyncSessions = 16;
+
+std::unique_ptr<ADBSocket> ADBDevice::AcquireSync()
+{
+    std::lock_guard<std::mutex> lock(_sync_mutex);
+    if (!_sync_enabled) return nullptr;
+    if (_sync_idle.empty()) return std::make_unique<ADBSocket>(_device_serial);
+    auto sock = std::move(_sync_idle.back());
+    _sync_idle.pop_back();
+    return sock;
+}
+
+void ADBDevice::ReleaseSync(std::unique_ptr<ADBSocket> sock)
+{
+    if (!sock) return;
+    std::lock_guard<std::mutex> lock(_sync_mutex);
+    if (_sync_enabled && _sync_idle.size() < kMaxIdleSyncSessions) _sync_idle.push_back(std::move(sock));
+}
+
 void ADBDevice::EnsureConnection()
 {
     if (!_connected || !_adb_shell) {
@@ -310,8 +358,8 @@ std::string ADBDevice::RunAdbCommand(const std::vector<std::string> &args, const
     return ADBShell::adbExec(BuildArgs(args), on_chunk);
 }
 
-std::string ADBDevice::RunAdbCommandWithProgress(const std::vector<std::string> &args, const std::function<void(const std::string&)> &on_chunk, const std::function<bool()> &abort_check) {
-    return ADBShell::adbExecWithProgress(BuildArgs(args), on_chunk, abort_check);
+std::string ADBDevice::RunAdbCommandWithProgress(const std::vector<std::string> &args, const std::function<void(const std::string&)> &on_chunk, const std::function<bool()> &abort_check, int *exit_status) {
+    return ADBShell::adbExecWithProgress(BuildArgs(args), on_chunk, abort_check, exit_status);
 }
 
 bool ADBDevice::IsSuccessResult(const std::string& result, bool is_push) const
@@ -327,15 +375,57 @@ bool ADBDevice::IsSuccessResult(const std::string& result, bool is_push) const
            result.find("files pulled") != std::string::npos;
 }
 
-std::string ADBDevice::RunShellCommand(const std::string &command)
+std::string ADBDevice::RunShellCommand(const std::string &command, int *exit_code)
 {
     EnsureConnection();
-    return _adb_shell->shellCommand(command);
+    return _adb_shell->shellCommand(command, exit_code);
+}
+
+std::string ADBDevice::RunShellCommandInCwd(const std::string &command, int *exit_code)
+{
+    // Cached listings skip the `cd`; prepend it in the same roundtrip so relative paths match the panel.
+    if (!_current_path.empty() && _shell_cwd != _current_path) {
+        _shell_cwd = _current_path;
+        return RunShellCommand("cd " + ADBUtils::ShellQuote(_current_path) + " 2>/dev/null; " + command, exit_code);
+    }
+    return RunShellCommand(command, exit_code);
 }
 
-int ADBDevice::LastShellExitCode() const
+bool ADBDevice::RunShellLinesInCwd(const std::string &command, const std::function<void(std::string_view)> &on_line,
+                                   const std::function<bool()> &abort_check, int *exit_code)
 {
-    return _adb_shell ? _adb_shell->lastExitCode() : -1;
+    EnsureConnection();
+    if (exit_code) *exit_code = -1;
+    if (!_adb_shell) return false;
+    std::string full = command;
+    if (!_current_path.empty() && _shell_cwd != _current_path) {
+        _shell_cwd = _current_path;
+        full = "cd " + ADBUtils::ShellQuote(_current_path) + " 2>/dev/null; " + command;
+    }
+    if (_adb_shell->shellCommandLines(full, on_line, abort_check, exit_code)) return true;
+    // A restarted session starts in its own home, not where the panel is.
+    _shell_cwd.clear();
+    return false;
+}
+
+std::string ADBDevice::RunPooledShellCommand(const std::string &command, int *exit_code)
+{
+    EnsureConnection();
+    auto shell = ADBShellPool::Acquire(_shell_pool);
+    if (!shell) return RunShellCommand(command, exit_code);
+    // Pooled sessions never follow the panel's cd.
+    if (_current_path.empty() || _current_path == "/") return shell->shellCommand(command, exit_code);
+    return shell->shellCommand("cd " + ADBUtils::ShellQuote(_current_path) + " 2>/dev/null; " + command, exit_code);
+}
+
+bool ADBDevice::RunPooledShellLines(const std::string &command, const std::function<void(std::string_view)> &on_line,
+                                    const std::function<bool()> &abort_check, int *exit_code)
+{
+    EnsureConnection();
+    if (exit_code) *exit_code = -1;
+    auto shell = ADBShellPool::Acquire(_shell_pool);
+    if (!shell) return _adb_shell && _adb_shell->shellCommandLines(command, on_line, abort_check, exit_code);
+    return shell->shellCommandLines(command, on_line, abort_check, exit_code);
 }
 
 std::string ADBDevice::GetCurrentWorkingDirectory()
@@ -363,14 +453,16 @@ void ADBDevice::SyncPath()
         // Keep previous path if validation rejected pwd output (timeout / malformed marker) — don't blank a valid path.
         if (!extracted.empty()) {
             _current_path = extracted;
+            _shell_cwd = extracted;
         }
     } catch (const std::exception& e) {
         // Ignore - keep current path
     }
 }
 
-wchar_t* ADBDevice::AllocateItemString(const std::string& s) {
-    std::wstring ws = s.empty() ? std::wstring() : StrMB2Wide(s);
+wchar_t* ADBDevice::AllocateItemString(std::string_view s) {
+    std::wstring ws;
+    if (!s.empty()) MB2Wide(s.data(), s.size(), ws);
     size_t len = ws.length() + 1;
     wchar_t* buf = (wchar_t*)malloc(len * sizeof(wchar_t));
     if (!buf) {
@@ -380,7 +472,36 @@ wchar_t* ADBDevice::AllocateItemString(const std::string& s) {
     return buf;
 }
 
-std::string ADBDevice::DirectoryEnum(const std::string &path, std::vector<PluginPanelItem> &files)
+namespace {
+
+// Next whitespace-delimited field of `s` starting at `pos`; empty view at end of line.
+std::string_view NextField(std::string_view s, size_t &pos)
+{
+    while (pos < s.size() && s[pos] == ' ') ++pos;
+    const size_t start = pos;
+    while (pos < s.size() && s[pos] != ' ') ++pos;
+    return s.substr(start, pos - start);
+}
+
+template <class T>
+bool ParseNumber(std::string_view s, T &out)
+{
+    if (s.empty()) return false;
+    T v = 0;
+    for (char c : s) {
+        if (c < '0' || c > '9') return false;
+        v = v * 10 + (T)(c - '0');
+    }
+    out = v;
+    return true;
+}
+
+} // namespace
+
+std::string ADBDevice::DirectoryEnum(const std::string &path, std::vector<PluginPanelItem> &files,
+                                     std::shared_ptr<const ADBItemStrings> &strings,
+                                     const std::function<void(size_t)> &on_count,
+                                     const std::function<bool()> &abort_check)
 {
 
     if (!_connected || !_adb_shell) {
@@ -402,111 +523,140 @@ std::string ADBDevice::DirectoryEnum(const std::string &path, std::vector<Plugin
              << "[ -L \"$f\" ] && ([ -d \"$f\" ] && echo \"$f" << arrow << "D\" "
              << "|| ([ -f \"$f\" ] && echo \"$f" << arrow << "F\" || echo \"$f" << arrow << "B\")); "
              << "done";
-    
-    std::string bulk_output = RunShellCommand(bulk_cmd.str());
 
-    std::vector<std::string> ls_lines;
-    std::vector<std::string> symlink_info;
-    std::string current_path;
-    bool after_separator = false;
-
-    // Split lines once
-    std::istringstream output_stream(bulk_output);
-    std::string line;
-    while (std::getline(output_stream, line)) {
-        if (line.empty()) continue;
-        if (line == separator) { after_separator = true; continue; }
-
-        if (!after_separator) {
-            if (current_path.empty()) {
-                current_path = ExtractPathFromPwd(line);
-                _current_path = current_path;
-            } else {
-                ls_lines.push_back(line);
-            }
-        } else {
-            symlink_info.push_back(line);
-        }
+    std::string cached_path;
+    if (_dir_cache->Get(path, files, strings, cached_path)) {
+        ADBStats::Add(ADBStats::LISTING_CACHE_HITS);
+        // Shell stays where it was; RunShellCommandInCwd catches it up lazily.
+        _current_path = cached_path;
+        if (on_count) on_count(files.size());
+        return cached_path;
     }
+    ADBStats::Add(ADBStats::LISTING_CACHE_MISSES);
+    ADBStats::ScopedTimer timer(ADBStats::LISTING_US);
 
-    // Add hardcoded ".." entry
     files.clear();
-
-    // Parse ls -la lines
-    for (const auto& ls_line : ls_lines) {
-        if (ls_line.find("Permission denied") != std::string::npos || ls_line.find("total") == 0)
-            continue;
-        if (ls_line.size() > 0 && ls_line[0] == '?')
-            continue;
-
-        std::istringstream ls_stream(ls_line);
-        std::string perms, links, owner, group, size, date, time_str;
-        if (!(ls_stream >> perms >> links >> owner >> group >> size >> date >> time_str))
-            continue;
-
-        std::string rest;
-        std::getline(ls_stream, rest);
-        if (!rest.empty() && rest[0] == ' ') rest.erase(0, 1);
-
-        std::string filename = rest;
-        std::string symlink_target;
+    auto arena = std::make_shared<ADBItemStrings>();
+    std::string current_path;
+    bool after_separator = false;
+    // Only symlinks need the post-pass directory fixup — index just those, not every name. Their UTF-8 names are
+    // appended to one buffer while ls streams in; the index of views into it is built once the fixup lines start.
+    std::string symlink_names;
+    std::vector<std::pair<size_t, size_t>> symlink_spans;   // (offset into symlink_names, files index)
+    std::unordered_map<std::string_view, size_t> symlink_index;
+
+    // Progress callbacks are rate-limited; 40k-entry dirs would otherwise spam the UI thread.
+    constexpr size_t kCountReportEvery = 256;
+
+    auto parse_ls_line = [&](std::string_view ls_line) {
+        if (ls_line.find("Permission denied") != std::string_view::npos || ls_line.compare(0, 5, "total") == 0)
+            return;
+        if (ls_line[0] == '?')
+            return;
+
+        size_t pos = 0;
+        const std::string_view perms = NextField(ls_line, pos);
+        const std::string_view links = NextField(ls_line, pos);
+        const std::string_view owner = NextField(ls_line, pos);
+        const std::string_view group = NextField(ls_line, pos);
+        const std::string_view size = NextField(ls_line, pos);
+        const std::string_view date = NextField(ls_line, pos);
+        const std::string_view time_str = NextField(ls_line, pos);
+        if (time_str.empty())
+            return;
+
+        std::string_view rest = ls_line.substr(pos);
+        if (!rest.empty() && rest[0] == ' ') rest.remove_prefix(1);
+
+        std::string_view filename = rest;
+        std::string_view symlink_target;
         bool is_symlink = (perms[0] == 'l');
         if (is_symlink) {
-            auto pos = rest.find(" -> ");
-            if (pos != std::string::npos) {
-                filename = rest.substr(0, pos);
-                symlink_target = rest.substr(pos + 4);
+            auto arrow_pos = rest.find(" -> ");
+            if (arrow_pos != std::string_view::npos) {
+                filename = rest.substr(0, arrow_pos);
+                symlink_target = rest.substr(arrow_pos + 4);
             }
         }
 
-        if (filename.empty() || filename == "." || filename == "..") continue;
+        if (filename.empty() || filename == "." || filename == "..") return;
 
         PluginPanelItem item{};
-        item.FindData.lpwszFileName = AllocateItemString(filename);
+        item.FindData.lpwszFileName = arena->Add(filename);
         item.FindData.dwUnixMode = (perms[0] == 'd') ? (S_IFDIR | 0755) : (is_symlink ? (S_IFLNK | 0644) : (S_IFREG | 0644));
-        item.FindData.dwFileAttributes = WINPORT(EvaluateAttributesA)(item.FindData.dwUnixMode, filename.c_str());
+        item.FindData.dwFileAttributes = WINPORT(EvaluateAttributes)(item.FindData.dwUnixMode, item.FindData.lpwszFileName);
         if (perms[0] == 'd') item.FindData.dwFileAttributes |= FILE_ATTRIBUTE_DIRECTORY;
 
         if (is_symlink) {
-            item.Description = AllocateItemString(symlink_target.empty() ? "Symlink (no target)" : symlink_target);
+            item.Description = arena->Add(symlink_target.empty() ? std::string_view("Symlink (no target)") : symlink_target);
+            symlink_spans.emplace_back(symlink_names.size(), files.size());
+            symlink_names.append(filename.data(), filename.size());
+            symlink_names.push_back('\0');
         }
 
-        try { item.FindData.nFileSize = item.FindData.nPhysicalSize = std::stoull(size); } catch (...) { item.FindData.nFileSize = item.FindData.nPhysicalSize = 0; }
+        uint64_t file_size = 0;
+        ParseNumber(size, file_size);
+        item.FindData.nFileSize = item.FindData.nPhysicalSize = file_size;
 
-        item.Owner = AllocateItemString(owner);
-        item.Group = AllocateItemString(group);
-        
-        try { item.NumberOfLinks = std::stoi(links); } catch (...) { item.NumberOfLinks = 1; }
+        item.Owner = arena->Intern(owner);
+        item.Group = arena->Intern(group);
+
+        if (!ParseNumber(links, item.NumberOfLinks)) item.NumberOfLinks = 1;
 
         FILETIME ft{};
-        time_t t = ParseLsDateTime(date, time_str);
+        time_t t = ParseLsDateTime(std::string(date), std::string(time_str));
         if (!t) t = time(nullptr);
         ULARGE_INTEGER uli; uli.QuadPart = (t * 10000000ULL) + 116444736000000000ULL;
         ft.dwLowDateTime = uli.LowPart; ft.dwHighDateTime = uli.HighPart;
         item.FindData.ftCreationTime = item.FindData.ftLastAccessTime = item.FindData.ftLastWriteTime = ft;
 
         files.push_back(item);
-    }
+        if (on_count && (files.size() % kCountReportEvery) == 0) on_count(files.size());
+    };
 
-    // Map filenames for fast symlink update
-    std::unordered_map<std::string, PluginPanelItem*> file_map;
-    for (auto& f : files)
-        		if (f.FindData.lpwszFileName)
-			file_map[StrWide2MB(f.FindData.lpwszFileName)] = &f;
+    // Parse as lines arrive — no whole-response buffer, no second split pass.
+    auto on_line = [&](std::string_view line) {
+        if (line.empty()) return;
+        if (line == separator) {
+            after_separator = true;
+            // symlink_names is complete now, so views into it stay valid.
+            symlink_index.reserve(symlink_spans.size());
+            for (const auto& span : symlink_spans) {
+                symlink_index.emplace(std::string_view(symlink_names.c_str() + span.first), span.second);
+            }
+            return;
+        }
 
-    for (const auto& symlink_line : symlink_info) {
-        auto colon_pos = symlink_line.find(arrow);
-        if (colon_pos == std::string::npos) continue;
-        std::string filename = symlink_line.substr(0, colon_pos);
-        std::string type = symlink_line.substr(colon_pos + arrow.size());
+        if (!after_separator) {
+            if (current_path.empty()) {
+                current_path = ExtractPathFromPwd(std::string(line));
+                _current_path = current_path;
+            } else {
+                parse_ls_line(line);
+            }
+            return;
+        }
 
-        auto it = file_map.find(filename);
-        if (it != file_map.end()) {
-            PluginPanelItem* file = it->second;
-            if (type == "D") file->FindData.dwFileAttributes |= FILE_ATTRIBUTE_DIRECTORY;
-            // F and B need no action
+        auto colon_pos = line.rfind(arrow);
+        if (colon_pos == std::string_view::npos) return;
+        auto it = symlink_index.find(line.substr(0, colon_pos));
+        if (it != symlink_index.end() && line.substr(colon_pos + arrow.size()) == "D") {
+            files[it->second].FindData.dwFileAttributes |= FILE_ATTRIBUTE_DIRECTORY;
         }
+        // F and B need no action
+    };
+
+    const bool complete = _adb_shell->shellCommandLines(bulk_cmd.str(), on_line, abort_check);
+    if (!complete) {
+        DBG("DirectoryEnum '%s' incomplete (abort/timeout) after %zu entries\n", path.c_str(), files.size());
+        // Abort restarts the shell in its home dir.
+        _shell_cwd.clear();
+    } else if (!current_path.empty()) {
+        _shell_cwd = current_path;
+        _dir_cache->Put(path, current_path, files, arena);
     }
+    strings = std::move(arena);
+    if (on_count) on_count(files.size());
 
     return current_path.empty() ? path : current_path;
 }
@@ -588,15 +738,43 @@ bool ADBDevice::SetDirectory(const std::string &path) {
     
     // Update current path
     _current_path = new_path;
+    _shell_cwd = new_path;
     return true;
 }
 
 int ADBDevice::TransferItem(const std::string& src, const std::string& dst, bool is_push, bool recursive,
                            const AdbProgressFn& on_progress,
-                           const std::function<bool()>& abort_check)
+                           const std::function<bool()>& abort_check,
+                           const AdbWireFn& on_wire)
 {
     EnsureConnection();
     if (int err = ADBUtils::CheckConnection(_connected)) return err;
+    // Even a failed/aborted push may have left partial files behind.
+    if (is_push) InvalidateListing(dst);
+
+    if (auto sync = AcquireSync()) {
+        std::vector<std::string> empty_dirs;
+        if (on_progress) on_progress(0, std::string());
+        int rc = is_push
+            ? sync->push(src, dst, on_progress, abort_check, &empty_dirs, on_wire)
+            : sync->pull(src, dst, on_progress, abort_check, on_wire);
+        ReleaseSync(std::move(sync));
+        if (rc != ADBSocket::kUnavailable) {
+            // sync SEND can't express an empty directory; create them in one shell roundtrip.
+            if (rc == 0 && !empty_dirs.empty()) {
+                std::string command = "mkdir -p --";
+                for (const auto& d : empty_dirs) command += " " + ADBUtils::ShellQuote(d);
+                int exit_code = -1;
+                std::string out = RunPooledShellCommand(command + " 2>&1", &exit_code);
+                if (exit_code != 0) rc = out.empty() ? EIO : Str2Errno(out);
+            }
+            if (rc == 0 && on_progress) on_progress(100, std::string());
+            DBG("TransferItem via sync is_push=%d rc=%d src='%s' dst='%s'\n",
+                is_push, rc, src.c_str(), dst.c_str());
+            return rc;
+        }
+        DBG("TransferItem: sync client unavailable — falling back to adb binary\n");
+    }
 
     std::vector<std::string> args = {is_push ? "push" : "pull"};
     if (on_progress) args.push_back("-p");
@@ -606,13 +784,14 @@ int ADBDevice::TransferItem(const std::string& src, const std::string& dst, bool
     args.push_back(dst);
 
     std::string result;
+    int pty_exit = -1;
     if (on_progress) {
         ProgressParser parser(on_progress);
         parser.start();
-        result = RunAdbCommandWithProgress(args, std::ref(parser), abort_check);
+        result = RunAdbCommandWithProgress(args, std::ref(parser), abort_check, &pty_exit);
         parser.drain();
         // Exit code is the truth source — adb's stdout trailer can be truncated by path abbreviation.
-        if (ADBShell::lastPtyExit() == 0 || IsSuccessResult(result, is_push)) {
+        if (pty_exit == 0 || IsSuccessResult(result, is_push)) {
             parser.complete();
             return 0;
         }
@@ -625,7 +804,7 @@ int ADBDevice::TransferItem(const std::string& src, const std::string& dst, bool
     const size_t tail_len = std::min<size_t>(result.size(), 400);
     const char* tail = result.c_str() + (result.size() - tail_len);
     DBG("TransferItem FAIL is_push=%d pty_exit=%d errno=%d src='%s' dst='%s' tail[%zu]='%.*s'\n",
-        is_push, ADBShell::lastPtyExit(), errno_mapped, src.c_str(), dst.c_str(),
+        is_push, pty_exit, errno_mapped, src.c_str(), dst.c_str(),
         tail_len, (int)tail_len, tail);
     return errno_mapped;
 }
@@ -634,34 +813,102 @@ int ADBDevice::PullFile(const std::string &devicePath, const std::string &localP
     return TransferItem(devicePath, localPath, false, false);
 }
 
-int ADBDevice::PullFile(const std::string &devicePath, const std::string &localPath, const AdbProgressFn &on_progress, const std::function<bool()> &abort_check) {
-    return TransferItem(devicePath, localPath, false, false, on_progress, abort_check);
+int ADBDevice::PullFile(const std::string &devicePath, const std::string &localPath, const AdbProgressFn &on_progress, const std::function<bool()> &abort_check, const AdbWireFn &on_wire) {
+    return TransferItem(devicePath, localPath, false, false, on_progress, abort_check, on_wire);
 }
 
 int ADBDevice::PushFile(const std::string &localPath, const std::string &devicePath) {
     return TransferItem(localPath, devicePath, true, false);
 }
 
-int ADBDevice::PushFile(const std::string &localPath, const std::string &devicePath, const AdbProgressFn &on_progress, const std::function<bool()> &abort_check) {
-    return TransferItem(localPath, devicePath, true, false, on_progress, abort_check);
+int ADBDevice::PushFile(const std::string &localPath, const std::string &devicePath, const AdbProgressFn &on_progress, const std::function<bool()> &abort_check, const AdbWireFn &on_wire) {
+    return TransferItem(localPath, devicePath, true, false, on_progress, abort_check, on_wire);
 }
 
 int ADBDevice::PullDirectory(const std::string &devicePath, const std::string &localPath) {
     return TransferItem(devicePath, localPath, false, true);
 }
 
-int ADBDevice::PullDirectory(const std::string &devicePath, const std::string &localPath, const AdbProgressFn &on_progress, const std::function<bool()> &abort_check) {
-    return TransferItem(devicePath, localPath, false, true, on_progress, abort_check);
+int ADBDevice::PullDirectory(const std::string &devicePath, const std::string &localPath, const AdbProgressFn &on_progress, const std::function<bool()> &abort_check, const AdbWireFn &on_wire) {
+    return TransferItem(devicePath, localPath, false, true, on_progress, abort_check, on_wire);
 }
 
 int ADBDevice::PushDirectory(const std::string &localPath, const std::string &devicePath) {
     return TransferItem(localPath, devicePath, true, true);
 }
 
-int ADBDevice::PushDirectory(const std::string &localPath, const std::string &devicePath, const AdbProgressFn &on_progress, const std::function<bool()> &abort_check) {
+int ADBDevice::PushDirectory(const std::string &localPath, const std::string &devicePath, const AdbProgressFn &on_progress, const std::function<bool()> &abort_check, const AdbWireFn &on_wire) {
+    return TransferItem(localPath, devicePath, true, true, on_progress, abort_check, on_wire);
+}
+
+
+int ADBDevice::PullDirectoryBulk(const std::string &devicePath, const std::string &localPath, const AdbProgressFn &on_progress, const std::function<bool()> &abort_check) {
+    int rc = TransferTreeTar(devicePath, localPath, false, on_progress, abort_check);
+    if (rc != ADBSocket::kUnavailable) return rc;
+    return TransferItem(devicePath, localPath, false, true, on_progress, abort_check);
+}
+
+int ADBDevice::PushDirectoryBulk(const std::string &localPath, const std::string &devicePath, const AdbProgressFn &on_progress, const std::function<bool()> &abort_check) {
+    int rc = TransferTreeTar(localPath, devicePath, true, on_progress, abort_check);
+    if (rc != ADBSocket::kUnavailable) return rc;
     return TransferItem(localPath, devicePath, true, true, on_progress, abort_check);
 }
 
+int ADBDevice::TransferTreeTar(const std::string& src, const std::string& dst, bool is_push,
+                               const AdbProgressFn& on_progress, const std::function<bool()>& abort_check)
+{
+    EnsureConnection();
+    if (int err = ADBUtils::CheckConnection(_connected)) return err;
+    if (_bulk_tar == 0) return ADBSocket::kUnavailable;
+    auto sync = AcquireSync();
+    if (!sync) return ADBSocket::kUnavailable;
+
+    int exit_code = -1;
+    if (_bulk_tar < 0) {
+        // Probe once per device: a missing tar must be known before a stream is started (or a dir created).
+        const int rc = sync->exec("command -v tar >/dev/null", {}, {}, abort_check, exit_code);
+        if (rc == ECANCELED) { ReleaseSync(std::move(sync)); return rc; }
+        _bulk_tar = (rc == 0 && exit_code == 0) ? 1 : 0;
+        DBG("bulk tar on '%s': %d\n", _device_serial.c_str(), _bulk_tar.load());
+        if (_bulk_tar == 0) { ReleaseSync(std::move(sync)); return ADBSocket::kUnavailable; }
+    }
+
+    // Same target rule as the sync client and the adb binary: an existing directory receives the tree under its basename.
+    std::string target = dst;
+    std::string err;
+    int rc;
+    if (is_push) {
+        // Even a failed/aborted push may have left partial files behind.
+        InvalidateListing(dst);
+        ADBSocket::Entry st;
+        if (sync->statPath(dst, st) == 0 && S_ISDIR(st.mode)) {
+            target = ADBUtils::JoinPath(dst, ADBUtils::PathBasename(src));
+        }
+        TarBuilder tar(src, on_progress);
+        if (tar.Error()) { ReleaseSync(std::move(sync)); return tar.Error(); }
+        const std::string q = ADBUtils::ShellQuote(target);
+        rc = sync->exec("mkdir -p " + q + " && tar -xf - -C " + q,
+                        [&](char* buf, size_t len) { return tar.Read(buf, len); }, {},
+                        abort_check, exit_code, &err);
+    } else {
+        struct stat lst{};
+        if (::stat(dst.c_str(), &lst) == 0 && S_ISDIR(lst.st_mode)) {
+            target = ADBUtils::JoinPath(dst, ADBUtils::PathBasename(src));
+        }
+        TarExtractor tar(target, on_progress);
+        rc = sync->exec("tar -cf - -C " + ADBUtils::ShellQuote(src) + " .", {},
+                        [&](const char* data, size_t len) { return tar.Feed(data, len); },
+                        abort_check, exit_code, &err);
+        if (rc == 0) rc = tar.Finish();
+        // An empty tree has no entry that would have created the root.
+        if (rc == 0 && mkdir(target.c_str(), 0755) != 0 && errno != EEXIST) rc = errno;
+    }
+    ReleaseSync(std::move(sync));
+    if (rc == 0 && exit_code != 0) rc = err.empty() ? EIO : Str2Errno(err);
+    DBG("TransferTreeTar is_push=%d rc=%d exit=%d src='%s' dst='%s' err='%s'\n",
+        is_push, rc, exit_code, src.c_str(), target.c_str(), err.c_str());
+    return rc;
+}
 
 
 // Exit-code-first errno mapping: `result.empty()` alone confused warnings-on-success with real errors; the marker-protocol exit code is authoritative.
@@ -676,8 +923,10 @@ int ADBDevice::DeleteFile(const std::string &devicePath) {
     if (int err = ADBUtils::CheckConnection(_connected)) return err;
 
     std::string command = "rm -- " + ADBUtils::ShellQuote(devicePath);
-    std::string result = RunShellCommand(command);
-    return MutationResultToErrno(LastShellExitCode(), result);
+    int exit_code = -1;
+    std::string result = RunPooledShellCommand(command, &exit_code);
+    InvalidateListing(devicePath);
+    return MutationResultToErrno(exit_code, result);
 }
 
 int ADBDevice::DeleteDirectory(const std::string &devicePath) {
@@ -685,8 +934,10 @@ int ADBDevice::DeleteDirectory(const std::string &devicePath) {
     if (int err = ADBUtils::CheckConnection(_connected)) return err;
 
     std::string command = "rm -rf -- " + ADBUtils::ShellQuote(devicePath);
-    std::string result = RunShellCommand(command);
-    return MutationResultToErrno(LastShellExitCode(), result);
+    int exit_code = -1;
+    std::string result = RunPooledShellCommand(command, &exit_code);
+    InvalidateListing(devicePath);
+    return MutationResultToErrno(exit_code, result);
 }
 
 int ADBDevice::CreateDirectory(const std::string &devicePath) {
@@ -694,8 +945,10 @@ int ADBDevice::CreateDirectory(const std::string &devicePath) {
     if (int err = ADBUtils::CheckConnection(_connected)) return err;
 
     std::string command = "mkdir -p -- " + ADBUtils::ShellQuote(devicePath);
-    std::string result = RunShellCommand(command);
-    return MutationResultToErrno(LastShellExitCode(), result);
+    int exit_code = -1;
+    std::string result = RunShellCommand(command, &exit_code);
+    InvalidateListing(devicePath, true);
+    return MutationResultToErrno(exit_code, result);
 }
 
 int ADBDevice::CopyRemote(const std::string &srcDevicePath, const std::string &dstDeviceDir) {
@@ -706,8 +959,10 @@ int ADBDevice::CopyRemote(const std::string &srcDevicePath, const std::string &d
     std::string command =
         "cp -a -- " + ADBUtils::ShellQuote(srcDevicePath) + " " + ADBUtils::ShellQuote(dstDeviceDir) +
         " 2>/dev/null || cp -Rp -- " + ADBUtils::ShellQuote(srcDevicePath) + " " + ADBUtils::ShellQuote(dstDeviceDir);
-    std::string result = RunShellCommand(command);
-    return MutationResultToErrno(LastShellExitCode(), result);
+    int exit_code = -1;
+    std::string result = RunPooledShellCommand(command, &exit_code);
+    InvalidateListing(ADBUtils::JoinPath(dstDeviceDir, ADBUtils::PathBasename(srcDevicePath)));
+    return MutationResultToErrno(exit_code, result);
 }
 
 int ADBDevice::MoveRemote(const std::string &srcDevicePath, const std::string &dstDeviceDir) {
@@ -715,8 +970,11 @@ int ADBDevice::MoveRemote(const std::string &srcDevicePath, const std::string &d
     if (int err = ADBUtils::CheckConnection(_connected)) return err;
 
     std::string command = "mv -- " + ADBUtils::ShellQuote(srcDevicePath) + " " + ADBUtils::ShellQuote(dstDeviceDir);
-    std::string result = RunShellCommand(command);
-    return MutationResultToErrno(LastShellExitCode(), result);
+    int exit_code = -1;
+    std::string result = RunPooledShellCommand(command, &exit_code);
+    InvalidateListing(srcDevicePath);
+    InvalidateListing(ADBUtils::JoinPath(dstDeviceDir, ADBUtils::PathBasename(srcDevicePath)));
+    return MutationResultToErrno(exit_code, result);
 }
 
 int ADBDevice::CopyRemoteAs(const std::string &srcDevicePath, const std::string &dstDevicePath) {
@@ -727,8 +985,10 @@ int ADBDevice::CopyRemoteAs(const std::string &srcDevicePath, const std::string
     std::string command =
         "cp -a -- " + ADBUtils::ShellQuote(srcDevicePath) + " " + ADBUtils::ShellQuote(dstDevicePath) +
         " 2>/dev/null || cp -Rp -- " + ADBUtils::ShellQuote(srcDevicePath) + " " + ADBUtils::ShellQuote(dstDevicePath);
-    std::string result = RunShellCommand(command);
-    return MutationResultToErrno(LastShellExitCode(), result);
+    int exit_code = -1;
+    std::string result = RunPooledShellCommand(command, &exit_code);
+    InvalidateListing(dstDevicePath);
+    return MutationResultToErrno(exit_code, result);
 }
 
 int ADBDevice::MoveRemoteAs(const std::string &srcDevicePath, const std::string &dstDevicePath) {
@@ -736,8 +996,11 @@ int ADBDevice::MoveRemoteAs(const std::string &srcDevicePath, const std::string
     if (int err = ADBUtils::CheckConnection(_connected)) return err;
 
     std::string command = "mv -- " + ADBUtils::ShellQuote(srcDevicePath) + " " + ADBUtils::ShellQuote(dstDevicePath);
-    std::string result = RunShellCommand(command);
-    return MutationResultToErrno(LastShellExitCode(), result);
+    int exit_code = -1;
+    std::string result = RunPooledShellCommand(command, &exit_code);
+    InvalidateListing(srcDevicePath);
+    InvalidateListing(dstDevicePath);
+    return MutationResultToErrno(exit_code, result);
 }
 
 int ADBDevice::CopyRemoteAs(const std::string &srcDevicePath, const std::string &dstDevicePath,
@@ -749,6 +1012,7 @@ int ADBDevice::CopyRemoteAs(const std::string &srcDevicePath, const std::string
         "cp -a -- " + ADBUtils::ShellQuote(srcDevicePath) + " " + ADBUtils::ShellQuote(dstDevicePath) +
         " 2>/dev/null || cp -Rp -- " + ADBUtils::ShellQuote(srcDevicePath) + " " + ADBUtils::ShellQuote(dstDevicePath);
     RunAdbCommandWithProgress({"shell", sh}, [](const std::string&){}, abort_check);
+    InvalidateListing(dstDevicePath);
     if (abort_check()) return ECANCELED;
     return 0;
 }
@@ -759,6 +1023,8 @@ int ADBDevice::MoveRemoteAs(const std::string &srcDevicePath, const std::string
     if (int err = ADBUtils::CheckConnection(_connected)) return err;
     std::string sh = "mv -- " + ADBUtils::ShellQuote(srcDevicePath) + " " + ADBUtils::ShellQuote(dstDevicePath);
     RunAdbCommandWithProgress({"shell", sh}, [](const std::string&){}, abort_check);
+    InvalidateListing(srcDevicePath);
+    InvalidateListing(dstDevicePath);
     if (abort_check()) return ECANCELED;
     return 0;
 }
@@ -771,6 +1037,7 @@ int ADBDevice::CopyRemote(const std::string &srcDevicePath, const std::string &d
         "cp -a -- " + ADBUtils::ShellQuote(srcDevicePath) + " " + ADBUtils::ShellQuote(dstDeviceDir) +
         " 2>/dev/null || cp -Rp -- " + ADBUtils::ShellQuote(srcDevicePath) + " " + ADBUtils::ShellQuote(dstDeviceDir);
     RunAdbCommandWithProgress({"shell", sh}, [](const std::string&){}, abort_check);
+    InvalidateListing(ADBUtils::JoinPath(dstDeviceDir, ADBUtils::PathBasename(srcDevicePath)));
     if (abort_check()) return ECANCELED;
     return 0;
 }
@@ -781,10 +1048,30 @@ int ADBDevice::MoveRemote(const std::string &srcDevicePath, const std::string &d
     if (int err = ADBUtils::CheckConnection(_connected)) return err;
     std::string sh = "mv -- " + ADBUtils::ShellQuote(srcDevicePath) + " " + ADBUtils::ShellQuote(dstDeviceDir);
     RunAdbCommandWithProgress({"shell", sh}, [](const std::string&){}, abort_check);
+    InvalidateListing(srcDevicePath);
+    InvalidateListing(ADBUtils::JoinPath(dstDeviceDir, ADBUtils::PathBasename(srcDevicePath)));
     if (abort_check()) return ECANCELED;
     return 0;
 }
 
+void ADBDevice::InvalidateListing(const std::string &devicePath, bool with_ancestors) {
+    // Relative paths resolve against the shell cwd, which is what _current_path tracks.
+    const std::string path = devicePath.empty() || devicePath[0] == '/'
+                           ? devicePath : ADBUtils::JoinPath(_current_path, devicePath);
+    _dir_cache->Invalidate(path, with_ancestors);
+    _dir_totals->Invalidate(path);
+}
+
+void ADBDevice::InvalidateAllListings() {
+    _dir_cache->Clear();
+    _dir_totals->Clear();
+}
+
+void ADBDevice::RefreshListing(const std::string &devicePath) {
+    _dir_cache->Remove(devicePath);
+    _dir_totals->Invalidate(devicePath);
+}
+
 bool ADBDevice::FileExists(const std::string &devicePath) {
     EnsureConnection();
     if (!_connected) return false;
@@ -801,6 +1088,108 @@ bool ADBDevice::FileExists(const std::string &devicePath) {
     return result == "1";
 }
 
+std::shared_future<bool> ADBDevice::FileExistsAsync(const std::string &devicePath) {
+    EnsureConnection();
+    auto reply = _adb_shell->shellCommandAsync("test -e " + ADBUtils::ShellQuote(devicePath));
+    return std::async(std::launch::deferred, [reply]() { return reply.get().exit_code == 0; }).share();
+}
+
+bool ADBDevice::StatRemote(const std::string &devicePath, bool &exists, uint64_t &size, time_t &mtime) {
+    exists = false; size = 0; mtime = 0;
+    auto sync = AcquireSync();
+    if (!sync) return false;
+    ADBSocket::Entry st;
+    int rc = sync->statPath(devicePath, st);
+    ReleaseSync(std::move(sync));
+    if (rc == ADBSocket::kUnavailable) return false;
+    if (rc == 0) {
+        exists = true;
+        size = S_ISDIR(st.mode) ? 0 : st.size;
+        mtime = (time_t)st.mtime;
+    }
+    return true;
+}
+
+namespace {
+
+// Quoted-path bytes per StatMany command; keeps each line well under the device shell's limits.
+constexpr size_t kStatManyChunkBytes = 64 * 1024;
+
+// "<hex mode> <size> <mtime>" prefix of a `stat -c '%f %s %Y ...'` line; rest points past it.
+bool ParseStatLine(std::string_view line, RemoteStat &st, std::string_view &rest) {
+    char buf[80];
+    const size_t head = std::min(line.size(), sizeof(buf) - 1);
+    memcpy(buf, line.data(), head);
+    buf[head] = 0;
+    char *p = buf, *end = nullptr;
+    const unsigned long mode = strtoul(p, &end, 16);
+    if (end == p || *end != ' ') return false;
+    p = end + 1;
+    const unsigned long long size = strtoull(p, &end, 10);
+    if (end == p || *end != ' ') return false;
+    p = end + 1;
+    const long long mtime = strtoll(p, &end, 10);
+    if (end == p || (*end != ' ' && *end != 0)) return false;
+    rest = line.substr(std::min(line.size(), (size_t)(end - buf) + (*end ? 1 : 0)));
+    st.exists = true;
+    st.mode = (uint32_t)mode;
+    st.is_dir = S_ISDIR(st.mode);
+    st.size = st.is_dir ? 0 : (uint64_t)size;
+    st.mtime = (time_t)mtime;
+    return true;
+}
+
+} // namespace
+
+bool ADBDevice::StatMany(const std::vector<std::string> &devicePaths, std::vector<RemoteStat> &out) {
+    out.assign(devicePaths.size(), RemoteStat());
+    EnsureConnection();
+    if (!_connected) return false;
+
+    // stat prints existing operands in argument order and skips missing ones (stderr), so %n re-aligns output with
+    // input. A name containing '\n' would split its line — those few get a command of their own instead.
+    size_t i = 0;
+    while (i < devicePaths.size()) {
+        if (devicePaths[i].find('\n') != std::string::npos) {
+            int exit_code = -1;
+            std::string result = RunShellCommand("stat -L -c '%f %s %Y' -- "
+                + ADBUtils::ShellQuote(devicePaths[i]) + " 2>/dev/null", &exit_code);
+            if (exit_code < 0) return false;
+            ADBUtils::TrimTrailingNewlines(result);
+            std::string_view rest;
+            if (!result.empty()) ParseStatLine(result, out[i], rest);
+            ++i;
+            continue;
+        }
+        const size_t first = i;
+        std::string command = "stat -L -c '%f %s %Y %n' --";
+        while (i < devicePaths.size() && devicePaths[i].find('\n') == std::string::npos
+               && (i == first || command.size() < kStatManyChunkBytes)) {
+            command += ' ';
+            command += ADBUtils::ShellQuote(devicePaths[i]);
+            ++i;
+        }
+        command += " 2>/dev/null";
+
+        size_t next = first;
+        bool misaligned = false;
+        const bool ok = _adb_shell->shellCommandLines(command, [&](std::string_view line) {
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            RemoteStat st;
+            std::string_view name;
+            if (misaligned || !ParseStatLine(line, st, name)) { misaligned = true; return; }
+            while (next < i && devicePaths[next] != name) ++next;
+            if (next == i) { misaligned = true; return; }
+            out[next++] = st;
+        });
+        if (!ok || misaligned) {
+            DBG("StatMany: batch [%zu,%zu) failed ok=%d misaligned=%d\n", first, i, ok, misaligned);
+            return false;
+        }
+    }
+    return true;
+}
+
 bool ADBDevice::IsDirectory(const std::string &devicePath) {
     EnsureConnection();
     if (!_connected) return false;
@@ -816,59 +1205,163 @@ void ADBDevice::ListDirNames(const std::string &devicePath, std::unordered_set<s
     if (!_connected) return;
     // -A includes dotfiles, -1 one-per-line; ignore stderr (missing dir → empty set).
     std::string command = "ls -A1 -- " + ADBUtils::ShellQuote(devicePath) + " 2>/dev/null";
-    std::string result = RunShellCommand(command);
-    size_t pos = 0;
-    while (pos < result.size()) {
-        size_t eol = result.find('\n', pos);
-        std::string line = result.substr(pos, eol == std::string::npos ? std::string::npos : eol - pos);
-        pos = (eol == std::string::npos) ? result.size() : eol + 1;
-        while (!line.empty() && line.back() == '\r') line.pop_back();
-        if (!line.empty()) out.insert(std::move(line));
-    }
+    _adb_shell->shellCommandLines(command, [&](std::string_view line) {
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (!line.empty()) out.emplace(line);
+    });
 }
 
 void ADBDevice::BatchDirectoryFileSizes(const std::vector<std::string>& devicePaths,
-                                         std::map<std::string, std::unordered_map<std::string, uint64_t>>& out) {
+                                         std::map<std::string, std::unordered_map<std::string, uint64_t>>& out,
+                                         const std::function<bool()>& abort_check) {
+    std::map<std::string, FileManifest> manifests;
+    std::vector<std::string> misses;
+    for (const auto& p : devicePaths) {
+        if (abort_check && abort_check()) return;
+        if (!_dir_totals->Get(p, manifests[p], abort_check)) misses.push_back(p);
+    }
+    if (!misses.empty()) {
+        if (BatchDirectoryManifests(misses, manifests, abort_check)) {
+            for (const auto& p : misses) _dir_totals->Put(p, manifests[p]);
+        } else {
+            for (const auto& p : misses) manifests.erase(p);
+        }
+    }
+    for (auto& kv : manifests) {
+        auto& sizes = out[kv.first];
+        for (const auto& f : kv.second) sizes.emplace(f.first, f.second.size);
+    }
+}
+
+bool ADBDevice::BatchDirectoryManifests(const std::vector<std::string>& devicePaths,
+                                        std::map<std::string, FileManifest>& out,
+                                        const std::function<bool()>& abort_check, bool* complete) {
+    if (complete) *complete = false;
     EnsureConnection();
+    if (!_connected || devicePaths.empty()) return false;
+    auto shell = ADBShellPool::Acquire(_shell_pool);
+    return ShellDirectoryManifests(shell ? *shell : *_adb_shell, devicePaths, out, abort_check, complete);
+}
+
+void ADBDevice::PrefetchDirectoryTotals(const std::vector<std::string>& devicePaths) {
     if (!_connected || devicePaths.empty()) return;
+    _dir_totals->Prefetch(devicePaths);
+}
+
+bool ADBDevice::ShellDirectoryManifests(ADBShell& shell, const std::vector<std::string>& devicePaths,
+                                        std::map<std::string, FileManifest>& out,
+                                        const std::function<bool()>& abort_check, bool* complete) {
+    if (complete) *complete = false;
+    if (devicePaths.empty()) return false;
 
     // Pre-create entries so empty top-level dirs (no files via -type f) still produce an entry.
     for (const auto& p : devicePaths) out[p];
 
     // Single `find` over all roots — one shell roundtrip; %p (full path) lets us prefix-match each file back to its root.
+    // Trailing '/' makes find descend through a symlinked root instead of reporting the link itself.
     std::string command = "find";
-    for (const auto& p : devicePaths) command += " " + ADBUtils::ShellQuote(p);
-    command += " -type f -printf '%s\\t%p\\n' 2>/dev/null";
-    std::string result = RunShellCommand(command);
-
+    for (const auto& p : devicePaths) {
+        command += " " + ADBUtils::ShellQuote((!p.empty() && p.back() == '/') ? p : p + "/");
+    }
+    command += " -type f -printf '%s\\t%T@\\t%p\\n' 2>/dev/null";
     // Longest-prefix first — handles the case where one input dir is nested inside another.
     std::vector<std::string> sorted = devicePaths;
     std::sort(sorted.begin(), sorted.end(),
               [](const std::string& a, const std::string& b) { return a.size() > b.size(); });
 
-    size_t pos = 0;
-    while (pos < result.size()) {
-        size_t eol = result.find('\n', pos);
-        std::string line = result.substr(pos, eol == std::string::npos ? std::string::npos : eol - pos);
-        pos = (eol == std::string::npos) ? result.size() : eol + 1;
-        if (line.empty()) continue;
-        size_t tab = line.find('\t');
-        if (tab == std::string::npos) continue;
-        const std::string size_str = line.substr(0, tab);
-        std::string full_path = line.substr(tab + 1);
-        while (!full_path.empty() && full_path.back() == '\r') full_path.pop_back();
-        if (size_str.empty() || full_path.empty()) continue;
+    int exit_code = -1;
+    const bool ok = shell.shellCommandLines(command, [&](std::string_view line) {
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        size_t tab1 = line.find('\t');
+        size_t tab2 = (tab1 == std::string_view::npos) ? tab1 : line.find('\t', tab1 + 1);
+        if (tab1 == 0 || tab2 == std::string_view::npos) return;
+        const std::string_view full_path = line.substr(tab2 + 1);
+        if (full_path.empty()) return;
 
         for (const auto& dir : sorted) {
-            if (full_path.size() > dir.size() + 1
-                && full_path.compare(0, dir.size(), dir) == 0
-                && full_path[dir.size()] == '/') {
-                out[dir][full_path.substr(dir.size() + 1)] =
-                    strtoull(size_str.c_str(), nullptr, 10);
-                break;
-            }
+            if (full_path.compare(0, dir.size(), dir) != 0) continue;
+            // find may echo the root's trailing '/' back as "root//name".
+            size_t rel = dir.size();
+            while (rel < full_path.size() && full_path[rel] == '/') ++rel;
+            if ((rel == dir.size() && dir.back() != '/') || rel == full_path.size()) continue;
+            ManifestEntry& e = out[dir][std::string(full_path.substr(rel))];
+            // Fields end at '\t', which stops strtoull/strtoll; %T@ is "seconds.fraction" and the fraction is
+            // below what either side's mtime comparison looks at.
+            e.size = strtoull(line.data(), nullptr, 10);
+            e.mtime = (time_t)strtoll(line.data() + tab1 + 1, nullptr, 10);
+            break;
         }
+    }, abort_check, &exit_code);
+    // stderr is dropped, so find's status is the only sign that some folder was skipped.
+    if (complete) *complete = ok && exit_code == 0;
+    if (ok && exit_code != 0) DBG("manifest find exited %d — listing incomplete\n", exit_code);
+    return ok;
+}
+
+bool ADBDevice::FindFiles(const FindQuery& query, const std::function<void(const FindMatch&)>& on_match,
+                          const std::function<bool()>& abort_check) {
+    EnsureConnection();
+    if (!_connected || query.root.empty()) return false;
+
+    // Trailing '/' descends through a symlinked root (/sdcard); -mindepth 1 keeps the root itself out of the results.
+    const bool from_fs_root = (query.root == "/");
+    std::string command = "find " + ADBUtils::ShellQuote(from_fs_root || query.root.back() == '/' ? query.root : query.root + "/")
+        + " -mindepth 1";
+    // Searching from / would otherwise crawl procfs/sysfs — slow, huge and never what the user is after.
+    if (from_fs_root) command += " \\( -path /proc -o -path /sys -o -path /dev -o -path /acct \\) -prune -o";
+
+    std::string names;
+    for (const auto& m : query.masks) {
+        if (m.empty()) continue;
+        if (m == "*" || m == "*.*") { names.clear(); break; }
+        names += names.empty() ? " \\(" : " -o";
+        names += (query.case_sensitive ? " -name " : " -iname ") + ADBUtils::ShellQuote(m);
+    }
+    if (!names.empty()) command += names + " \\)";
+    // Size limits and content search only make sense for files; folder sizes are just block counts.
+    const bool content = !query.text.empty();
+    if (content || query.min_size || query.max_size) command += " -type f";
+    if (query.min_size) command += " -size +" + std::to_string(query.min_size - 1) + "c";
+    if (query.max_size) command += " -size -" + std::to_string(query.max_size + 1) + "c";
+    if (query.modified_days) command += " -mtime -" + std::to_string(query.modified_days);
+    if (content) {
+        // One grep per batch of names (-exec +), not per file; grep -l prints each matching name once.
+        command += std::string(" -exec grep -l -s -F") + (query.case_sensitive ? "" : " -i")
+            + " -e " + ADBUtils::ShellQuote(query.text) + " -- {} +";
+    } else {
+        command += " \\( -type d -printf 'd\\t%s\\t%T@\\t%p\\n' -o -printf 'f\\t%s\\t%T@\\t%p\\n' \\)";
     }
+    command += " 2>/dev/null";
+    DBG("FindFiles: %s\n", command.c_str());
+
+    auto deliver = [&](std::string_view path, FindMatch& m) {
+        // find echoes the root's trailing '/' back as "root//name".
+        m.path.clear();
+        for (char c : path) {
+            if (c == '/' && !m.path.empty() && m.path.back() == '/') continue;
+            m.path += c;
+        }
+        if (!m.path.empty()) on_match(m);
+    };
+    auto on_line = [&](std::string_view line) {
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        FindMatch m;
+        if (content) {
+            // A name with '\n' in it splits into pieces that don't look like paths; those are dropped.
+            if (!line.empty() && line[0] == '/') deliver(line, m);
+            return;
+        }
+        if (line.size() < 2 || (line[0] != 'd' && line[0] != 'f') || line[1] != '\t') return;
+        const size_t tab2 = line.find('\t', 2);
+        const size_t tab3 = (tab2 == std::string_view::npos) ? tab2 : line.find('\t', tab2 + 1);
+        if (tab3 == std::string_view::npos) return;
+        m.is_dir = (line[0] == 'd');
+        m.size = m.is_dir ? 0 : strtoull(std::string(line.substr(2, tab2 - 2)).c_str(), nullptr, 10);
+        m.mtime = (time_t)strtoll(std::string(line.substr(tab2 + 1, tab3 - tab2 - 1)).c_str(), nullptr, 10);
+        deliver(line.substr(tab3 + 1), m);
+    };
+
+    return RunPooledShellLines(command, on_line, abort_check);
 }
 
 int ADBDevice::Str2Errno(const std::string &adbError) {
@@ -2,13 +2,17 @@
 
 // Standard library includes
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <time.h>
 #include <functional>
+#include <future>
+#include <atomic>
 
 // System includes
 #include <sys/stat.h>
@@ -18,10 +22,52 @@
 
 // Forward declarations
 class ADBShell;
+class ADBSocket;
+class ADBDirCache;
+class ADBDirTotals;
+class ADBItemStrings;
+class ADBShellPool;
 struct PluginPanelItem;
 
 // Per-file progress callback. percent 0-100; path is adb's reported path (empty on synthetic 0%/100%).
 using AdbProgressFn = std::function<void(int, const std::string&)>;
+// Compressed sync only: (payload bytes, bytes on the wire) per packet — for the progress dialog's ratio.
+using AdbWireFn = std::function<void(uint64_t, uint64_t)>;
+
+// One StatMany() result (symlinks followed, like `test -e`). mode is the raw st_mode; 0 when missing.
+struct RemoteStat {
+    bool exists = false;
+    bool is_dir = false;
+    uint32_t mode = 0;
+    uint64_t size = 0;
+    time_t mtime = 0;
+};
+
+// One file of a BatchDirectoryManifests() tree; mtime 0 when the device's find can't print it.
+struct ManifestEntry {
+    uint64_t size = 0;
+    time_t mtime = 0;
+};
+using FileManifest = std::unordered_map<std::string, ManifestEntry>;
+
+// Alt+F7 search criteria, evaluated by the device's own `find`/`grep`. Empty masks = everything; 0 = no limit.
+struct FindQuery {
+    std::string root;
+    std::vector<std::string> masks;   // shell globs, OR-ed
+    std::string text;                 // fixed string; non-empty limits the search to files containing it
+    bool case_sensitive = false;
+    uint64_t min_size = 0;            // bytes
+    uint64_t max_size = 0;
+    unsigned modified_days = 0;       // modified within the last N days
+};
+
+// One FindFiles() hit; size/mtime are 0 for content matches (grep -l reports names only).
+struct FindMatch {
+    std::string path;
+    bool is_dir = false;
+    uint64_t size = 0;
+    time_t mtime = 0;
+};
 
 // ADB Device implementation
 class ADBDevice {
@@ -29,7 +75,25 @@ private:
     std::string _device_serial;
     std::string _current_path;
     std::unique_ptr<ADBShell> _adb_shell;
+    // Directory the shell session last `cd`-ed to; differs from _current_path after a cached listing.
+    std::string _shell_cwd;
+    // Listing cache shared with every ADBDevice on the same serial.
+    std::shared_ptr<ADBDirCache> _dir_cache;
+    // Background-fetched folder manifests for transfer totals, shared with every ADBDevice on the same serial.
+    std::shared_ptr<ADBDirTotals> _dir_totals;
+    // Extra warm shells for slow stateless commands, shared with every ADBDevice on the same serial.
+    std::shared_ptr<ADBShellPool> _shell_pool;
+    // Native sync client (default transport for transfers/stat); adb binary is the fallback.
+    // Idle sessions are pooled so parallel transfer lanes each get their own socket instead of queueing on one.
+    std::vector<std::unique_ptr<ADBSocket>> _sync_idle;
+    std::mutex _sync_mutex;
+    bool _sync_enabled;
     bool _connected;
+    // Device has shell_v2 + tar for bulk tree transfers: -1 not probed yet, 0 no, 1 yes.
+    std::atomic<int> _bulk_tar{-1};
+
+    std::unique_ptr<ADBSocket> AcquireSync();
+    void ReleaseSync(std::unique_ptr<ADBSocket> sock);
 
     void EnsureConnection();
     std::string ExtractPathFromPwd(const std::string &pwd_output);
@@ -46,34 +110,66 @@ private:
     // Unified transfer helper (DRY)
     int TransferItem(const std::string& src, const std::string& dst, bool is_push, bool recursive,
                     const AdbProgressFn& on_progress = {},
-                    const std::function<bool()>& abort_check = {});
+                    const std::function<bool()>& abort_check = {},
+                    const AdbWireFn& on_wire = {});
+    // Whole tree as one tar stream over shell v2; ADBSocket::kUnavailable (nothing touched) when the device can't.
+    int TransferTreeTar(const std::string& src, const std::string& dst, bool is_push,
+                        const AdbProgressFn& on_progress, const std::function<bool()>& abort_check);
 
 public:
     // Public methods for command execution
     std::string RunAdbCommand(const std::string &command);
     std::string RunAdbCommand(const std::vector<std::string> &args);
     std::string RunAdbCommand(const std::vector<std::string> &args, const std::function<void(const std::string&)> &on_chunk);
-    std::string RunAdbCommandWithProgress(const std::vector<std::string> &args, const std::function<void(const std::string&)> &on_chunk, const std::function<bool()> &abort_check = {});
-    std::string RunShellCommand(const std::string &command);
-    // Exit code of the most recent RunShellCommand(); -1 if unavailable.
-    int LastShellExitCode() const;
+    std::string RunAdbCommandWithProgress(const std::vector<std::string> &args, const std::function<void(const std::string&)> &on_chunk, const std::function<bool()> &abort_check = {}, int *exit_status = nullptr);
+    // Shell commands report the command's exit code through exit_code (-1 if unavailable): sessions are shared
+    // between threads, so a "last exit code" read afterwards could belong to someone else's command.
+    std::string RunShellCommand(const std::string &command, int *exit_code = nullptr);
+    // RunShellCommand from the panel's directory (user command line — relative paths must resolve there).
+    std::string RunShellCommandInCwd(const std::string &command, int *exit_code = nullptr);
+    // Line-streamed RunShellCommandInCwd on the primary session (a `cd` in the command sticks). false on timeout or
+    // abort — the session is then restarted and re-enters the panel's directory on the next command.
+    bool RunShellLinesInCwd(const std::string &command, const std::function<void(std::string_view)> &on_line,
+                            const std::function<bool()> &abort_check = {}, int *exit_code = nullptr);
+    // RunShellCommand on a leased pool session (relative paths still resolve against the panel's directory);
+    // for slow rm/cp/mv/find so they neither wait for nor hold up the primary session used for browsing.
+    std::string RunPooledShellCommand(const std::string &command, int *exit_code = nullptr);
+    // Line-streamed RunPooledShellCommand (ADBShell::shellCommandLines): each line is a view into the receive buffer,
+    // so big find/ls outputs are parsed without being collected first. No `cd` — absolute paths only.
+    bool RunPooledShellLines(const std::string &command, const std::function<void(std::string_view)> &on_line,
+                             const std::function<bool()> &abort_check = {}, int *exit_code = nullptr);
     std::string GetCurrentWorkingDirectory();
     ADBDevice(const std::string &device_serial);
     virtual ~ADBDevice();
 
     // File operations
-    std::string DirectoryEnum(const std::string &path, std::vector<PluginPanelItem> &files);
+    // Streams `ls -la` as it arrives; on_count(n) reports entries parsed so far, abort_check stops early with a partial list.
+    // The items' strings live in `strings` (never free() them) — keep it alive for as long as the items are used.
+    std::string DirectoryEnum(const std::string &path, std::vector<PluginPanelItem> &files,
+                              std::shared_ptr<const ADBItemStrings> &strings,
+                              const std::function<void(size_t)> &on_count = {},
+                              const std::function<bool()> &abort_check = {});
     bool SetDirectory(const std::string &path);
 
+    // Listing cache maintenance: mutators call InvalidateListing themselves; plugin-side raw shell edits must too.
+    void InvalidateListing(const std::string &devicePath, bool with_ancestors = false);
+    void InvalidateAllListings();
+    // Ctrl+R: re-read this directory from the device next time.
+    void RefreshListing(const std::string &devicePath);
+
     // File transfer operations
     int PullFile(const std::string &devicePath, const std::string &localPath);
-    int PullFile(const std::string &devicePath, const std::string &localPath, const AdbProgressFn &on_progress, const std::function<bool()> &abort_check = {});
+    int PullFile(const std::string &devicePath, const std::string &localPath, const AdbProgressFn &on_progress, const std::function<bool()> &abort_check = {}, const AdbWireFn &on_wire = {});
     int PushFile(const std::string &localPath, const std::string &devicePath);
-    int PushFile(const std::string &localPath, const std::string &devicePath, const AdbProgressFn &on_progress, const std::function<bool()> &abort_check = {});
+    int PushFile(const std::string &localPath, const std::string &devicePath, const AdbProgressFn &on_progress, const std::function<bool()> &abort_check = {}, const AdbWireFn &on_wire = {});
     int PullDirectory(const std::string &devicePath, const std::string &localPath);
-    int PullDirectory(const std::string &devicePath, const std::string &localPath, const AdbProgressFn &on_progress, const std::function<bool()> &abort_check = {});
+    int PullDirectory(const std::string &devicePath, const std::string &localPath, const AdbProgressFn &on_progress, const std::function<bool()> &abort_check = {}, const AdbWireFn &on_wire = {});
     int PushDirectory(const std::string &localPath, const std::string &devicePath);
-    int PushDirectory(const std::string &localPath, const std::string &devicePath, const AdbProgressFn &on_progress, const std::function<bool()> &abort_check = {});
+    int PushDirectory(const std::string &localPath, const std::string &devicePath, const AdbProgressFn &on_progress, const std::function<bool()> &abort_check = {}, const AdbWireFn &on_wire = {});
+    // Bulk variants for trees of many small files: `tar -c | tar -x` over one stream instead of a sync request per file.
+    // Same target rules and per-file progress; fall back to PullDirectory/PushDirectory when the device has no tar/shell_v2.
+    int PullDirectoryBulk(const std::string &devicePath, const std::string &localPath, const AdbProgressFn &on_progress, const std::function<bool()> &abort_check = {});
+    int PushDirectoryBulk(const std::string &localPath, const std::string &devicePath, const AdbProgressFn &on_progress, const std::function<bool()> &abort_check = {});
 
     // File deletion operations
     int DeleteFile(const std::string &devicePath);
@@ -98,13 +194,39 @@ public:
 
     // File existence check
     bool FileExists(const std::string &devicePath);
+    // Pipelined FileExists: many can be queued before the first result is needed (one write burst, no per-probe roundtrip wait).
+    std::shared_future<bool> FileExistsAsync(const std::string &devicePath);
     bool IsDirectory(const std::string &devicePath);
+    // sync STAT over the native client; false if it is unavailable (caller falls back to the shell). exists=false on ENOENT.
+    bool StatRemote(const std::string &devicePath, bool &exists, uint64_t &size, time_t &mtime);
+    // Existence/type/size/mtime/mode for a whole batch in one shell roundtrip (per ~64K of quoted paths); out[i] ↔ paths[i].
+    // false if the batch could not be run (disconnected / broken session) — callers fall back to per-path queries.
+    bool StatMany(const std::vector<std::string> &devicePaths, std::vector<RemoteStat> &out);
     // Single-roundtrip name list for collision pre-scan (replaces N+1 FileExists).
     void ListDirNames(const std::string &devicePath, std::unordered_set<std::string>& out);
 
     // Per-file size map for many roots in ONE shell roundtrip — keyed by input devicePath, inner map is rel-path → size; empty dirs yield an empty inner map.
+    // Roots already fetched by PrefetchDirectoryTotals (or still being fetched) are served from there instead.
+    // Once abort_check fires the remaining roots are left out of `out`.
     void BatchDirectoryFileSizes(const std::vector<std::string>& devicePaths,
-                                  std::map<std::string, std::unordered_map<std::string, uint64_t>>& out);
+                                  std::map<std::string, std::unordered_map<std::string, uint64_t>>& out,
+                                  const std::function<bool()>& abort_check = {});
+    // Same single `find`, with mtimes: rel-path → {size, mtime} per root (sync manifests). A symlinked root (/sdcard) is followed.
+    // false if the device could not be asked at all (or abort_check fired) — an empty manifest then means "unknown",
+    // not "no files". complete is set only when find exited 0: an unreadable subfolder or a missing root make it
+    // leave out part of the tree, which must not be taken as those files being absent.
+    bool BatchDirectoryManifests(const std::vector<std::string>& devicePaths, std::map<std::string, FileManifest>& out,
+                                 const std::function<bool()>& abort_check = {}, bool* complete = nullptr);
+    // BatchDirectoryManifests on a given session.
+    static bool ShellDirectoryManifests(ADBShell& shell, const std::vector<std::string>& devicePaths,
+                                        std::map<std::string, FileManifest>& out,
+                                        const std::function<bool()>& abort_check = {}, bool* complete = nullptr);
+    // Starts fetching the recursive manifests of these folders in the background for a later BatchDirectoryFileSizes.
+    void PrefetchDirectoryTotals(const std::vector<std::string>& devicePaths);
+    // Whole-tree search as one device command on a pooled session; matches stream to on_match as find prints them.
+    // false on abort or a broken session — whatever arrived before that was still delivered.
+    bool FindFiles(const FindQuery& query, const std::function<void(const FindMatch&)>& on_match,
+                   const std::function<bool()>& abort_check = {});
 
     // Connection management
     bool Connect();
@@ -121,7 +243,7 @@ public:
     static int Str2Errno(const std::string &adbError);
 
     // Static helper for PluginPanelItem memory management
-    static wchar_t* AllocateItemString(const std::string& s);
+    static wchar_t* AllocateItemString(std::string_view s);
 };
 
 // Path utility functions (shared across ADB classes)
@@ -132,6 +254,9 @@ namespace ADBUtils {
     // Trims trailing newlines/carriage returns
     void TrimTrailingNewlines(std::string& s);
 
+    // Calls fn for each line of text (no EOL, trailing '\r' stripped) as a view into text; no per-line copies.
+    void ForEachLine(std::string_view text, const std::function<void(std::string_view)>& fn);
+
     // Shell quoting for paths with spaces
     std::string ShellQuote(const std::string& s);
 
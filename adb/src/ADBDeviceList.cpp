@@ -0,0 +1,138 @@
+#include "ADBDeviceList.h"
+#include "ADBSocket.h"
+#include "ADBShell.h"
+#include "ADBLog.h"
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <mutex>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+#include <utils.h>
+#include <KeyFileHelper.h>
+
+namespace {
+
+const char* const kNameCommand = "settings get global device_name";
+
+std::string NamesFile()
+{
+    return InMyConfig("plugins/adb/devices.ini");
+}
+
+// false when the device didn't answer; true with "" when it did but has no name.
+bool QueryName(const std::string& serial, std::string& out)
+{
+    out.clear();
+    int exit_code = -1;
+    int rc;
+    {
+        ADBSocket sock(serial);
+        rc = sock.exec(kNameCommand, {}, [&](const char* data, size_t len) { out.append(data, len); return 0; },
+                       {}, exit_code);
+    }
+    if (rc == ADBSocket::kUnavailable) {
+        // No exit status on this path: an empty reply can't be told from a failed command.
+        out = ADBShell::adbExec(std::vector<std::string>{"-s", serial, "shell", kNameCommand});
+    } else if (rc != 0 || exit_code != 0) {
+        out.clear();
+        return false;
+    }
+    while (!out.empty() && (out.back() == '\n' || out.back() == '\r' || out.back() == ' ')) out.pop_back();
+    if (out == "null") {
+        out.clear();
+        return true;
+    }
+    return rc != ADBSocket::kUnavailable || !out.empty();
+}
+
+} // namespace
+
+std::map<std::string, std::string> ADBDeviceNames::Resolve(const std::vector<std::string>& serials)
+{
+    std::map<std::string, std::string> names;
+    if (serials.empty()) return names;
+
+    KeyFileHelper kf(NamesFile());
+    const time_t now = time(nullptr);
+    std::vector<std::string> stale;
+    for (const auto& serial : serials) {
+        const std::string name = kf.GetString(serial, "Name");
+        if (!name.empty()) names[serial] = name;
+        // A device known to have no name is remembered too (Checked with an empty Name) — not asked on every refresh.
+        const time_t checked = (time_t)kf.GetULL(serial, "Checked");
+        if (checked == 0 || now - checked >= kRefreshSec || checked > now) stale.push_back(serial);
+    }
+    if (stale.empty()) return names;
+
+    // Each query is a round trip to a different device; nothing to gain from running them one after another.
+    std::vector<std::string> answers(stale.size());
+    std::vector<char> answered(stale.size(), 0);
+    std::vector<std::thread> threads;
+    threads.reserve(stale.size());
+    for (size_t i = 0; i < stale.size(); ++i) {
+        threads.emplace_back([&answers, &answered, &stale, i] { answered[i] = QueryName(stale[i], answers[i]); });
+    }
+    for (auto& t : threads) t.join();
+
+    for (size_t i = 0; i < stale.size(); ++i) {
+        if (!answered[i]) continue;  // no answer — a cached name stays, asked again next time
+        if (answers[i].empty()) {
+            names.erase(stale[i]);
+        } else {
+            names[stale[i]] = answers[i];
+        }
+        kf.SetString(stale[i], "Name", answers[i]);
+        kf.SetULL(stale[i], "Checked", (unsigned long long)now);
+    }
+    DBG("resolved %zu of %zu stale device name(s)\n",
+        (size_t)std::count(answered.begin(), answered.end(), 1), stale.size());
+    kf.Save();
+    return names;
+}
+
+ADBDeviceTracker::~ADBDeviceTracker()
+{
+    _stopping = true;
+    WaitThread();
+}
+
+bool ADBDeviceTracker::Wanted()
+{
+    const char* env = getenv("FAR2L_ADB_TRACK");
+    return !env || (strcasecmp(env, "off") != 0 && strcmp(env, "0") != 0);
+}
+
+bool ADBDeviceTracker::Start()
+{
+    return StartThread();
+}
+
+void *ADBDeviceTracker::ThreadProc()
+{
+    // The first list is what the selector was just built from; only differences from it count, also across
+    // reconnects — an adb server restart ends the stream, and the new server's first list is compared with the old.
+    bool have_last = false;
+    unsigned delay_ms = kReconnectMinMs;
+    while (!_stopping) {
+        bool got_list = false;
+        [[maybe_unused]] const bool opened = ADBSocket::trackDevices([this, &have_last, &got_list](const std::string& list) {
+                if (have_last && list != _last) ++_generation;
+                have_last = got_list = true;
+                _last = list;
+            }, [this] { return _stopping.load(); });
+        if (_stopping) break;
+        // Server gone: its devices are gone with it as far as the selector is concerned.
+        if (have_last && !_last.empty()) {
+            _last.clear();
+            ++_generation;
+        }
+        delay_ms = got_list ? kReconnectMinMs : std::min(delay_ms * 2, kReconnectMaxMs);
+        DBG("track-devices %s, reconnecting in %u ms\n", opened ? "closed" : "unavailable", delay_ms);
+        for (unsigned waited = 0; waited < delay_ms && !_stopping; waited += kStopPollMs) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(kStopPollMs));
+        }
+    }
+    return nullptr;
+}
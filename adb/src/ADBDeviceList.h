@@ -0,0 +1,52 @@
+#pragma once
+
+// Standard library includes
+#include <string>
+#include <vector>
+#include <map>
+#include <atomic>
+#include <time.h>
+
+#include <Threaded.h>
+
+// Friendly names ("settings get global device_name") for the device selector. Serials not seen before — or not
+// re-checked for kRefreshSec — are queried all at once, one thread per device, and the answers are kept across
+// sessions in the plugin's config dir, so a rack of phones costs one round trip instead of one per phone.
+class ADBDeviceNames {
+public:
+    static constexpr time_t kRefreshSec = 24 * 60 * 60;
+
+    // serial → name for every serial that has one; devices without a name are simply absent. "No name" answers are
+    // kept for kRefreshSec like names, so unnamed devices aren't asked again on every refresh either.
+    static std::map<std::string, std::string> Resolve(const std::vector<std::string>& serials);
+};
+
+// Holds a host:track-devices stream open in the background while the selector is shown; Generation() moves on
+// whenever the server reports a changed device list, so the panel is reread only when something was (un)plugged.
+// The stream is reopened after an adb server restart. FAR2L_ADB_TRACK=off turns it off (the selector then refreshes
+// on Ctrl+R only).
+class ADBDeviceTracker : Threaded {
+public:
+    ADBDeviceTracker() = default;
+    virtual ~ADBDeviceTracker();
+
+    ADBDeviceTracker(const ADBDeviceTracker&) = delete;
+    ADBDeviceTracker& operator=(const ADBDeviceTracker&) = delete;
+
+    static bool Wanted();
+    bool Start();
+    unsigned Generation() const { return _generation.load(); }
+
+protected:
+    virtual void *ThreadProc();
+
+private:
+    // Retry delay while the server is down, doubling up to the max; a stream that delivered a list resets it.
+    static constexpr unsigned kReconnectMinMs = 500;
+    static constexpr unsigned kReconnectMaxMs = 8000;
+    static constexpr unsigned kStopPollMs = 100;
+
+    std::atomic<unsigned> _generation{0};
+    std::atomic<bool> _stopping{false};
+    std::string _last;
+};
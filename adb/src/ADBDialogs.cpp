@@ -1,8 +1,12 @@
 #include "ADBDialogs.h"
+#include "ADBDevice.h"
+#include "ADBStats.h"
+#include "ADBSocket.h"
 #include "ADBLog.h"
 #include "lng.h"
 #include "farplug-wide.h"
 #include <utils.h>
+#include <KeyFileHelper.h>
 #include <algorithm>
 #include <chrono>
 #include <sstream>
@@ -298,6 +302,24 @@ void BaseDialog::TextToDialogControl(int ctl, const char *str)
     TextToDialogControl(ctl, tmp);
 }
 
+void BaseDialog::TextFromDialogControl(int ctl, std::string &str)
+{
+    str.clear();
+    if (ctl < 0 || (size_t)ctl >= _di.size()) return;
+
+    if (_dlg == INVALID_HANDLE_VALUE) {
+        if (_di[ctl].PtrData) str = StrWide2MB(_di[ctl].PtrData);
+        return;
+    }
+
+    std::wstring wstr(0x1000, 0);
+    FarDialogItemData dd = { wstr.size() - 1, &wstr[0] };
+    LONG_PTR rv = SendDlgMessage(DM_GETTEXT, ctl, (LONG_PTR)&dd);
+    if (rv <= 0) return;
+    if ((size_t)rv < wstr.size()) wstr.resize((size_t)rv);
+    str = StrWide2MB(wstr);
+}
+
 void BaseDialog::ProgressBarToDialogControl(int ctl, int percents)
 {
     if (ctl < 0 || (size_t)ctl >= _di.size()) return;
@@ -434,6 +456,106 @@ OverwriteDialog::Result OverwriteDialog::Ask()
     return CANCEL;
 }
 
+// --- FindDialog ---
+
+FindDialog::FindDialog()
+{
+    _di.SetBoxTitleItem(Lng(MFindTitle));
+    _di.SetLine(2);
+    _di.AddAtLine(DI_TEXT, 5, 62, 0, Lng(MFindMasks));
+    _di.NextLine();
+    _i_masks = _di.AddAtLine(DI_EDIT, 5, 62, DIF_HISTORY | DIF_USELASTHISTORY, L"*");
+    _di[_i_masks].History = L"ADB_FindMask";
+    _di.NextLine();
+    _di.AddAtLine(DI_TEXT, 5, 62, 0, Lng(MFindText));
+    _di.NextLine();
+    _i_text = _di.AddAtLine(DI_EDIT, 5, 62, DIF_HISTORY, L"");
+    _di[_i_text].History = L"ADB_FindText";
+    _di.NextLine();
+    _i_case = _di.AddAtLine(DI_CHECKBOX, 5, 40, 0, Lng(MFindCaseSensitive));
+    _di.NextLine();
+    _di.AddAtLine(DI_TEXT, 5, 0, DIF_BOXCOLOR | DIF_SEPARATOR);
+    _di.NextLine();
+    _di.AddAtLine(DI_TEXT, 5, 40, 0, Lng(MFindMinSize));
+    _i_min_size = _di.AddAtLine(DI_EDIT, 42, 62, 0, L"");
+    _di.NextLine();
+    _di.AddAtLine(DI_TEXT, 5, 40, 0, Lng(MFindMaxSize));
+    _i_max_size = _di.AddAtLine(DI_EDIT, 42, 62, 0, L"");
+    _di.NextLine();
+    _di.AddAtLine(DI_TEXT, 5, 40, 0, Lng(MFindDays));
+    _i_days = _di.AddAtLine(DI_EDIT, 42, 62, 0, L"");
+    _di.NextLine();
+    _di.AddAtLine(DI_TEXT, 5, 0, DIF_BOXCOLOR | DIF_SEPARATOR);
+    _di.NextLine();
+    _i_find   = _di.AddAtLine(DI_BUTTON, 0, 0, DIF_CENTERGROUP, Lng(MFindBtn));
+    _i_cancel = _di.AddAtLine(DI_BUTTON, 0, 0, DIF_CENTERGROUP, Lng(MCancelBtn));
+    SetFocusedDialogControl(_i_masks);
+    SetDefaultDialogControl(_i_find);
+}
+
+bool FindDialog::Ask(FindQuery &query)
+{
+    if (Show(L"ADBFind", 3, 2) != _i_find) return false;
+
+    std::string masks, number;
+    TextFromDialogControl(_i_masks, masks);
+    TextFromDialogControl(_i_text, query.text);
+    query.case_sensitive = (SendDlgMessage(DM_GETCHECK, _i_case, 0) == BSTATE_CHECKED);
+
+    // far2l mask lists use ',' or ';'; a leading/trailing blank around each mask is never meant literally.
+    query.masks.clear();
+    size_t pos = 0;
+    while (pos <= masks.size()) {
+        size_t end = masks.find_first_of(",;", pos);
+        if (end == std::string::npos) end = masks.size();
+        std::string m = masks.substr(pos, end - pos);
+        const size_t l = m.find_first_not_of(' '), r = m.find_last_not_of(' ');
+        if (l != std::string::npos) query.masks.push_back(m.substr(l, r - l + 1));
+        pos = end + 1;
+    }
+
+    auto number_at = [&](int ctl) -> uint64_t {
+        TextFromDialogControl(ctl, number);
+        return strtoull(number.c_str(), nullptr, 10);
+    };
+    query.min_size = number_at(_i_min_size) * 1024;
+    query.max_size = number_at(_i_max_size) * 1024;
+    query.modified_days = (unsigned)number_at(_i_days);
+    return true;
+}
+
+// --- SettingsDialog ---
+
+SettingsDialog::SettingsDialog()
+{
+    _di.SetBoxTitleItem(Lng(MConfigTitle));
+    _di.SetLine(2);
+    _i_compress = _di.AddAtLine(DI_CHECKBOX, 5, 66, 0, Lng(MConfigCompress));
+    _di.NextLine();
+    _i_verify = _di.AddAtLine(DI_CHECKBOX, 5, 66, 0, Lng(MConfigVerify));
+    _di.NextLine();
+    _di.AddAtLine(DI_TEXT, 5, 0, DIF_BOXCOLOR | DIF_SEPARATOR);
+    _di.NextLine();
+    _di.AddAtLine(DI_TEXT, 5, 66, 0, Lng(MConfigEnvNote));
+    _di.NextLine();
+    _di.AddAtLine(DI_TEXT, 5, 0, DIF_BOXCOLOR | DIF_SEPARATOR);
+    _di.NextLine();
+    _i_ok     = _di.AddAtLine(DI_BUTTON, 0, 0, DIF_CENTERGROUP, Lng(MOk));
+    _i_cancel = _di.AddAtLine(DI_BUTTON, 0, 0, DIF_CENTERGROUP, Lng(MCancelBtn));
+    SetFocusedDialogControl(_i_compress);
+    SetDefaultDialogControl(_i_ok);
+}
+
+bool SettingsDialog::Ask(ADBSettings &settings)
+{
+    _di[_i_compress].Selected = settings.compress ? BSTATE_CHECKED : BSTATE_UNCHECKED;
+    _di[_i_verify].Selected = settings.verify ? BSTATE_CHECKED : BSTATE_UNCHECKED;
+    if (Show(L"ADBSettings", 3, 2) != _i_ok) return false;
+    settings.compress = (SendDlgMessage(DM_GETCHECK, _i_compress, 0) == BSTATE_CHECKED);
+    settings.verify = (SendDlgMessage(DM_GETCHECK, _i_verify, 0) == BSTATE_CHECKED);
+    return true;
+}
+
 // --- ProgressDialog ---
 
 ProgressDialog::ProgressDialog(ProgressState &state, const std::wstring &title, bool is_multi)
@@ -477,11 +599,11 @@ void ProgressDialog::InitLayout(const std::wstring &title)
         _i_files_processed = _di.AddAtLine(DI_TEXT, 22, 58, 0, L"0");
 
         _di.NextLine();
-        _di.AddAtLine(DI_TEXT, 4, 60, DIF_BOXCOLOR | DIF_SEPARATOR);
+        _i_time_sep = _di.AddAtLine(DI_TEXT, 4, 60, DIF_BOXCOLOR | DIF_SEPARATOR);
     } else {
         // Single: bare divider before time line; total bytes implicit in file bar.
         _di.NextLine();
-        _di.AddAtLine(DI_TEXT, 4, 60, DIF_BOXCOLOR | DIF_SEPARATOR);
+        _i_time_sep = _di.AddAtLine(DI_TEXT, 4, 60, DIF_BOXCOLOR | DIF_SEPARATOR);
         _i_total_bytes = -1;
         _i_total_bar = -1;
         _i_total_pct = -1;
@@ -628,6 +750,15 @@ void ProgressDialog::UpdateDialog()
         TextToDialogControl(_i_files_processed, counter);
     }
 
+    const uint64_t wire_payload = _state.wire_payload.load();
+    if (wire_payload > 0) {
+        const int wire_pct = (int)((_state.wire_bytes.load() * 100) / wire_payload);
+        if (wire_pct != _last_wire_pct) {
+            _last_wire_pct = wire_pct;
+            TextToDialogControl(_i_time_sep, L" " + std::wstring(Lng(MCompressedTo)) + L" " + std::to_wstring(wire_pct) + L"% ");
+        }
+    }
+
     // Time, remaining, speed - properly aligned
     auto now = std::chrono::steady_clock::now();
     auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - _state.start_time).count();
@@ -744,19 +875,19 @@ void ProgressOperation::Run(WorkFunc work_func)
     }
 }
 
-// --- DeleteProgressDialog ---
+// --- StatusProgressDialog ---
 
-DeleteProgressDialog::DeleteProgressDialog(ProgressState& state)
+StatusProgressDialog::StatusProgressDialog(ProgressState& state, const wchar_t* title, const wchar_t* label)
     : _state(state) {
     // 40-char DIF_CENTERTEXT field; box.X2=46, EW=44, W=50, extra_width=6.
-    _di.SetBoxTitleItem(Lng(MDelete));
+    _di.SetBoxTitleItem(title);
     _di.SetLine(2);
-    _di.AddAtLine(DI_TEXT, 5, 44, DIF_CENTERTEXT, Lng(MDeletingFileOrFolder));
+    _di.AddAtLine(DI_TEXT, 5, 44, DIF_CENTERTEXT, label);
     _di.NextLine();
     _i_filename = _di.AddAtLine(DI_TEXT, 5, 44, DIF_CENTERTEXT, L"");
 }
 
-void DeleteProgressDialog::Show() {
+void StatusProgressDialog::Show() {
     while (!_state.finished) {
         _finished = false;
         // box.X2=46, EW=44 (min_x=3, no buttons at X1=0), extra_width=6 → W=50=46+4.
@@ -770,13 +901,13 @@ void DeleteProgressDialog::Show() {
     }
 }
 
-bool DeleteProgressDialog::ShowAbortConfirmation() {
+bool StatusProgressDialog::ShowAbortConfirmation() {
     if (_state.IsAborting()) return true;
     AbortConfirmDialog dlg;
     return dlg.Ask();
 }
 
-LONG_PTR DeleteProgressDialog::DlgProc(int msg, int param1, LONG_PTR param2) {
+LONG_PTR StatusProgressDialog::DlgProc(int msg, int param1, LONG_PTR param2) {
     if (msg == DN_ENTERIDLE) {
         if (_state.finished) {
             if (!_finished) {
@@ -796,7 +927,7 @@ LONG_PTR DeleteProgressDialog::DlgProc(int msg, int param1, LONG_PTR param2) {
     return BaseDialog::DlgProc(msg, param1, param2);
 }
 
-void DeleteProgressDialog::UpdateDialog() {
+void StatusProgressDialog::UpdateDialog() {
     std::wstring current_file;
     {
         std::lock_guard<std::mutex> locker(_state.mtx_strings);
@@ -807,14 +938,14 @@ void DeleteProgressDialog::UpdateDialog() {
     TextToDialogControl(_i_filename, AbbreviatePathLeft(current_file, 40));
 }
 
-// --- DeleteOperation ---
+// --- StatusOperation ---
 
-DeleteOperation::DeleteOperation()
-    : _state(std::make_shared<ProgressState>()) {
+StatusOperation::StatusOperation(const wchar_t* title, const wchar_t* label, int delay_show_ms)
+    : _state(std::make_shared<ProgressState>()), _title(title), _label(label), _delay_show_ms(delay_show_ms) {
     _state->Reset();
 }
 
-void DeleteOperation::Run(WorkFunc work_func) {
+void StatusOperation::Run(WorkFunc work_func) {
     auto state_ptr = _state;
     std::thread worker([state_ptr, work_func]() {
         try { work_func(*state_ptr); } catch (...) {}
@@ -824,8 +955,15 @@ void DeleteOperation::Run(WorkFunc work_func) {
         DWORD dw = 0;
         WINPORT(WriteConsoleInput)(0, &ir, 1, &dw);
     });
-    DeleteProgressDialog dlg(*_state);
-    dlg.Show();
+    if (_delay_show_ms > 0) {
+        std::unique_lock<std::mutex> lock(_state->mtx_finish);
+        _state->cv_finish.wait_for(lock, std::chrono::milliseconds(_delay_show_ms),
+                                   [&]{ return _state->IsFinished(); });
+    }
+    if (!_state->IsFinished()) {
+        StatusProgressDialog dlg(*_state, _title, _label);
+        dlg.Show();
+    }
     if (worker.joinable()) worker.join();
 }
 
@@ -920,6 +1058,84 @@ bool ADBDialogs::AskWarning(const wchar_t* title, const wchar_t* message)
     return (result == 0);
 }
 
+void ADBDialogs::ShowStatistics()
+{
+    for (;;) {
+        std::vector<std::wstring> lines;
+        const std::string report = ADBStats::Report();
+        size_t pos = 0;
+        while (pos < report.size()) {
+            size_t eol = report.find('\n', pos);
+            if (eol == std::string::npos) eol = report.size();
+            lines.push_back(StrMB2Wide(report.substr(pos, eol - pos)));
+            pos = eol + 1;
+        }
+        std::vector<const wchar_t*> items{Lng(MStatsTitle)};
+        for (const auto& l : lines) items.push_back(l.c_str());
+        items.push_back(L"\x01");
+        items.push_back(Lng(MOk));
+        items.push_back(Lng(MStatsSave));
+        items.push_back(Lng(MStatsReset));
+        const int reply = g_Info.Message(g_Info.ModuleNumber, FMSG_LEFTALIGN, nullptr, items.data(), (int)items.size(), 3);
+        if (reply == 2) {
+            ADBStats::Reset();
+            continue;
+        }
+        if (reply == 1) {
+            std::string path;
+            if (const char* env = getenv("FAR2L_ADB_STATS")) path = env;
+            if (path.empty()) {
+                const char* tmp = getenv("TMPDIR");
+                path = std::string((tmp && *tmp) ? tmp : "/tmp") + "/adb_stats.txt";
+            }
+            const bool ok = ADBStats::AppendReport(path);
+            MessageWrapped(ok ? FMSG_MB_OK : (FMSG_WARNING | FMSG_MB_OK), Lng(MStatsTitle),
+                           std::wstring(Lng(ok ? MStatsSaved : MStatsSaveFailed)) + L" " + StrMB2Wide(path));
+        }
+        return;
+    }
+}
+
+static const char *kSettingsSection = "Settings";
+
+static std::string SettingsFile()
+{
+    return InMyConfig("plugins/adb/config.ini");
+}
+
+static void ApplySettings(const ADBSettings &settings)
+{
+    ADBSocket::SetCompressDefault(settings.compress);
+    ADBSocket::SetVerifyDefault(settings.verify);
+}
+
+static ADBSettings ReadSettings()
+{
+    ADBSettings settings;
+    KeyFileReadSection kf(SettingsFile(), kSettingsSection);
+    settings.compress = kf.GetInt("Compress", settings.compress ? 1 : 0) != 0;
+    settings.verify = kf.GetInt("Verify", settings.verify ? 1 : 0) != 0;
+    return settings;
+}
+
+void ADBDialogs::LoadSettings()
+{
+    ApplySettings(ReadSettings());
+}
+
+bool ADBDialogs::Configure()
+{
+    ADBSettings settings = ReadSettings();
+    SettingsDialog dlg;
+    if (!dlg.Ask(settings)) return false;
+    KeyFileHelper kf(SettingsFile());
+    kf.SetInt(kSettingsSection, "Compress", settings.compress ? 1 : 0);
+    kf.SetInt(kSettingsSection, "Verify", settings.verify ? 1 : 0);
+    kf.Save();
+    ApplySettings(settings);
+    return true;
+}
+
 int ADBDialogs::MessageWrapped(unsigned int flags,
                                const std::wstring& title,
                                const std::wstring& body,
@@ -18,6 +18,8 @@
 extern PluginStartupInfo g_Info;
 extern FarStandardFunctions g_FSF;
 
+struct FindQuery;
+
 // --- FarDialogItems: dialog item container ---
 struct FarDialogItems : std::vector<struct FarDialogItem>
 {
@@ -78,6 +80,7 @@ protected:
 
     void TextToDialogControl(int ctl, const std::wstring &str);
     void TextToDialogControl(int ctl, const char *str);
+    void TextFromDialogControl(int ctl, std::string &str);
 
     void ProgressBarToDialogControl(int ctl, int percents = -1);
 
@@ -94,6 +97,8 @@ struct ProgressState
     // Signalled by SetFinished() so delay-show in ProgressOperation::Run wakes immediately.
     std::mutex mtx_finish;
     std::condition_variable cv_finish;
+    // One modal prompt at a time when parallel transfer lanes hit collisions together.
+    std::mutex mtx_prompt;
     std::atomic<uint64_t> file_complete{0};
     std::atomic<uint64_t> file_total{0};
     std::atomic<uint64_t> all_complete{0};
@@ -101,6 +106,9 @@ struct ProgressState
     std::atomic<uint64_t> count_complete{0};
     std::atomic<uint64_t> count_total{0};
     std::atomic<bool> is_directory{false};
+    // Compressed sync traffic so far: payload bytes vs bytes on the wire (both 0 when nothing was compressed).
+    std::atomic<uint64_t> wire_payload{0};
+    std::atomic<uint64_t> wire_bytes{0};
 
     std::chrono::steady_clock::time_point start_time;
 
@@ -120,6 +128,8 @@ struct ProgressState
         count_complete = 0;
         count_total = 0;
         is_directory = false;
+        wire_payload = 0;
+        wire_bytes = 0;
         {
             std::lock_guard<std::mutex> lock(mtx_strings);
             current_file.clear();
@@ -191,6 +201,39 @@ private:
     ViewFn _view_new, _view_existing;
 };
 
+// --- FindDialog: Alt+F7 criteria for a device-side search ---
+class FindDialog : protected BaseDialog
+{
+public:
+    FindDialog();
+    // false on cancel; fields left empty or unparsable mean "no limit".
+    bool Ask(FindQuery &query);
+
+private:
+    int _i_masks, _i_text, _i_case;
+    int _i_min_size, _i_max_size, _i_days;
+    int _i_find, _i_cancel;
+};
+
+// --- SettingsDialog: F9 → Options → Plugins configuration → ADB ---
+struct ADBSettings
+{
+    bool compress = true;
+    bool verify = false;
+};
+
+class SettingsDialog : protected BaseDialog
+{
+public:
+    SettingsDialog();
+    // false on cancel.
+    bool Ask(ADBSettings &settings);
+
+private:
+    int _i_compress, _i_verify;
+    int _i_ok, _i_cancel;
+};
+
 // --- ProgressDialog ---
 class ProgressDialog : protected BaseDialog
 {
@@ -211,6 +254,9 @@ private:
     int _i_operation_label, _i_from_path, _i_to_path;
     int _i_total_bytes, _i_progress_bar, _i_percent, _i_files_processed;
     int _i_time, _i_cancel;
+    // Divider above the time line; titled with the compression ratio once compressed data flows.
+    int _i_time_sep = -1;
+    int _last_wire_pct = -1;
     // Multi-mode only: aggregate-bytes bar + percent. -1 in single mode.
     int _i_total_bar = -1, _i_total_pct = -1;
 
@@ -229,10 +275,10 @@ private:
     bool ShowAbortConfirmation();
 };
 
-// Mirrors far2l's shell-delete UI: small centered modal, current item name debounced.
-class DeleteProgressDialog : protected BaseDialog {
+// Mirrors far2l's shell-delete UI: small centered modal with a fixed label over the current item name (debounced).
+class StatusProgressDialog : protected BaseDialog {
 public:
-    DeleteProgressDialog(ProgressState& state);
+    StatusProgressDialog(ProgressState& state, const wchar_t* title, const wchar_t* label);
     void Show();
 protected:
     LONG_PTR DlgProc(int msg, int param1, LONG_PTR param2) override;
@@ -245,15 +291,20 @@ private:
     bool ShowAbortConfirmation();
 };
 
-class DeleteOperation {
+// Runs work on a thread behind a StatusProgressDialog — delete, directory reading, sync scan, find: waits whose only
+// status is the item at hand. delay_show_ms > 0 skips the modal for quick runs.
+class StatusOperation {
 public:
     using WorkFunc = std::function<void(ProgressState&)>;
-    DeleteOperation();
+    StatusOperation(const wchar_t* title, const wchar_t* label, int delay_show_ms = 0);
     void Run(WorkFunc work_func);
     bool WasAborted() const { return _state->IsAborting(); }
     ProgressState& GetState() { return *_state; }
 private:
     std::shared_ptr<ProgressState> _state;
+    const wchar_t* _title;
+    const wchar_t* _label;
+    int _delay_show_ms;
 };
 
 // --- ADBDialogs: top-level dialog helpers ---
@@ -268,6 +319,11 @@ public:
                         const std::string& default_value = "");
     static bool AskConfirmation(const wchar_t* title, const wchar_t* message);
     static bool AskWarning(const wchar_t* title, const wchar_t* message);
+    // ADBStats report with Save (appends to $FAR2L_ADB_STATS or $TMPDIR/adb_stats.txt) and Reset.
+    static void ShowStatistics();
+    // Settings kept in plugins/adb/config.ini: LoadSettings applies them at startup, Configure edits and applies.
+    static void LoadSettings();
+    static bool Configure();
 
     template<typename... Args>
     static int Message(unsigned int flags, Args&&... extra_lines) {
@@ -0,0 +1,108 @@
+#include "ADBDirCache.h"
+#include "ADBLog.h"
+
+namespace {
+
+std::string TrimSlash(std::string path)
+{
+    while (path.size() > 1 && path.back() == '/') path.pop_back();
+    return path;
+}
+
+std::string ParentOf(const std::string& path)
+{
+    auto slash = path.find_last_of('/');
+    if (slash == std::string::npos) return std::string();
+    return slash == 0 ? std::string("/") : path.substr(0, slash);
+}
+
+bool IsAtOrBelow(const std::string& candidate, const std::string& root)
+{
+    if (root == "/") return !candidate.empty() && candidate[0] == '/';
+    return candidate.size() >= root.size()
+        && candidate.compare(0, root.size(), root) == 0
+        && (candidate.size() == root.size() || candidate[root.size()] == '/');
+}
+
+} // namespace
+
+std::shared_ptr<ADBDirCache> ADBDirCache::ForDevice(const std::string& device_serial)
+{
+    static std::mutex s_registry_mutex;
+    static std::map<std::string, std::weak_ptr<ADBDirCache>> s_registry;
+
+    std::lock_guard<std::mutex> lock(s_registry_mutex);
+    auto& slot = s_registry[device_serial];
+    auto cache = slot.lock();
+    if (!cache) {
+        cache = std::make_shared<ADBDirCache>();
+        slot = cache;
+    }
+    return cache;
+}
+
+bool ADBDirCache::Get(const std::string& path, std::vector<PluginPanelItem>& files,
+                      std::shared_ptr<const ADBItemStrings>& strings, std::string& resolved_path)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _listings.find(TrimSlash(path));
+    if (it == _listings.end()) return false;
+
+    const time_t now = time(nullptr);
+    if (it->second->ts > now || it->second->ts + kExpirationSec < now) {
+        _listings.erase(it);
+        return false;
+    }
+    files = it->second->items;
+    strings = it->second->strings;
+    resolved_path = it->second->resolved_path;
+    DBG("hit '%s' items=%zu\n", path.c_str(), files.size());
+    return true;
+}
+
+void ADBDirCache::Put(const std::string& path, const std::string& resolved_path, const std::vector<PluginPanelItem>& files,
+                      const std::shared_ptr<const ADBItemStrings>& strings)
+{
+    auto listing = std::make_unique<Listing>();
+    listing->resolved_path = TrimSlash(resolved_path);
+    listing->ts = time(nullptr);
+    listing->items = files;
+    listing->strings = strings;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _listings[TrimSlash(path)] = std::move(listing);
+}
+
+void ADBDirCache::Invalidate(const std::string& path, bool with_ancestors)
+{
+    const std::string target = TrimSlash(path);
+    if (target.empty()) return;
+    const std::string parent = ParentOf(target);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto it = _listings.begin(); it != _listings.end(); ) {
+        const std::string& key = it->first;
+        const std::string& resolved = it->second->resolved_path;
+        bool drop = key == parent || resolved == parent
+            || IsAtOrBelow(key, target) || IsAtOrBelow(resolved, target)
+            || (with_ancestors && (IsAtOrBelow(target, key) || IsAtOrBelow(target, resolved)));
+        if (drop) {
+            DBG("drop '%s' (mutated '%s')\n", key.c_str(), target.c_str());
+            it = _listings.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ADBDirCache::Remove(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _listings.erase(TrimSlash(path));
+}
+
+void ADBDirCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _listings.clear();
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+// Standard library includes
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <time.h>
+
+// FAR Manager includes
+#include "farplug-wide.h"
+
+class ADBItemStrings;
+
+// Parsed DirectoryEnum results per device, keyed by the absolute path that was listed.
+// Shared by every ADBDevice for the same serial so a mutation from one panel also drops the other panel's view.
+// Entries are dropped by the plugin's own mutations (Invalidate) and expire as a backstop for changes made outside far2l.
+class ADBDirCache {
+public:
+    static constexpr time_t kExpirationSec = 60;
+
+    static std::shared_ptr<ADBDirCache> ForDevice(const std::string& device_serial);
+
+    ADBDirCache() = default;
+    ADBDirCache(const ADBDirCache&) = delete;
+    ADBDirCache& operator=(const ADBDirCache&) = delete;
+
+    // Copies of the cached items plus a share of the strings they point into (same as DirectoryEnum output); false on miss/expired.
+    bool Get(const std::string& path, std::vector<PluginPanelItem>& files,
+             std::shared_ptr<const ADBItemStrings>& strings, std::string& resolved_path);
+    void Put(const std::string& path, const std::string& resolved_path, const std::vector<PluginPanelItem>& files,
+             const std::shared_ptr<const ADBItemStrings>& strings);
+
+    // `path` was created/removed/replaced: drop its parent's listing and everything at or below it.
+    // with_ancestors also drops each ancestor's own listing (mkdir -p may have created several levels).
+    void Invalidate(const std::string& path, bool with_ancestors = false);
+    // Drop just this listing (explicit refresh).
+    void Remove(const std::string& path);
+    void Clear();
+
+private:
+    struct Listing {
+        std::string resolved_path;
+        time_t ts = 0;
+        std::vector<PluginPanelItem> items;
+        std::shared_ptr<const ADBItemStrings> strings;
+    };
+
+    std::mutex _mutex;
+    std::map<std::string, std::unique_ptr<Listing>> _listings;
+};
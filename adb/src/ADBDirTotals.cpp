@@ -0,0 +1,179 @@
+#include "ADBDirTotals.h"
+#include "ADBShellPool.h"
+#include "ADBShell.h"
+#include "ADBLog.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+std::string TrimSlash(std::string path)
+{
+    while (path.size() > 1 && path.back() == '/') path.pop_back();
+    return path;
+}
+
+bool IsAtOrBelow(const std::string& candidate, const std::string& root)
+{
+    if (root == "/") return !candidate.empty() && candidate[0] == '/';
+    return candidate.size() >= root.size()
+        && candidate.compare(0, root.size(), root) == 0
+        && (candidate.size() == root.size() || candidate[root.size()] == '/');
+}
+
+} // namespace
+
+std::shared_ptr<ADBDirTotals> ADBDirTotals::ForDevice(const std::string& device_serial)
+{
+    static std::mutex s_registry_mutex;
+    static std::map<std::string, std::weak_ptr<ADBDirTotals>> s_registry;
+
+    std::lock_guard<std::mutex> lock(s_registry_mutex);
+    auto& slot = s_registry[device_serial];
+    auto totals = slot.lock();
+    if (!totals) {
+        totals = std::make_shared<ADBDirTotals>(device_serial);
+        slot = totals;
+    }
+    return totals;
+}
+
+ADBDirTotals::ADBDirTotals(const std::string& device_serial)
+    : _device_serial(device_serial), _shell_pool(ADBShellPool::ForDevice(device_serial))
+{
+}
+
+ADBDirTotals::~ADBDirTotals()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queue.clear();
+        _stopping = true;
+    }
+    // A running find notices _stopping within one abort poll and drops its session.
+    WaitThread();
+}
+
+bool ADBDirTotals::PendingLocked(const std::string& dir) const
+{
+    return _fetching.count(dir) != 0 || std::find(_queue.begin(), _queue.end(), dir) != _queue.end();
+}
+
+void ADBDirTotals::Prefetch(const std::vector<std::string>& dirs)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_stopping) return;
+    const time_t now = time(nullptr);
+    bool queued = false;
+    for (const auto& d : dirs) {
+        std::string dir = TrimSlash(d);
+        if (dir.empty() || PendingLocked(dir)) continue;
+        auto it = _entries.find(dir);
+        if (it != _entries.end() && now - it->second.ts < kExpirationSec && it->second.ts <= now) continue;
+        _queue.push_back(std::move(dir));
+        queued = true;
+    }
+    if (queued && !_worker) {
+        // The previous worker has left its loop (it clears _worker under _mutex last thing); reap it and start anew.
+        WaitThread();
+        _worker = StartThread();
+        if (!_worker) _queue.clear();
+    }
+}
+
+bool ADBDirTotals::Get(const std::string& d, FileManifest& out, const std::function<bool()>& abort_check)
+{
+    const std::string dir = TrimSlash(d);
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (PendingLocked(dir)) {
+        if (abort_check) {
+            lock.unlock();
+            const bool abort = abort_check();
+            lock.lock();
+            if (abort) return false;
+        }
+        _cond.wait_for(lock, std::chrono::milliseconds(kAbortPollMs));
+    }
+    auto it = _entries.find(dir);
+    if (it == _entries.end()) return false;
+    const time_t now = time(nullptr);
+    if (now - it->second.ts >= kExpirationSec || it->second.ts > now) {
+        _entries.erase(it);
+        return false;
+    }
+    out = it->second.manifest;
+    return true;
+}
+
+void ADBDirTotals::Put(const std::string& dir, const FileManifest& manifest)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    PutLocked(TrimSlash(dir), manifest);
+}
+
+void ADBDirTotals::PutLocked(const std::string& dir, FileManifest manifest)
+{
+    if (_entries.size() >= kMaxEntries && _entries.find(dir) == _entries.end()) {
+        // Oldest out; a few hundred selected folders is already more than one copy dialog looks at.
+        auto oldest = std::min_element(_entries.begin(), _entries.end(),
+            [](const auto& a, const auto& b) { return a.second.ts < b.second.ts; });
+        _entries.erase(oldest);
+    }
+    Entry& e = _entries[dir];
+    e.ts = time(nullptr);
+    e.manifest = std::move(manifest);
+}
+
+void ADBDirTotals::Invalidate(const std::string& p)
+{
+    const std::string path = TrimSlash(p);
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_generation;
+    for (auto it = _entries.begin(); it != _entries.end(); ) {
+        if (IsAtOrBelow(it->first, path) || IsAtOrBelow(path, it->first)) {
+            it = _entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ADBDirTotals::Clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_generation;
+    _entries.clear();
+}
+
+void *ADBDirTotals::ThreadProc()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_queue.empty() && !_stopping) {
+        std::vector<std::string> batch;
+        batch.swap(_queue);
+        _fetching.insert(batch.begin(), batch.end());
+        const uint64_t generation = _generation;
+        lock.unlock();
+
+        std::map<std::string, FileManifest> manifests;
+        bool ok = false;
+        {
+            auto shell = ADBShellPool::Acquire(_shell_pool);
+            if (shell) {
+                ok = ADBDevice::ShellDirectoryManifests(*shell, batch, manifests, [this] { return _stopping.load(); });
+            }
+        }
+        DBG("prefetched %zu dir(s) for '%s' ok=%d\n", batch.size(), _device_serial.c_str(), ok);
+
+        lock.lock();
+        if (ok && generation == _generation) {
+            for (auto& kv : manifests) PutLocked(TrimSlash(kv.first), std::move(kv.second));
+        }
+        for (const auto& dir : batch) _fetching.erase(dir);
+        _cond.notify_all();
+    }
+    _queue.clear();
+    _worker = false;
+    _cond.notify_all();
+    return nullptr;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+// Standard library includes
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <time.h>
+
+#include <Threaded.h>
+
+#include "ADBDevice.h"
+
+class ADBShellPool;
+
+// Recursive file manifests of device folders, fetched in the background (one `find` per batch on a pooled shell) as
+// soon as folders get selected, so F5/F6 find their totals ready instead of blocking on the pre-scan.
+// Shared by every ADBDevice for the same serial like ADBDirCache; a mutation drops the entries at or below the path
+// and every ancestor's (their totals include it), and entries expire as a backstop for changes made outside far2l.
+class ADBDirTotals : Threaded {
+public:
+    static constexpr time_t kExpirationSec = 60;
+    static constexpr size_t kMaxEntries = 256;
+    static constexpr int kAbortPollMs = 100;
+
+    static std::shared_ptr<ADBDirTotals> ForDevice(const std::string& device_serial);
+
+    explicit ADBDirTotals(const std::string& device_serial);
+    virtual ~ADBDirTotals();
+
+    ADBDirTotals(const ADBDirTotals&) = delete;
+    ADBDirTotals& operator=(const ADBDirTotals&) = delete;
+
+    // Queues the dirs that are neither cached nor already on their way; returns at once.
+    void Prefetch(const std::vector<std::string>& dirs);
+    // Cached manifest of dir, waiting for a prefetch that is still fetching it; false → the caller scans it itself.
+    // The wait gives up (false) once abort_check fires; the prefetch goes on and lands in the cache for next time.
+    bool Get(const std::string& dir, FileManifest& out, const std::function<bool()>& abort_check = {});
+    void Put(const std::string& dir, const FileManifest& manifest);
+    // `path` was created/removed/replaced.
+    void Invalidate(const std::string& path);
+    void Clear();
+
+protected:
+    virtual void *ThreadProc();
+
+private:
+    struct Entry {
+        time_t ts = 0;
+        FileManifest manifest;
+    };
+
+    std::string _device_serial;
+    std::shared_ptr<ADBShellPool> _shell_pool;
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    std::map<std::string, Entry> _entries;
+    std::vector<std::string> _queue;    // waiting for the worker's next find
+    std::set<std::string> _fetching;    // in the worker's current find
+    // Bumped by Invalidate/Clear: a find that started before it may have seen the old tree, its result is dropped.
+    uint64_t _generation = 0;
+    bool _worker = false;
+    std::atomic<bool> _stopping{false};
+
+    bool PendingLocked(const std::string& dir) const;
+    void PutLocked(const std::string& dir, FileManifest manifest);
+};
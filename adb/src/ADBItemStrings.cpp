@@ -0,0 +1,41 @@
+#include "ADBItemStrings.h"
+#include <utils.h>
+
+wchar_t* ADBItemStrings::Allocate(size_t chars)
+{
+    _bytes += chars * sizeof(wchar_t);
+    if (chars > kChunkChars / 4) {
+        // An oversized string gets a chunk of its own; the current chunk keeps serving the small ones.
+        _chunks.emplace_back(new wchar_t[chars]);
+        wchar_t* own = _chunks.back().get();
+        if (_chunks.size() > 1) std::swap(_chunks.back(), _chunks[_chunks.size() - 2]);
+        return own;
+    }
+    if (_capacity - _used < chars) {
+        _chunks.emplace_back(new wchar_t[kChunkChars]);
+        _used = 0;
+        _capacity = kChunkChars;
+    }
+    wchar_t* p = _chunks.back().get() + _used;
+    _used += chars;
+    return p;
+}
+
+const wchar_t* ADBItemStrings::Add(std::string_view s)
+{
+    _scratch.clear();
+    if (!s.empty()) MB2Wide(s.data(), s.size(), _scratch);
+    wchar_t* p = Allocate(_scratch.size() + 1);
+    wmemcpy(p, _scratch.c_str(), _scratch.size() + 1);
+    return p;
+}
+
+const wchar_t* ADBItemStrings::Intern(std::string_view s)
+{
+    for (const auto& kv : _interned) {
+        if (kv.first == s) return kv.second;
+    }
+    const wchar_t* p = Add(s);
+    if (_interned.size() < kMaxInterned) _interned.emplace_back(std::string(s), p);
+    return p;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+// Standard library includes
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <wchar.h>
+
+// Wide strings of one directory listing's PluginPanelItems. Names and descriptions are bump-allocated from 64 KiB
+// chunks instead of one malloc each; owner/group are interned, as a directory rarely has more than a couple of them.
+// Read-only once the listing is built: the same instance backs the DirectoryEnum result, its ADBDirCache entry and
+// the panel's copy (shared_ptr), so a cache hit copies the item array and no strings at all.
+class ADBItemStrings {
+public:
+    ADBItemStrings() = default;
+    ADBItemStrings(const ADBItemStrings&) = delete;
+    ADBItemStrings& operator=(const ADBItemStrings&) = delete;
+
+    // UTF-8 → NUL-terminated wide copy, valid for the lifetime of this object.
+    const wchar_t* Add(std::string_view s);
+    // Same, but equal values share one copy.
+    const wchar_t* Intern(std::string_view s);
+
+    size_t Bytes() const { return _bytes; }
+
+private:
+    static constexpr size_t kChunkChars = 16 * 1024;
+    // Past this many distinct values a linear lookup stops paying off; the rest are plain Add()s.
+    static constexpr size_t kMaxInterned = 32;
+
+    std::vector<std::unique_ptr<wchar_t[]>> _chunks;
+    size_t _used = 0;
+    size_t _capacity = 0;
+    size_t _bytes = 0;
+    std::vector<std::pair<std::string, const wchar_t*>> _interned;
+    std::wstring _scratch;
+
+    wchar_t* Allocate(size_t chars);
+};
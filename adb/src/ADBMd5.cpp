@@ -0,0 +1,98 @@
+#include "ADBMd5.h"
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t kSine[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
+};
+
+constexpr int kShift[64] = {
+    7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+    5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+    4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+    6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21,
+};
+
+inline uint32_t RotateLeft(uint32_t x, int c) {
+    return (x << c) | (x >> (32 - c));
+}
+
+} // namespace
+
+ADBMd5::ADBMd5()
+    : _state{0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476}
+    , _length(0)
+{
+}
+
+void ADBMd5::Transform(const unsigned char block[64]) {
+    uint32_t m[16];
+    for (int i = 0; i < 16; ++i) {
+        m[i] = (uint32_t)block[i * 4] | ((uint32_t)block[i * 4 + 1] << 8)
+             | ((uint32_t)block[i * 4 + 2] << 16) | ((uint32_t)block[i * 4 + 3] << 24);
+    }
+    uint32_t a = _state[0], b = _state[1], c = _state[2], d = _state[3];
+    for (int i = 0; i < 64; ++i) {
+        uint32_t f;
+        int g;
+        if (i < 16)      { f = (b & c) | (~b & d); g = i; }
+        else if (i < 32) { f = (d & b) | (~d & c); g = (5 * i + 1) & 15; }
+        else if (i < 48) { f = b ^ c ^ d;          g = (3 * i + 5) & 15; }
+        else             { f = c ^ (b | ~d);       g = (7 * i) & 15; }
+        const uint32_t tmp = d;
+        d = c;
+        c = b;
+        b = b + RotateLeft(a + f + kSine[i] + m[g], kShift[i]);
+        a = tmp;
+    }
+    _state[0] += a;
+    _state[1] += b;
+    _state[2] += c;
+    _state[3] += d;
+}
+
+void ADBMd5::Update(const void* data, size_t len) {
+    const unsigned char* p = (const unsigned char*)data;
+    size_t used = (size_t)(_length & 63);
+    _length += len;
+    if (used > 0) {
+        const size_t take = (len < 64 - used) ? len : 64 - used;
+        memcpy(_buffer + used, p, take);
+        p += take;
+        len -= take;
+        if (used + take < 64) return;
+        Transform(_buffer);
+    }
+    for (; len >= 64; p += 64, len -= 64) Transform(p);
+    if (len > 0) memcpy(_buffer, p, len);
+}
+
+std::string ADBMd5::HexDigest() {
+    const uint64_t bits = _length * 8;
+    static const unsigned char pad[64] = {0x80};
+    const size_t used = (size_t)(_length & 63);
+    Update(pad, (used < 56) ? 56 - used : 120 - used);
+    unsigned char len_le[8];
+    for (int i = 0; i < 8; ++i) len_le[i] = (unsigned char)(bits >> (8 * i));
+    Update(len_le, sizeof(len_le));
+
+    static const char hex[] = "0123456789abcdef";
+    std::string out;
+    out.reserve(32);
+    for (uint32_t word : _state) {
+        for (int i = 0; i < 4; ++i) {
+            const unsigned char byte = (unsigned char)(word >> (8 * i));
+            out += hex[byte >> 4];
+            out += hex[byte & 15];
+        }
+    }
+    return out;
+}
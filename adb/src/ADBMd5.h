@@ -0,0 +1,24 @@
+#pragma once
+
+// Standard library includes
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+
+// Streaming MD5 (RFC 1321) for transfer verification against the device's `md5sum`; not for anything security related.
+class ADBMd5 {
+public:
+    ADBMd5();
+
+    void Update(const void* data, size_t len);
+    // Lowercase hex digest; the object is spent afterwards.
+    std::string HexDigest();
+
+private:
+    uint32_t _state[4];
+    uint64_t _length;
+    unsigned char _buffer[64];
+
+    void Transform(const unsigned char block[64]);
+};
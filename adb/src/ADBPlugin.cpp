@@ -1,6 +1,9 @@
 #include "ADBPlugin.h"
 #include "ADBDevice.h"
 #include "ADBShell.h"
+#include "ADBSocket.h"
+#include "ADBDeviceList.h"
+#include "ADBItemStrings.h"
 #include "ADBDialogs.h"
 #include "ADBLog.h"
 #include "ProgressBatch.h"
@@ -21,6 +24,7 @@ void SetPanelTitle(wchar_t (&dst)[N], const wchar_t* src) {
 #include <unordered_map>
 #include <atomic>
 #include <cstring>
+#include <algorithm>
 #include <cstdarg>
 #include <unistd.h>
 #include <sys/stat.h>
@@ -41,6 +45,9 @@ static int CheckOverwrite(const std::wstring& destPath, bool isMultiple, bool is
                           uint64_t dst_size = 0, int64_t dst_mtime = 0,
                           OverwriteDialog::ViewFn view_new = nullptr,
                           OverwriteDialog::ViewFn view_existing = nullptr) {
+	// Parallel lanes: later askers wait here and then see the sticky choice (or abort) made by the first.
+	std::lock_guard<std::mutex> prompt_lock(state.mtx_prompt);
+	if (state.ShouldAbort()) return CA_ABORT;
 	if (overwriteMode == 1) return CA_PROCEED;  // Overwrite all
 	if (overwriteMode == 2) return CA_SKIP;     // Skip all
 
@@ -122,6 +129,24 @@ static constexpr std::string_view kAdbPrefixSlash = "adb:/";
 
 // --- collision/overwrite tunables ---
 static constexpr int kFindFreeNameMaxTries = 32;
+static constexpr int kFindFreeNameWindow = 8;
+
+// --- transfer lane tunables ---
+static constexpr size_t kDefaultTransferLanes = 4;
+static constexpr size_t kMaxTransferLanes     = 16;
+
+// Concurrent F5/F6 item transfers; FAR2L_ADB_LANES overrides (1 = serial).
+static size_t TransferLanes() {
+	const char* env = getenv("FAR2L_ADB_LANES");
+	if (!env || !*env) return kDefaultTransferLanes;
+	const long n = strtol(env, nullptr, 10);
+	if (n < 1) return 1;
+	return std::min<size_t>((size_t)n, kMaxTransferLanes);
+}
+
+// --- device fan-out tunables ---
+// One lane per marked device; a rack of phones on one hub is bounded by USB long before this.
+static constexpr size_t kMaxFanOutLanes = 32;
 
 // --- diagnostics tunables ---
 static constexpr time_t kClockSkewWarnSec         = 86400;  // 1 day
@@ -129,6 +154,18 @@ static constexpr time_t kClockSkewWarnThrottleSec = 60;
 
 // FAR API tunable: FCTL_GET*PANELITEM size query covers struct only on some far2l builds; pad covers trailing strings.
 static constexpr size_t kPanelItemAllocPad = 0x100;
+// Directories this populous with files this small go as one tar stream — per-file sync requests dominate there.
+static constexpr uint64_t kBulkMinFiles       = 64;
+static constexpr uint64_t kBulkMaxAvgFileSize = 64 * 1024;
+
+// Sync treats mtimes this close as equal: FAT/exFAT cards keep 2 s resolution.
+static constexpr time_t kSyncMtimeSlackSec = 2;
+
+// Abort check for waits outside any progress dialog (pre-scans); leaves other keys queued.
+static bool EscapePressed() {
+	WORD key = VK_ESCAPE;
+	return WINPORT(CheckForKeyPress)(NULL, &key, 1, CFKP_KEEP_OTHER_EVENTS) != 0;
+}
 
 static void RefreshBothPanels() {
 	g_Info.Control(PANEL_ACTIVE,  FCTL_UPDATEPANEL, 0, 0);
@@ -239,9 +276,11 @@ static ParsedDest ParseDestInput(const std::string& input, const std::string& sr
 // mkdir -p on device; stderr→stdout for errno mapping.
 static int MkdirPAdb(ADBDevice& dev, const std::string& path) {
 	if (path.empty() || path == "/") return 0;
+	int exit_code = -1;
 	std::string out = dev.RunShellCommand(
-		"mkdir -p -- " + ADBUtils::ShellQuote(path) + " 2>&1");
-	if (dev.LastShellExitCode() == 0) return 0;
+		"mkdir -p -- " + ADBUtils::ShellQuote(path) + " 2>&1", &exit_code);
+	dev.InvalidateListing(path, true);
+	if (exit_code == 0) return 0;
 	int errno_mapped = ADBDevice::Str2Errno(out);
 	return errno_mapped ? errno_mapped : EIO;
 }
@@ -253,7 +292,7 @@ static int EnsureAdbParentDirs(ADBDevice& dev, const std::string& abs_path) {
 	return MkdirPAdb(dev, abs_path.substr(0, slash));
 }
 
-// Auto-increment "name(N)" for collision. Cap=32 — each probe is a shell roundtrip.
+// Auto-increment "name(N)" for collision. Cap=32; candidates are probed a window at a time over the pipelined shell.
 static std::string FindFreeAdbName(ADBDevice& dev, const std::string& abs_path) {
 	auto slash = abs_path.find_last_of('/');
 	std::string parent = (slash == std::string::npos) ? std::string() : abs_path.substr(0, slash);
@@ -261,15 +300,27 @@ static std::string FindFreeAdbName(ADBDevice& dev, const std::string& abs_path)
 	std::string stem = base, ext;
 	auto dot = base.find_last_of('.');
 	if (dot != std::string::npos && dot > 0) { stem = base.substr(0, dot); ext = base.substr(dot); }
-	for (int n = 2; n < kFindFreeNameMaxTries; ++n) {
-		std::string cand = parent + (parent.empty() ? "" : "/") + stem + "(" + std::to_string(n) + ")" + ext;
-		if (!dev.FileExists(cand)) return cand;
+	for (int first = 2; first < kFindFreeNameMaxTries; first += kFindFreeNameWindow) {
+		const int last = std::min(first + kFindFreeNameWindow, kFindFreeNameMaxTries);
+		std::vector<std::pair<std::string, std::shared_future<bool>>> probes;
+		for (int n = first; n < last; ++n) {
+			std::string cand = parent + (parent.empty() ? "" : "/") + stem + "(" + std::to_string(n) + ")" + ext;
+			auto exists = dev.FileExistsAsync(cand);
+			probes.emplace_back(std::move(cand), std::move(exists));
+		}
+		for (auto& probe : probes) {
+			if (!probe.second.get()) return probe.first;
+		}
 	}
 	return std::string();
 }
 
-// Device file size via `stat -c %s`; 0 on missing/error.
+// Device file size via sync STAT, `stat -c %s` when the native client is unavailable; 0 on missing/error.
 static uint64_t GetAdbSize(ADBDevice& dev, const std::string& abs_path) {
+	bool exists = false;
+	uint64_t size = 0;
+	time_t mtime = 0;
+	if (dev.StatRemote(abs_path, exists, size, mtime)) return size;
 	std::string cmd = "stat -c %s -- " + ADBUtils::ShellQuote(abs_path) + " 2>/dev/null";
 	std::string out = dev.RunShellCommand(cmd);
 	ADBUtils::TrimTrailingNewlines(out);
@@ -277,14 +328,18 @@ static uint64_t GetAdbSize(ADBDevice& dev, const std::string& abs_path) {
 	try { return (uint64_t)std::stoull(out); } catch (...) { return 0; }
 }
 
-// Device mtime via `stat -c %Y`; logs clock-skew warning (throttled) when device clock is wildly off.
+// Device mtime via sync STAT (`stat -c %Y` fallback); logs clock-skew warning (throttled) when device clock is wildly off.
 static time_t GetAdbMtime(ADBDevice& dev, const std::string& abs_path) {
-	std::string cmd = "stat -c %Y -- " + ADBUtils::ShellQuote(abs_path) + " 2>/dev/null";
-	std::string out = dev.RunShellCommand(cmd);
-	ADBUtils::TrimTrailingNewlines(out);
-	if (out.empty()) return 0;
+	bool exists = false;
+	uint64_t size = 0;
 	time_t mt = 0;
-	try { mt = (time_t)std::stoll(out); } catch (...) { return 0; }
+	if (!dev.StatRemote(abs_path, exists, size, mt)) {
+		std::string cmd = "stat -c %Y -- " + ADBUtils::ShellQuote(abs_path) + " 2>/dev/null";
+		std::string out = dev.RunShellCommand(cmd);
+		ADBUtils::TrimTrailingNewlines(out);
+		if (out.empty()) return 0;
+		try { mt = (time_t)std::stoll(out); } catch (...) { return 0; }
+	}
 	if (mt > 0) {
 		static time_t last_warn = 0;
 		const time_t now = time(nullptr);
@@ -437,7 +492,7 @@ ADBPlugin::~ADBPlugin()
 int ADBPlugin::GetFindData(PluginPanelItem **pPanelItem, int *pItemsNumber, int OpMode)
 {
 	if (_isConnected && _adbDevice) 
-		return GetFileData(pPanelItem, pItemsNumber);
+		return GetFileData(pPanelItem, pItemsNumber, OpMode);
 	
 	return GetDeviceData(pPanelItem, pItemsNumber);
 }
@@ -445,6 +500,14 @@ int ADBPlugin::GetFindData(PluginPanelItem **pPanelItem, int *pItemsNumber, int
 void ADBPlugin::FreeFindData(PluginPanelItem *PanelItem, int ItemsNumber)
 {
 	if (!PanelItem || ItemsNumber <= 0) return;
+
+	// File listing: every string lives in its ADBItemStrings (released with the last share), none is free()d here.
+	auto listing = _panelStrings.find(PanelItem);
+	if (listing != _panelStrings.end()) {
+		_panelStrings.erase(listing);
+		delete[] PanelItem;
+		return;
+	}
 	
 	for (int i = 0; i < ItemsNumber; i++) {
 		free((void*)PanelItem[i].FindData.lpwszFileName);
@@ -558,9 +621,83 @@ int ADBPlugin::ProcessKey(int Key, unsigned int ControlState)
 	if (Key == VK_F6 && ControlState == PKF_SHIFT) {
 		return ShiftF6Rename() ? TRUE : FALSE;
 	}
+	if (_isConnected && _adbDevice && Key == VK_F5 && ControlState == (PKF_CONTROL | PKF_SHIFT)) {
+		return SyncWithPassivePanel() ? TRUE : FALSE;
+	}
+	// Alt+F7 claimed even on cancel — far2l's own search would walk the device folder by folder.
+	if (_isConnected && _adbDevice && Key == VK_F7 && ControlState == PKF_ALT) {
+		(void)FindOnDevice();
+		return TRUE;
+	}
+	// F3 / Ctrl+Q on a folder: far2l walks it for its size; fetch the totals a following F5 will want alongside.
+	if (_isConnected && _adbDevice && ((Key == VK_F3 && ControlState == 0) || (Key == 'Q' && ControlState == PKF_CONTROL))) {
+		PrefetchFolderTotals(true);
+		return FALSE;
+	}
+	// Ctrl+R: drop the cached listing, then let far2l re-read the panel as usual.
+	if (_isConnected && _adbDevice && Key == 'R' && ControlState == PKF_CONTROL) {
+		_adbDevice->RefreshListing(GetCurrentDevicePath());
+		return FALSE;
+	}
 	return FALSE;
 }
 
+void ADBPlugin::ProcessEventIdle()
+{
+	if (!_isConnected) {
+		// Device selector: reread only when track-devices reported a change since the last GetDeviceData.
+		if (_deviceTracker && _deviceTracker->Generation() != _deviceTrackerSeen) {
+			g_Info.Control((HANDLE)this, FCTL_UPDATEPANEL, 1, 0);
+			g_Info.Control((HANDLE)this, FCTL_REDRAWPANEL, 0, 0);
+		}
+		return;
+	}
+	if (!_adbDevice) return;
+	HANDLE active = INVALID_HANDLE_VALUE;
+	g_Info.Control(PANEL_ACTIVE, FCTL_GETPANELPLUGINHANDLE, 0, (LONG_PTR)(void*)&active);
+	if (active != (void*)this) return;
+
+	// Cursor moves alone change nothing here: with no real selection the list stays empty.
+	std::vector<std::string> dirs = PanelFolderPaths(false);
+	if (dirs == _prefetchDirs) return;
+	_prefetchDirs = dirs;
+	if (!dirs.empty()) _adbDevice->PrefetchDirectoryTotals(dirs);
+}
+
+void ADBPlugin::PrefetchFolderTotals(bool current_only)
+{
+	const std::vector<std::string> dirs = PanelFolderPaths(current_only);
+	if (!dirs.empty()) _adbDevice->PrefetchDirectoryTotals(dirs);
+}
+
+std::vector<std::string> ADBPlugin::PanelFolderPaths(bool current_only)
+{
+	// A copy dialog's worth; Select All in a huge folder shouldn't crawl the whole device in the background.
+	constexpr size_t kMaxPrefetchDirs = 64;
+	std::vector<std::string> dirs;
+	PanelInfo pi = {};
+	if (!g_Info.Control(PANEL_ACTIVE, FCTL_GETPANELINFO, 0, (LONG_PTR)(void*)&pi)) return dirs;
+
+	const std::string dir = GetCurrentDevicePath();
+	std::vector<char> buf;
+	const int count = current_only ? 1 : pi.SelectedItemsNumber;
+	for (int i = 0; i < count && dirs.size() < kMaxPrefetchDirs; ++i) {
+		const int cmd = current_only ? FCTL_GETCURRENTPANELITEM : FCTL_GETSELECTEDPANELITEM;
+		intptr_t size = g_Info.Control(PANEL_ACTIVE, cmd, i, 0);
+		if (size < (intptr_t)sizeof(PluginPanelItem)) continue;
+		buf.assign((size_t)size + kPanelItemAllocPad, 0);
+		auto* item = (PluginPanelItem*)buf.data();
+		if (!g_Info.Control(PANEL_ACTIVE, cmd, i, (LONG_PTR)(void*)item)) continue;
+		// With nothing selected far2l reports the cursor item — browsing past folders must not start finds.
+		if (!current_only && !(item->Flags & PPIF_SELECTED)) continue;
+		if (!(item->FindData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) || !item->FindData.lpwszFileName) continue;
+		const std::string name = StrWide2MB(item->FindData.lpwszFileName);
+		if (name.empty() || name == "." || name == "..") continue;
+		dirs.push_back(ADBUtils::JoinPath(dir, name));
+	}
+	return dirs;
+}
+
 bool ADBPlugin::CrossPanelCopyMoveSameDevice(bool move)
 {
 	if (!_isConnected || !_adbDevice || _deviceSerial.empty()) {
@@ -751,11 +888,12 @@ bool ADBPlugin::CrossPanelCopyMoveSameDevice(bool move)
 						if (s > 0 && d > 0 && s <= d) { tr.MarkSkipped(); return 0; }
 					}
 					auto onAbort = [&tr]{ return tr.Aborted(); };
+					auto onWire = [&tr](uint64_t payload, uint64_t wire) { tr.AddWire(payload, wire); };
 					auto cb = [&tr, &idx, isDir](int p, const std::string& path) {
 						tr.Tick(p, path, isDir ? LookupSubitemSize(idx, path) : 0);
 					};
-					int rc = isDir ? adb->PullDirectory(srcPath, localDst, cb, onAbort)
-					               : adb->PullFile(srcPath, localDst, cb, onAbort);
+					int rc = isDir ? adb->PullDirectory(srcPath, localDst, cb, onAbort, onWire)
+					               : adb->PullFile(srcPath, localDst, cb, onAbort, onWire);
 					if (rc != 0) return rc;
 					if (move_cap) {
 						return isDir ? adb->DeleteDirectory(srcPath) : adb->DeleteFile(srcPath);
@@ -983,12 +1121,13 @@ bool ADBPlugin::CrossPanelCopyMoveSameDevice(bool move)
 					else       dstAdb->DeleteFile(dstPath);
 				}
 				auto onAbort = [&]() { return tr.Aborted(); };
+				auto onWire = [&](uint64_t payload, uint64_t wire) { tr.AddWire(payload, wire); };
 				auto displayCb = [&](int pct, const std::string& path) {
 					tr.TickDisplayOnly(pct, path);
 				};
 				int pullRc = isDir
-					? srcAdb->PullDirectory(srcPath, tmpPath, displayCb, onAbort)
-					: srcAdb->PullFile(srcPath, tmpPath, displayCb, onAbort);
+					? srcAdb->PullDirectory(srcPath, tmpPath, displayCb, onAbort, onWire)
+					: srcAdb->PullFile(srcPath, tmpPath, displayCb, onAbort, onWire);
 				if (pullRc != 0) return pullRc;
 
 				tr.Reset();
@@ -996,8 +1135,8 @@ bool ADBPlugin::CrossPanelCopyMoveSameDevice(bool move)
 					tr.Tick(pct, path, isDir ? LookupSubitemSize(idxMap, path) : 0);
 				};
 				int pushRc = isDir
-					? dstAdb->PushDirectory(tmpPath, dstPath, pushCb, onAbort)
-					: dstAdb->PushFile(tmpPath, dstPath, pushCb, onAbort);
+					? dstAdb->PushDirectory(tmpPath, dstPath, pushCb, onAbort, onWire)
+					: dstAdb->PushFile(tmpPath, dstPath, pushCb, onAbort, onWire);
 				(void)RemoveLocalPathRecursively(tmpPath);
 				if (pushRc != 0) return pushRc;
 
@@ -1171,11 +1310,12 @@ bool ADBPlugin::ShiftF5CopyInPlace() {
 						if (s > 0 && d > 0 && s <= d) { tr.MarkSkipped(); return 0; }
 					}
 					auto onAbort = [&tr]{ return tr.Aborted(); };
+					auto onWire = [&tr](uint64_t payload, uint64_t wire) { tr.AddWire(payload, wire); };
 					auto cb = [&tr, &idx, isDir](int p, const std::string& path) {
 						tr.Tick(p, path, isDir ? LookupSubitemSize(idx, path) : 0);
 					};
-					return isDir ? adb->PullDirectory(srcCap, localDst, cb, onAbort)
-					             : adb->PullFile(srcCap, localDst, cb, onAbort);
+					return isDir ? adb->PullDirectory(srcCap, localDst, cb, onAbort, onWire)
+					             : adb->PullFile(srcCap, localDst, cb, onAbort, onWire);
 				};
 				units.push_back(std::move(u));
 			}
@@ -1411,12 +1551,13 @@ bool ADBPlugin::ShiftF5CopyInPlace() {
 				u.total_files = ut.total_files;
 				u.execute = [adb, isDir, srcPathCap, staged, dstPathCap, idxMap = std::move(ut.idx)](ProgressTracker& tr) -> int {
 					auto onAbort = [&]() { return tr.Aborted(); };
+					auto onWire = [&](uint64_t payload, uint64_t wire) { tr.AddWire(payload, wire); };
 					auto displayCb = [&](int pct, const std::string& path) {
 						tr.TickDisplayOnly(pct, path);
 					};
 					int pullRc = isDir
-						? adb->PullDirectory(srcPathCap, staged, displayCb, onAbort)
-						: adb->PullFile(srcPathCap, staged, displayCb, onAbort);
+						? adb->PullDirectory(srcPathCap, staged, displayCb, onAbort, onWire)
+						: adb->PullFile(srcPathCap, staged, displayCb, onAbort, onWire);
 					if (pullRc != 0) return pullRc;
 
 					tr.Reset();
@@ -1424,8 +1565,8 @@ bool ADBPlugin::ShiftF5CopyInPlace() {
 						tr.Tick(pct, path, isDir ? LookupSubitemSize(idxMap, path) : 0);
 					};
 					int pushRc = isDir
-						? adb->PushDirectory(staged, dstPathCap, pushCb, onAbort)
-						: adb->PushFile(staged, dstPathCap, pushCb, onAbort);
+						? adb->PushDirectory(staged, dstPathCap, pushCb, onAbort, onWire)
+						: adb->PushFile(staged, dstPathCap, pushCb, onAbort, onWire);
 					(void)RemoveLocalPathRecursively(staged);
 					return pushRc;
 				};
@@ -1533,11 +1674,12 @@ bool ADBPlugin::ShiftF6Rename() {
 					if (s > 0 && d > 0 && s <= d) { tr.MarkSkipped(); return 0; }
 				}
 				auto onAbort = [&tr]{ return tr.Aborted(); };
+				auto onWire = [&tr](uint64_t payload, uint64_t wire) { tr.AddWire(payload, wire); };
 				auto cb = [&tr, &idx, isDir](int p, const std::string& path) {
 					tr.Tick(p, path, isDir ? LookupSubitemSize(idx, path) : 0);
 				};
-				int pullRc = isDir ? adb->PullDirectory(srcCap, localDst, cb, onAbort)
-				                   : adb->PullFile(srcCap, localDst, cb, onAbort);
+				int pullRc = isDir ? adb->PullDirectory(srcCap, localDst, cb, onAbort, onWire)
+				                   : adb->PullFile(srcCap, localDst, cb, onAbort, onWire);
 				if (pullRc != 0) return pullRc;
 				return isDir ? adb->DeleteDirectory(srcCap) : adb->DeleteFile(srcCap);
 			};
@@ -1646,29 +1788,50 @@ bool ADBPlugin::ShiftF6Rename() {
 	return true;
 }
 
-int ADBPlugin::GetFileData(PluginPanelItem **pPanelItem, int *pItemsNumber)
+int ADBPlugin::GetFileData(PluginPanelItem **pPanelItem, int *pItemsNumber, int OpMode)
 {
 	try {
 		std::vector<PluginPanelItem> files;
-		std::string current_path = _adbDevice->DirectoryEnum(GetCurrentDevicePath(), files);
+		std::shared_ptr<const ADBItemStrings> strings;
+		const std::string dir = GetCurrentDevicePath();
+		if (OpMode & (OPM_SILENT | OPM_FIND)) {
+			_adbDevice->DirectoryEnum(dir, files, strings);
+		} else {
+			// Big dirs stream for seconds — show a running count after a short delay; Esc keeps what has arrived so far.
+			auto adb = _adbDevice;
+			std::exception_ptr enum_error;
+			StatusOperation op(Lng(MReadDirTitle), Lng(MReadingDirEntries), 500);
+			op.Run([&](ProgressState& state) {
+				try {
+					adb->DirectoryEnum(dir, files, strings,
+						[&](size_t n) {
+							std::lock_guard<std::mutex> lk(state.mtx_strings);
+							state.current_file = std::to_wstring(n) + Lng(MItemsSuffix);
+						},
+						[&]() { return state.ShouldAbort(); });
+				} catch (...) {
+					enum_error = std::current_exception();
+				}
+			});
+			if (enum_error) std::rethrow_exception(enum_error);
+		}
 		
+		// Not strings-owned like the rest, but FreeFindData frees nothing of a listing's items.
 		PluginPanelItem parentDir{};
-		parentDir.FindData.lpwszFileName = ADBDevice::AllocateItemString("..");
+		parentDir.FindData.lpwszFileName = L"..";
 		parentDir.FindData.dwFileAttributes = FILE_ATTRIBUTE_DIRECTORY;
 		parentDir.FindData.dwUnixMode = S_IFDIR | 0755;
-		files.insert(files.begin(), parentDir);
 		
 		DBG("Created '..' entry with attributes: 0x%x, mode: 0%o\n", 
 			parentDir.FindData.dwFileAttributes, parentDir.FindData.dwUnixMode);
 		
-		*pItemsNumber = files.size();
-		*pPanelItem = new PluginPanelItem[files.size()];
-		
-		for (size_t i = 0; i < files.size(); i++) {
-			(*pPanelItem)[i] = files[i];
-		}
+		*pItemsNumber = files.size() + 1;
+		*pPanelItem = new PluginPanelItem[files.size() + 1];
+		(*pPanelItem)[0] = parentDir;
+		std::copy(files.begin(), files.end(), *pPanelItem + 1);
+		_panelStrings[*pPanelItem] = std::move(strings);
 		
-		return files.size();
+		return files.size() + 1;
 		
 	} catch (const std::exception &ex) {
 		*pItemsNumber = 1;
@@ -1696,6 +1859,12 @@ int ADBPlugin::GetDeviceData(PluginPanelItem **pPanelItem, int *pItemsNumber)
 {
 	DBG("GetDeviceData: Starting device enumeration\n");
 
+	if (!_deviceTracker && ADBDeviceTracker::Wanted()) {
+		_deviceTracker.reset(new ADBDeviceTracker);
+		if (!_deviceTracker->Start()) _deviceTracker.reset();
+	}
+	// Taken before enumerating: a change that lands meanwhile triggers one more (harmless) reread.
+	if (_deviceTracker) _deviceTrackerSeen = _deviceTracker->Generation();
 	auto deviceInfos = EnumerateDevices();
 
 	// First entry is ".." → exits plugin back to host panel (no Esc/F10 needed).
@@ -1750,24 +1919,6 @@ int ADBPlugin::GetDeviceData(PluginPanelItem **pPanelItem, int *pItemsNumber)
 	return (int)rows.size();
 }
 
-std::string ADBPlugin::GetDeviceFriendlyName(const std::string& serial)
-{
-	// Try to get device name from global settings first
-	std::string cmd = "-s " + serial + " shell settings get global device_name";
-	std::string output = ADBShell::adbExec(cmd);
-	
-	// Remove trailing newline if present
-	if (!output.empty() && output.back() == '\n') {
-		output.pop_back();
-	}
-	
-	if (output.empty() || output == "null") {
-		return "";
-	}
-	
-	return output;
-}
-
 bool ADBPlugin::ByKey_TryEnterSelectedDevice()
 {
 	std::string deviceSerial = GetCurrentPanelItemDeviceName();
@@ -1879,13 +2030,16 @@ bool ADBPlugin::ConnectToDevice(const std::string &deviceSerial)
 
 std::vector<ADBPlugin::DeviceInfo> ADBPlugin::EnumerateDevices() {
 	std::vector<DeviceInfo> devices;
-	std::string output = ADBShell::adbExec("devices -l");
+	// host:devices-l answers in-process; `adb devices -l` also starts the server when it isn't running yet.
+	std::string output;
+	if (!ADBSocket::hostQuery("host:devices-l", output)) {
+		output = ADBShell::adbExec("devices -l");
+	}
 	if (output.empty()) return devices;
 
+	// Header ("List of devices attached") and daemon chatter are filtered by the serial checks below.
 	std::istringstream stream(output);
 	std::string line;
-	if (std::getline(stream, line)) { /* skip header */ }
-
 	while (std::getline(stream, line)) {
 		if (line.empty()) continue;
 		std::istringstream lineStream(line);
@@ -1900,22 +2054,23 @@ std::vector<ADBPlugin::DeviceInfo> ADBPlugin::EnumerateDevices() {
 					if (field.find("model:") == 0) info.model = field.substr(6);
 					else if (field.find("usb:") == 0) info.usb = field;
 				}
-
-				auto it = _friendlyNamesCache.find(serial);
-				if (it != _friendlyNamesCache.end()) {
-					info.name = it->second;
-				} else {
-					info.name = GetDeviceFriendlyName(serial);
-					if (!info.name.empty()) {
-						_friendlyNamesCache[serial] = info.name;
-					}
-				}
-
-				if (info.name.empty()) info.name = info.model.empty() ? serial : info.model;
 				devices.push_back(info);
 			}
 		}
 	}
+
+	// Names for all new devices in one go (concurrent queries, persistent cache) rather than one adb round trip each.
+	std::vector<std::string> unnamed;
+	for (const auto& info : devices) {
+		if (_friendlyNamesCache.find(info.serial) == _friendlyNamesCache.end()) unnamed.push_back(info.serial);
+	}
+	for (auto& kv : ADBDeviceNames::Resolve(unnamed)) _friendlyNamesCache[kv.first] = kv.second;
+
+	for (auto& info : devices) {
+		auto it = _friendlyNamesCache.find(info.serial);
+		if (it != _friendlyNamesCache.end()) info.name = it->second;
+		if (info.name.empty()) info.name = info.model.empty() ? info.serial : info.model;
+	}
 	return devices;
 }
 
@@ -1956,12 +2111,100 @@ static void ScanLocalDirectory(const std::string& path, uint64_t& totalSize, uin
     ScanLocalDirectoryImpl(path, "", totalSize, totalFiles, perFileMap);
 }
 
+// Sync manifest of a host tree: regular files only (device side is `find -type f`, which doesn't follow links either).
+// Like find, keeps going past what it can't read and reports it: 0 or the first errno (ECANCELED on abort).
+static int ScanLocalManifest(const std::string& path, const std::string& relPrefix, FileManifest& out,
+                             const std::function<bool()>& abort_check) {
+	if (abort_check()) return ECANCELED;
+	DIR* dir = opendir(path.c_str());
+	if (!dir) return errno;
+
+	int rc = 0;
+	for (;;) {
+		errno = 0;
+		struct dirent* ent = readdir(dir);
+		if (!ent) {
+			if (errno != 0 && rc == 0) rc = errno;
+			break;
+		}
+		if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) continue;
+		std::string subPath = ADBUtils::JoinPath(path, ent->d_name);
+		std::string subRel = relPrefix.empty() ? std::string(ent->d_name)
+		                                        : relPrefix + "/" + ent->d_name;
+		struct stat st;
+		if (lstat(subPath.c_str(), &st) != 0) {
+			if (rc == 0) rc = errno;
+			continue;
+		}
+		if (S_ISDIR(st.st_mode)) {
+			const int sub_rc = ScanLocalManifest(subPath, subRel, out, abort_check);
+			if (sub_rc == ECANCELED) {
+				rc = sub_rc;
+				break;
+			}
+			if (rc == 0) rc = sub_rc;
+		} else if (S_ISREG(st.st_mode)) {
+			out[subRel] = ManifestEntry{(uint64_t)st.st_size, st.st_mtime};
+		}
+	}
+	closedir(dir);
+	return rc;
+}
+
+namespace {
+
+// far2l's user screen (Ctrl+O area) held for the lifetime of the object; Write() may be called any number of times.
+class UserScreen
+{
+public:
+	explicit UserScreen(HANDLE hPlugin) : _plugin(hPlugin)
+	{
+		// Temporarily enable ENABLE_PROCESSED_OUTPUT: panel mode leaves it off so \r\n would render as CP437 glyphs (♪◙). Same trick as FarExecuteScope.
+		g_Info.Control(_plugin, FCTL_GETUSERSCREEN, 0, 0);
+		WINPORT(GetConsoleMode)(NULL, &_saved_mode);
+		WINPORT(SetConsoleMode)(NULL, _saved_mode | ENABLE_PROCESSED_OUTPUT | ENABLE_WRAP_AT_EOL_OUTPUT);
+	}
+	~UserScreen()
+	{
+		WINPORT(SetConsoleMode)(NULL, _saved_mode);
+		g_Info.Control(_plugin, FCTL_SETUSERSCREEN, 0, 0);
+	}
+	void Write(const std::wstring& text)
+	{
+		DWORD dw = 0;
+		WINPORT(WriteConsole)(NULL, text.c_str(), (DWORD)text.size(), &dw, NULL);
+		DBG("WriteConsole wrote=%u of %zu wchars (saved_mode=0x%lx)\n",
+			(unsigned)dw, text.size(), (unsigned long)_saved_mode);
+	}
+
+private:
+	HANDLE _plugin;
+	DWORD _saved_mode = 0;
+};
+
+} // namespace
+
+void ADBPlugin::WriteUserScreen(HANDLE hPlugin, const std::wstring& text)
+{
+	UserScreen(hPlugin).Write(text);
+}
+
 int ADBPlugin::ProcessEventCommand(const wchar_t *cmd, HANDLE hPlugin)
 {
 	DBG("Called with cmd='%ls'\n", cmd ? cmd : L"NULL");
 
 	if (!cmd) return FALSE;
-	if (!_isConnected || !_adbDevice) return FALSE;
+	if (!_isConnected || !_adbDevice) {
+		// Device selector: a command typed with devices marked runs on all of them.
+		if (_isConnected) return FALSE;
+		const wchar_t *fanCmd = cmd;
+		if (wcsncasecmp(fanCmd, L"adb:", 4) == 0) fanCmd += 4;
+		while (*fanCmd == L' ') fanCmd++;
+		if (*fanCmd == L'\0') return FALSE;
+		const std::vector<std::string> serials = MarkedDevices(true);
+		if (serials.empty()) return FALSE;
+		return FanOutShell(serials, StrWide2MB(fanCmd), hPlugin);
+	}
 
 	const wchar_t *commandToExecute = cmd;
 	if (wcsncasecmp(cmd, L"adb:", 4) == 0) {
@@ -1974,70 +2217,77 @@ int ADBPlugin::ProcessEventCommand(const wchar_t *cmd, HANDLE hPlugin)
 	std::string command = StrWide2MB(commandToExecute);
 	DBG("to-device command='%s' (len=%zu)\n", command.c_str(), command.size());
 
-	// Use persistent stateful session
-	std::string output = _adbDevice->RunShellCommand(command);
-	int exitCode = _adbDevice->LastShellExitCode();
-	DBG("raw output length=%zu bytes exit=%d\n", output.size(), exitCode);
-
-	// Sync path after every command - run pwd to get current directory
-	_adbDevice->SyncPath();
-	std::string newPath = _adbDevice->GetCurrentPath();
-	if (newPath != _CurrentDir) {
-		_CurrentDir = newPath;
-		UpdatePanelTitle(_deviceSerial, _CurrentDir);
-	}
-	DBG("cwd='%s' rc=%d\n", newPath.c_str(), exitCode);
-
-	// Render to far2l user screen (Ctrl+O area) with a "<cwd> $ <cmd>" prefix echoing what the user typed.
-	std::wstring batch;
-	batch += StrMB2Wide(_CurrentDir);
-	batch += L" $ ";
-	batch += StrMB2Wide(command);
-	batch += L"\r\n";
-
-	size_t batch_before_output = batch.size();
+	// Output goes to the user screen (Ctrl+O area) while it arrives, after a "<cwd> $ <cmd>" echo of what was typed;
+	// only one flush worth of text is ever held, however much the command prints. Esc stops it.
+	constexpr size_t kFlushChars = 64 * 1024;
+	constexpr DWORD kFlushMs = 100;
+	bool output_was_empty = true;
+	bool aborted = false;
+	int exitCode = -1;
+	bool ok;
 	{
-		std::istringstream iss(output);
-		std::string line;
-		while (std::getline(iss, line)) {
-			if (!line.empty() && line.back() == '\r') {
-				line.pop_back();
-			}
+		UserScreen screen(hPlugin);
+		std::wstring batch;
+		batch += StrMB2Wide(_CurrentDir);
+		batch += L" $ ";
+		batch += StrMB2Wide(command);
+		batch += L"\r\n";
+		screen.Write(batch);
+		batch.clear();
+
+		DWORD last_flush = WINPORT(GetTickCount)();
+		auto flush = [&]() {
+			if (!batch.empty()) screen.Write(batch);
+			batch.clear();
+			last_flush = WINPORT(GetTickCount)();
+		};
+
+		// Use persistent stateful session
+		ok = _adbDevice->RunShellLinesInCwd(command, [&](std::string_view line) {
 			if (line.empty()) {
-				continue;
+				return;
 			}
 			// Skip bare shell prompts leaked by the marker protocol (e.g. "/$", "#")
 			if (line == "/$" || line == "/#" || line == "$" || line == "#") {
-				continue;
+				return;
 			}
-			batch += StrMB2Wide(line);
+			output_was_empty = false;
+			MB2Wide(line.data(), line.size(), batch, true);
 			batch += L"\r\n";
-		}
+			if (batch.size() >= kFlushChars || WINPORT(GetTickCount)() - last_flush >= kFlushMs) flush();
+		}, [&]() {
+			// Also polled while the command is silent: the last lines before a pause show up without waiting for more.
+			if (!batch.empty() && WINPORT(GetTickCount)() - last_flush >= kFlushMs) flush();
+			if (EscapePressed()) aborted = true;
+			return aborted;
+		}, &exitCode);
+		DBG("streamed ok=%d aborted=%d output_empty=%d rc=%d\n", ok, aborted, output_was_empty ? 1 : 0, exitCode);
+
+		if (aborted) {
+			batch += L"->[Interrupted]\r\n";
+		} else if (output_was_empty && exitCode != 0 && exitCode != -1) {
+			// Only flag silent failures: empty output + non-zero exit. Skip for grep/diff/test — they use non-zero as semantic "no/false" and have output of their own.
+			batch += L"->[Exit code: ";
+			batch += std::to_wstring(exitCode);
+			batch += L"]\r\n";
+		}
+		flush();
+	}
+	// Arbitrary command — can't tell what it touched.
+	_adbDevice->InvalidateAllListings();
+
+	// Sync path after every command - run pwd to get current directory. Not after an abort/timeout: the restarted
+	// session sits in its home directory, which says nothing about where the panel is.
+	if (ok) {
+		_adbDevice->SyncPath();
+		std::string newPath = _adbDevice->GetCurrentPath();
+		if (newPath != _CurrentDir) {
+			_CurrentDir = newPath;
+			UpdatePanelTitle(_deviceSerial, _CurrentDir);
+		}
+		DBG("cwd='%s'\n", newPath.c_str());
 	}
 
-	// Only flag silent failures: empty output + non-zero exit. Skip for grep/diff/test — they use non-zero as semantic "no/false" and have output of their own.
-	const bool output_was_empty = (batch.size() == batch_before_output);
-	if (output_was_empty && exitCode != 0 && exitCode != -1) {
-		batch += L"->[Exit code: ";
-		batch += std::to_wstring(exitCode);
-		batch += L"]\r\n";
-	}
-
-	DBG("batch wchars=%zu output_empty=%d rc=%d\n",
-		batch.size(), output_was_empty ? 1 : 0, exitCode);
-
-	// Temporarily enable ENABLE_PROCESSED_OUTPUT: panel mode leaves it off so \r\n would render as CP437 glyphs (♪◙). Same trick as FarExecuteScope.
-	g_Info.Control(hPlugin, FCTL_GETUSERSCREEN, 0, 0);
-	DWORD saved_mode = 0;
-	WINPORT(GetConsoleMode)(NULL, &saved_mode);
-	WINPORT(SetConsoleMode)(NULL, saved_mode | ENABLE_PROCESSED_OUTPUT | ENABLE_WRAP_AT_EOL_OUTPUT);
-	DWORD dw = 0;
-	WINPORT(WriteConsole)(NULL, batch.c_str(), (DWORD)batch.size(), &dw, NULL);
-	WINPORT(SetConsoleMode)(NULL, saved_mode);
-	DBG("WriteConsole wrote=%u of %zu wchars (saved_mode=0x%lx)\n",
-		(unsigned)dw, batch.size(), (unsigned long)saved_mode);
-	g_Info.Control(hPlugin, FCTL_SETUSERSCREEN, 0, 0);
-
 	g_Info.Control(hPlugin, FCTL_SETCMDLINE, 0, (LONG_PTR)L"");
 
 	// Unconditional UPDATEPANEL so rm/mkdir/touch/mv are reflected without Ctrl+R; FCTL_SETPANELDIR would close the plugin. CmdLine prompt lags one command (far2l cmdline.cpp:527-544 bug).
@@ -2320,7 +2570,7 @@ int ADBPlugin::GetFiles(PluginPanelItem *PanelItem, int ItemsNumber, int Move, c
 	}
 	std::map<std::string, std::unordered_map<std::string, uint64_t>> batchSizes;
 	if (!dirsToScan.empty()) {
-		_adbDevice->BatchDirectoryFileSizes(dirsToScan, batchSizes);
+		_adbDevice->BatchDirectoryFileSizes(dirsToScan, batchSizes, EscapePressed);
 	}
 
 	uint64_t totalBytes = 0, totalFiles = 0;
@@ -2355,6 +2605,10 @@ int ADBPlugin::GetFiles(PluginPanelItem *PanelItem, int ItemsNumber, int Move, c
 int ADBPlugin::PutFiles(PluginPanelItem *PanelItem, int ItemsNumber, int Move, const wchar_t *SrcPath, int OpMode) {
 	DBG("ItemsNumber=%d, Move=%d, OpMode=0x%x\n", ItemsNumber, Move, OpMode);
 
+	if (ItemsNumber > 0 && PanelItem && SrcPath && !_isConnected) {
+		// Files dropped on the device selector go to every device marked there (or the one under the cursor).
+		return FanOutPush(PanelItem, ItemsNumber, Move, StrWide2MB(SrcPath), OpMode);
+	}
 	if (ItemsNumber <= 0 || !_isConnected || !_adbDevice || !PanelItem || !SrcPath) {
 		return FALSE;
 	}
@@ -2409,7 +2663,7 @@ std::map<std::string, ADBPlugin::DirMeta> ADBPlugin::PrescanDeviceDirs(const std
 	if (dirs.empty() || !_isConnected || !_adbDevice) return out;
 	auto t0 = std::chrono::steady_clock::now();
 	std::map<std::string, std::unordered_map<std::string, uint64_t>> raw;
-	_adbDevice->BatchDirectoryFileSizes(dirs, raw);
+	_adbDevice->BatchDirectoryFileSizes(dirs, raw, EscapePressed);
 	uint64_t total_files = 0, total_bytes = 0;
 	for (auto& kv : raw) {
 		DirMeta dm;
@@ -2507,18 +2761,30 @@ int ADBPlugin::RunTransfer(PluginPanelItem *items, int itemsCount, bool is_uploa
 		auto overwriteMode = std::make_shared<int>(0);
 		const bool isMultiple = itemsCount > 1;
 
+		// Device-side state of every unit (upload dst / download src) in one roundtrip instead of ~4 probes per unit.
+		std::vector<std::string> devicePaths;
+		devicePaths.reserve(itemsCount);
+		for (int i = 0; i < itemsCount; i++) {
+			devicePaths.push_back(ADBUtils::JoinPath(deviceDir, StrWide2MB(items[i].FindData.lpwszFileName)));
+		}
+		std::vector<RemoteStat> deviceStats;
+		const bool haveStats = adb->StatMany(devicePaths, deviceStats);
+
 		std::vector<WorkUnit> units;
 		units.reserve(itemsCount);
 		for (int i = 0; i < itemsCount; i++) {
 			std::string fileName = StrWide2MB(items[i].FindData.lpwszFileName);
 			std::string localPath = ADBUtils::JoinPath(localDir, fileName);
-			std::string devicePath = ADBUtils::JoinPath(deviceDir, fileName);
+			std::string devicePath = std::move(devicePaths[i]);
 			const bool isDir = (items[i].FindData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
 			const uint64_t itemSize = isDir ? 0 : items[i].FindData.nFileSize;
 
 			std::string metaKey = is_upload ? localPath : devicePath;
 			auto ut = ComputeUnitTotals(metaKey, isDir, itemSize, dirMetas);
 			auto idx = std::move(ut.idx);
+			const RemoteStat deviceStat = haveStats ? deviceStats[i] : RemoteStat();
+			const bool bulk = isDir && ut.total_files >= kBulkMinFiles
+				&& ut.total_bytes / ut.total_files <= kBulkMaxAvgFileSize;
 
 			WorkUnit u;
 			u.display_name = StrMB2Wide(fileName);
@@ -2528,10 +2794,10 @@ int ADBPlugin::RunTransfer(PluginPanelItem *items, int itemsCount, bool is_uploa
 
 			u.execute = [adb, is_upload, isDir, isMultiple, move, overwriteMode,
 			             localPath = std::move(localPath), devicePath = std::move(devicePath),
-			             itemSize, idx = std::move(idx)](ProgressTracker& tr) -> int {
+			             itemSize, idx = std::move(idx), haveStats, deviceStat, bulk](ProgressTracker& tr) -> int {
 				bool dst_exists = false;
 				if (is_upload) {
-					dst_exists = adb->FileExists(devicePath);
+					dst_exists = haveStats ? deviceStat.exists : adb->FileExists(devicePath);
 				} else {
 					struct stat st;
 					if (stat(localPath.c_str(), &st) == 0) dst_exists = true;
@@ -2549,8 +2815,18 @@ int ADBPlugin::RunTransfer(PluginPanelItem *items, int itemsCount, bool is_uploa
 					auto dst_adb = is_upload ? adb : std::shared_ptr<ADBDevice>();
 					uint64_t src_size = 0, dst_size = 0;
 					int64_t src_mtime = 0, dst_mtime = 0;
-					FillFileMeta(src_adb, src_path, isDir, src_size, src_mtime);
-					FillFileMeta(dst_adb, dst_path, isDir, dst_size, dst_mtime);
+					// Device side comes from the StatMany prefetch when it ran; host side is a local stat.
+					auto fillMeta = [&](std::shared_ptr<ADBDevice> side_adb, const std::string& path,
+					                    uint64_t& size, int64_t& mtime) {
+						if (side_adb && haveStats) {
+							size = isDir ? 0 : deviceStat.size;
+							mtime = isDir ? 0 : static_cast<int64_t>(deviceStat.mtime);
+						} else {
+							FillFileMeta(side_adb, path, isDir, size, mtime);
+						}
+					};
+					fillMeta(src_adb, src_path, src_size, src_mtime);
+					fillMeta(dst_adb, dst_path, dst_size, dst_mtime);
 					int action = CheckOverwrite(
 						StrMB2Wide(dst_path),
 						isMultiple, isDir, *overwriteMode, tr.StateRef(),
@@ -2565,8 +2841,9 @@ int ADBPlugin::RunTransfer(PluginPanelItem *items, int itemsCount, bool is_uploa
 						if (is_upload) activeDevice = fresh; else activeLocal = fresh;
 						dst_exists = false;  // new name is free
 					} else if (action == CA_NEWER) {
-						time_t srcMt = is_upload ? GetLocalMtime(activeLocal) : GetAdbMtime(*adb, activeDevice);
-						time_t dstMt = is_upload ? GetAdbMtime(*adb, activeDevice) : GetLocalMtime(activeLocal);
+						const time_t devMt = haveStats ? deviceStat.mtime : GetAdbMtime(*adb, activeDevice);
+						time_t srcMt = is_upload ? GetLocalMtime(activeLocal) : devMt;
+						time_t dstMt = is_upload ? devMt : GetLocalMtime(activeLocal);
 						if (srcMt > 0 && dstMt > 0 && srcMt <= dstMt) { tr.MarkSkipped(); return 0; }
 						// else: fall through as overwrite
 					}
@@ -2578,6 +2855,7 @@ int ADBPlugin::RunTransfer(PluginPanelItem *items, int itemsCount, bool is_uploa
 					tr.Tick(pct, path, sz);
 				};
 				auto onAbort = [&]() { return tr.Aborted(); };
+				auto onWire = [&](uint64_t payload, uint64_t wire) { tr.AddWire(payload, wire); };
 
 				int rc;
 				if (is_upload) {
@@ -2593,9 +2871,9 @@ int ADBPlugin::RunTransfer(PluginPanelItem *items, int itemsCount, bool is_uploa
 							else       adb->DeleteFile(activeDevice);
 						}
 					}
-					rc = isDir
-						? adb->PushDirectory(activeLocal, activeDevice, cb, onAbort)
-						: adb->PushFile(activeLocal, activeDevice, cb, onAbort);
+					rc = bulk  ? adb->PushDirectoryBulk(activeLocal, activeDevice, cb, onAbort)
+					   : isDir ? adb->PushDirectory(activeLocal, activeDevice, cb, onAbort, onWire)
+					           : adb->PushFile(activeLocal, activeDevice, cb, onAbort, onWire);
 					if (rc == 0) {
 						if (have_aside) {
 							if (isDir) adb->DeleteDirectory(aside);
@@ -2605,9 +2883,9 @@ int ADBPlugin::RunTransfer(PluginPanelItem *items, int itemsCount, bool is_uploa
 						adb->MoveRemoteAs(aside, activeDevice);
 					}
 				} else {
-					rc = isDir
-						? adb->PullDirectory(activeDevice, activeLocal, cb, onAbort)
-						: adb->PullFile(activeDevice, activeLocal, cb, onAbort);
+					rc = bulk  ? adb->PullDirectoryBulk(activeDevice, activeLocal, cb, onAbort)
+					   : isDir ? adb->PullDirectory(activeDevice, activeLocal, cb, onAbort, onWire)
+					           : adb->PullFile(activeDevice, activeLocal, cb, onAbort, onWire);
 				}
 
 				// Move: delete original src on success (rename only mutates dst).
@@ -2626,7 +2904,7 @@ int ADBPlugin::RunTransfer(PluginPanelItem *items, int itemsCount, bool is_uploa
 
 		auto src_label = is_upload ? StrMB2Wide(localDir) : StrMB2Wide(deviceDir);
 		auto dst_label = is_upload ? StrMB2Wide(deviceDir) : StrMB2Wide(localDir);
-		auto br = RunBatch(title, src_label, dst_label, std::move(units));
+		auto br = RunBatch(title, src_label, dst_label, std::move(units), TransferLanes());
 		successCount  = br.success_count;
 		lastErrorCode = br.last_error;
 	}
@@ -2637,12 +2915,485 @@ int ADBPlugin::RunTransfer(PluginPanelItem *items, int itemsCount, bool is_uploa
 	return (successCount > 0) ? TRUE : FALSE;
 }
 
+bool ADBPlugin::SyncWithPassivePanel()
+{
+	PanelInfo ppi = {};
+	std::string hostDir;
+	if (g_Info.Control(PANEL_PASSIVE, FCTL_GETPANELINFO, 0, (LONG_PTR)(void*)&ppi) && !ppi.Plugin) {
+		intptr_t sz = g_Info.Control(PANEL_PASSIVE, FCTL_GETPANELDIR, 0, 0);
+		if (sz > 0) {
+			std::vector<wchar_t> buf(sz);
+			if (g_Info.Control(PANEL_PASSIVE, FCTL_GETPANELDIR, sz, (LONG_PTR)buf.data())) {
+				hostDir = StrWide2MB(buf.data());
+			}
+		}
+	}
+	if (hostDir.empty()) {
+		ADBDialogs::Message(FMSG_WARNING | FMSG_MB_OK, Lng(MSyncTitle), Lng(MSyncNeedsHostPanel));
+		return true;
+	}
+	const std::string deviceDir = GetCurrentDevicePath();
+	auto adb = _adbDevice;
+
+	const std::wstring deviceLine = L"adb:" + StrMB2Wide(deviceDir);
+	const std::wstring hostLine = StrMB2Wide(hostDir);
+	const wchar_t* ask[] = { Lng(MSyncTitle), deviceLine.c_str(), hostLine.c_str(),
+	                         Lng(MSyncDeviceToHost), Lng(MSyncHostToDevice), Lng(MCancelBtn) };
+	const int dir_choice = g_Info.Message(g_Info.ModuleNumber, 0, nullptr, ask, ARRAYSIZE(ask), 3);
+	if (dir_choice != 0 && dir_choice != 1) return true;
+	const bool is_upload = (dir_choice == 1);
+
+	// Both manifests up front: one device `find` + one host walk, whatever the tree size.
+	FileManifest deviceFiles, hostFiles;
+	bool deviceOk = false, deviceComplete = false;
+	int hostScanError = 0;
+	StatusOperation scan(Lng(MSyncTitle), Lng(MSyncComparing), 500);
+	scan.Run([&](ProgressState& state) {
+		try {
+			auto abort_check = [&state]() { return state.ShouldAbort(); };
+			std::map<std::string, FileManifest> raw;
+			deviceOk = adb->BatchDirectoryManifests({deviceDir}, raw, abort_check, &deviceComplete);
+			deviceFiles = std::move(raw[deviceDir]);
+			if (!state.ShouldAbort()) hostScanError = ScanLocalManifest(hostDir, "", hostFiles, abort_check);
+		} catch (const std::exception& ex) {
+			DBG("Sync scan exception: %s\n", ex.what());
+			deviceOk = false;
+		}
+	});
+	if (scan.WasAborted()) return true;
+	if (!deviceOk) {
+		ADBDialogs::MessageWrapped(FMSG_WARNING | FMSG_MB_OK, Lng(MSyncTitle), Lng(MConnectionFailed));
+		return true;
+	}
+	// A file missing from a partial listing would look like an extra (or a new file) — copying what is known is
+	// still fine, deleting on that basis is not.
+	const bool complete = deviceComplete && hostScanError == 0;
+	DBG("Sync manifests: device complete=%d host rc=%d\n", deviceComplete ? 1 : 0, hostScanError);
+
+	const FileManifest& srcFiles = is_upload ? hostFiles : deviceFiles;
+	const FileManifest& dstFiles = is_upload ? deviceFiles : hostFiles;
+	struct SyncItem { std::string rel; uint64_t size; };
+	std::vector<SyncItem> copies;
+	std::vector<std::string> extras;
+	uint64_t newCount = 0, changedCount = 0, copyBytes = 0;
+	for (const auto& kv : srcFiles) {
+		auto it = dstFiles.find(kv.first);
+		if (it != dstFiles.end()) {
+			const ManifestEntry& s = kv.second;
+			const ManifestEntry& d = it->second;
+			const bool mtimeKnown = s.mtime > 0 && d.mtime > 0;
+			const time_t skew = (s.mtime > d.mtime) ? s.mtime - d.mtime : d.mtime - s.mtime;
+			if (s.size == d.size && (!mtimeKnown || skew <= kSyncMtimeSlackSec)) continue;
+			++changedCount;
+		} else {
+			++newCount;
+		}
+		copies.push_back(SyncItem{kv.first, kv.second.size});
+		copyBytes += kv.second.size;
+	}
+	for (const auto& kv : dstFiles) {
+		if (srcFiles.find(kv.first) == srcFiles.end()) extras.push_back(kv.first);
+	}
+	DBG("Sync %s dev='%s' host='%s': src=%zu dst=%zu new=%llu changed=%llu extra=%zu bytes=%llu\n",
+		is_upload ? "up" : "down", deviceDir.c_str(), hostDir.c_str(), srcFiles.size(), dstFiles.size(),
+		(unsigned long long)newCount, (unsigned long long)changedCount, extras.size(),
+		(unsigned long long)copyBytes);
+
+	if (copies.empty() && (extras.empty() || !complete)) {
+		if (complete) {
+			ADBDialogs::Message(FMSG_MB_OK, Lng(MSyncTitle), Lng(MSyncUpToDate));
+		} else {
+			ADBDialogs::Message(FMSG_WARNING | FMSG_MB_OK, Lng(MSyncTitle), Lng(MSyncIncomplete));
+		}
+		return true;
+	}
+
+	// Delta report before anything is touched.
+	const std::wstring srcLabel = is_upload ? hostLine : deviceLine;
+	const std::wstring dstLabel = is_upload ? deviceLine : hostLine;
+	const std::wstring lineNew = std::wstring(Lng(MSyncNewFiles)) + L" " + std::to_wstring(newCount);
+	const std::wstring lineChanged = std::wstring(Lng(MSyncChangedFiles)) + L" " + std::to_wstring(changedCount);
+	const std::wstring lineBytes = std::wstring(Lng(MSyncToTransfer)) + L" " + std::to_wstring(copyBytes)
+		+ L" " + Lng(MBytes);
+	const std::wstring lineExtra = std::wstring(Lng(MSyncExtraFiles)) + L" " + std::to_wstring(extras.size());
+	std::vector<const wchar_t*> report = { Lng(MSyncTitle), srcLabel.c_str(), dstLabel.c_str(), L"\x01",
+	                                       lineNew.c_str(), lineChanged.c_str(), lineBytes.c_str(),
+	                                       lineExtra.c_str() };
+	if (!complete) report.push_back(Lng(MSyncIncomplete));
+	report.push_back(Lng(MSyncRun));
+	const bool canDelete = complete && !extras.empty();
+	if (canDelete) report.push_back(Lng(MSyncRunDelete));
+	report.push_back(Lng(MCancelBtn));
+	const int buttons = canDelete ? 3 : 2;
+	const int go = g_Info.Message(g_Info.ModuleNumber, complete ? 0 : FMSG_WARNING, nullptr,
+	                              report.data(), (int)report.size(), buttons);
+	if (go < 0 || go >= buttons - 1) return true;
+	const bool deleteExtras = canDelete && go == 1;
+	if (copies.empty() && !deleteExtras) return true;
+
+	// Parent dirs once per distinct dir, not once per file.
+	std::set<std::string> parents;
+	for (const auto& c : copies) {
+		auto slash = c.rel.find_last_of('/');
+		if (slash != std::string::npos) parents.insert(c.rel.substr(0, slash));
+	}
+	for (const auto& p : parents) {
+		if (is_upload) (void)MkdirPAdb(*adb, ADBUtils::JoinPath(deviceDir, p));
+		else           (void)MkdirPLocal(ADBUtils::JoinPath(hostDir, p));
+	}
+
+	std::vector<WorkUnit> units;
+	units.reserve(copies.size() + (deleteExtras ? extras.size() : 0));
+	for (auto& c : copies) {
+		WorkUnit u;
+		u.display_name = StrMB2Wide(c.rel);
+		u.total_bytes = c.size;
+		u.total_files = 1;
+		u.execute = [adb, is_upload, size = c.size,
+		             localPath = ADBUtils::JoinPath(hostDir, c.rel),
+		             devicePath = ADBUtils::JoinPath(deviceDir, c.rel)](ProgressTracker& tr) -> int {
+			auto cb = [&](int pct, const std::string& path) { tr.Tick(pct, path, size); };
+			auto onAbort = [&]() { return tr.Aborted(); };
+			auto onWire = [&](uint64_t payload, uint64_t wire) { tr.AddWire(payload, wire); };
+			// Both directions carry the source mtime over, so the next sync sees the pair as equal.
+			return is_upload ? adb->PushFile(localPath, devicePath, cb, onAbort, onWire)
+			                 : adb->PullFile(devicePath, localPath, cb, onAbort, onWire);
+		};
+		units.push_back(std::move(u));
+	}
+	if (deleteExtras) {
+		for (auto& rel : extras) {
+			WorkUnit u;
+			u.display_name = StrMB2Wide(rel);
+			u.total_files = 1;
+			u.execute = [adb, is_upload,
+			             localPath = ADBUtils::JoinPath(hostDir, rel),
+			             devicePath = ADBUtils::JoinPath(deviceDir, rel)](ProgressTracker& tr) -> int {
+				if (tr.Aborted()) return ECANCELED;
+				if (is_upload) return adb->DeleteFile(devicePath);
+				return (unlink(localPath.c_str()) == 0) ? 0 : errno;
+			};
+			units.push_back(std::move(u));
+		}
+	}
+
+	auto br = RunBatch(Lng(MSyncTitle), srcLabel, dstLabel, std::move(units), TransferLanes());
+	if (br.last_error != 0 && !br.aborted) {
+		ADBDialogs::MessageWrapped(FMSG_WARNING | FMSG_MB_OK, Lng(MSyncFailed),
+		                           StrMB2Wide(strerror(br.last_error)));
+	}
+	RefreshBothPanels();
+	return true;
+}
+
+bool ADBPlugin::FindOnDevice()
+{
+	FindQuery query;
+	query.root = GetCurrentDevicePath();
+	FindDialog dlg;
+	if (!dlg.Ask(query)) return false;
+
+	// Matches arrive while the device is still walking; the count shows after a short delay, Esc keeps the partial list.
+	constexpr size_t kFoundReportEvery = 64;
+	auto adb = _adbDevice;
+	std::vector<FindMatch> matches;
+	bool complete = false;
+	StatusOperation op(Lng(MFindTitle), Lng(MFindSearching), 500);
+	op.Run([&](ProgressState& state) {
+		try {
+			complete = adb->FindFiles(query,
+				[&](const FindMatch& m) {
+					matches.push_back(m);
+					if (matches.size() % kFoundReportEvery == 1) {
+						std::lock_guard<std::mutex> lk(state.mtx_strings);
+						state.current_file = Lng(MFindFound) + std::to_wstring(matches.size());
+					}
+				},
+				[&]() { return state.ShouldAbort(); });
+		} catch (const std::exception& ex) {
+			DBG("FindFiles: %s\n", ex.what());
+		}
+	});
+
+	if (matches.empty()) {
+		ADBDialogs::Message(complete ? FMSG_MB_OK : (FMSG_WARNING | FMSG_MB_OK), Lng(MFindTitle),
+		                    Lng(complete ? MFindNothing : MFindInterrupted));
+		return true;
+	}
+
+	// Paths below the search root are shown relative to it; folders get a trailing '/'.
+	const std::string prefix = (query.root == "/") ? query.root : query.root + "/";
+	std::vector<std::wstring> texts;
+	texts.reserve(matches.size());
+	for (const auto& m : matches) {
+		const bool below = m.path.compare(0, prefix.size(), prefix) == 0;
+		texts.push_back(StrMB2Wide(below ? m.path.substr(prefix.size()) : m.path) + (m.is_dir ? L"/" : L""));
+	}
+	std::vector<FarMenuItem> items(matches.size());
+	for (size_t i = 0; i < items.size(); ++i) items[i].Text = texts[i].c_str();
+
+	const std::wstring title = std::wstring(Lng(MFindFound)) + std::to_wstring(matches.size());
+	const int pick = g_Info.Menu(g_Info.ModuleNumber, -1, -1, 0, FMENU_WRAPMODE | FMENU_SHOWAMPERSAND,
+		title.c_str(), Lng(complete ? MFindResultsBottom : MFindInterrupted), L"ADBFind",
+		nullptr, nullptr, items.data(), (int)items.size());
+	if (pick >= 0 && (size_t)pick < matches.size()) GoToDevicePath(matches[pick].path);
+	return true;
+}
+
+void ADBPlugin::GoToDevicePath(const std::string& devicePath)
+{
+	const size_t slash = devicePath.rfind('/');
+	if (slash == std::string::npos) return;
+	const std::string parent = (slash == 0) ? "/" : devicePath.substr(0, slash);
+	const std::wstring name = StrMB2Wide(devicePath.substr(slash + 1));
+
+	if (!_adbDevice->SetDirectory(parent)) return;
+	_CurrentDir = _adbDevice->GetCurrentPath();
+	UpdatePanelTitle(_deviceSerial, _CurrentDir);
+	g_Info.Control(PANEL_ACTIVE, FCTL_UPDATEPANEL, 0, 0);
+
+	PanelInfo pi = {};
+	if (!g_Info.Control(PANEL_ACTIVE, FCTL_GETPANELINFO, 0, (LONG_PTR)(void*)&pi)) return;
+	std::vector<char> buf;
+	for (int i = 0; i < pi.ItemsNumber; ++i) {
+		const intptr_t size = g_Info.Control(PANEL_ACTIVE, FCTL_GETPANELITEM, i, 0);
+		if (size < (intptr_t)sizeof(PluginPanelItem)) continue;
+		buf.assign((size_t)size + kPanelItemAllocPad, 0);
+		auto* item = (PluginPanelItem*)buf.data();
+		if (!g_Info.Control(PANEL_ACTIVE, FCTL_GETPANELITEM, i, (LONG_PTR)(void*)item)) continue;
+		if (item->FindData.lpwszFileName && name == item->FindData.lpwszFileName) {
+			// far2l scrolls the list itself if the item is off-screen.
+			PanelRedrawInfo ri = {};
+			ri.CurrentItem = ri.TopPanelItem = i;
+			g_Info.Control(PANEL_ACTIVE, FCTL_REDRAWPANEL, 0, (LONG_PTR)&ri);
+			return;
+		}
+	}
+	g_Info.Control(PANEL_ACTIVE, FCTL_REDRAWPANEL, 0, 0);
+}
+
+std::vector<std::string> ADBPlugin::MarkedDevices(bool marked_only)
+{
+	std::vector<std::string> serials;
+	PanelInfo pi = {};
+	// Our own panel whichever side it is on — F5 from the host panel reaches PutFiles with us passive.
+	if (!g_Info.Control((HANDLE)this, FCTL_GETPANELINFO, 0, (LONG_PTR)(void*)&pi)) return serials;
+	std::vector<char> buf;
+	for (int i = 0; i < pi.SelectedItemsNumber; ++i) {
+		const intptr_t size = g_Info.Control((HANDLE)this, FCTL_GETSELECTEDPANELITEM, i, 0);
+		if (size < (intptr_t)sizeof(PluginPanelItem)) continue;
+		buf.assign((size_t)size + kPanelItemAllocPad, 0);
+		auto* item = (PluginPanelItem*)buf.data();
+		if (!g_Info.Control((HANDLE)this, FCTL_GETSELECTEDPANELITEM, i, (LONG_PTR)(void*)item)) continue;
+		if (marked_only && !(item->Flags & PPIF_SELECTED)) continue;
+		// Device rows are folders; ".." and the "<Not found>" placeholder are not devices.
+		if (!(item->FindData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) || !item->FindData.lpwszFileName) continue;
+		std::string serial = StrWide2MB(item->FindData.lpwszFileName);
+		if (serial.empty() || serial == "..") continue;
+		serials.push_back(std::move(serial));
+	}
+	return serials;
+}
+
+std::wstring ADBPlugin::DeviceLabel(const std::string& serial) const
+{
+	auto it = _friendlyNamesCache.find(serial);
+	if (it == _friendlyNamesCache.end() || it->second.empty() || it->second == serial) return StrMB2Wide(serial);
+	return StrMB2Wide(it->second + " (" + serial + ")");
+}
+
+std::vector<int> ADBPlugin::RunOnDevices(const std::wstring& title, const std::wstring& what,
+                                         const std::vector<std::string>& serials,
+                                         uint64_t unit_bytes, uint64_t unit_files, const FanOutFn& run)
+{
+	// -1 = never reached (Esc before its lane got to it).
+	auto results = std::make_shared<std::vector<int>>(serials.size(), -1);
+	std::vector<WorkUnit> units;
+	units.reserve(serials.size());
+	for (size_t i = 0; i < serials.size(); ++i) {
+		WorkUnit u;
+		u.display_name = DeviceLabel(serials[i]);
+		u.total_bytes = unit_bytes;
+		u.total_files = unit_files;
+		u.execute = [results, i, serial = serials[i], &run](ProgressTracker& tr) -> int {
+			int rc;
+			try {
+				// A device object of its own per lane: nothing is shared with the other devices' lanes.
+				ADBDevice dev(serial);
+				rc = dev.Connect() ? run(dev, tr) : ENXIO;
+			} catch (const std::exception& ex) {
+				DBG("fan-out '%s': %s\n", serial.c_str(), ex.what());
+				rc = EIO;
+			}
+			(*results)[i] = rc;
+			return rc;
+		};
+		units.push_back(std::move(u));
+	}
+	const std::wstring devices = Lng(MFanOutDevices) + std::to_wstring(serials.size());
+	RunBatch(title, what, devices, std::move(units), std::min(serials.size(), kMaxFanOutLanes));
+	return *results;
+}
+
+void ADBPlugin::ShowFanOutSummary(const std::wstring& title, const std::vector<std::string>& serials,
+                                  const std::vector<int>& results)
+{
+	size_t ok = 0;
+	std::vector<std::wstring> texts;
+	texts.reserve(serials.size());
+	for (size_t i = 0; i < serials.size(); ++i) {
+		const int rc = results[i];
+		if (rc == 0) ++ok;
+		std::wstring status = (rc == 0) ? Lng(MFanOutOk)
+			: (rc < 0) ? Lng(MFanOutNotRun) : StrMB2Wide(strerror(rc));
+		texts.push_back(DeviceLabel(serials[i]) + L": " + status);
+	}
+	std::vector<FarMenuItem> items(texts.size());
+	for (size_t i = 0; i < items.size(); ++i) items[i].Text = texts[i].c_str();
+	const std::wstring bottom = Lng(MFanOutOk) + (L": " + std::to_wstring(ok)) + L", "
+		+ Lng(MFanOutFailedCount) + std::to_wstring(serials.size() - ok);
+	g_Info.Menu(g_Info.ModuleNumber, -1, -1, 0, FMENU_WRAPMODE | FMENU_SHOWAMPERSAND,
+		title.c_str(), bottom.c_str(), L"ADBFanOut", nullptr, nullptr, items.data(), (int)items.size());
+}
+
+int ADBPlugin::FanOutPush(PluginPanelItem *PanelItem, int ItemsNumber, int Move, const std::string& srcDir, int OpMode)
+{
+	const std::vector<std::string> serials = MarkedDevices(false);
+	if (serials.empty() || (OpMode & OPM_SILENT)) return FALSE;
+
+	std::string deviceDir;
+	if (!ADBDialogs::AskInput(Lng(MFanOutPushTitle), Lng(MFanOutPushPrompt), L"ADB_FanOutDir", deviceDir, "/sdcard/")) {
+		return FALSE;
+	}
+
+	// Same payload to every device: totals and the per-file size index are computed once.
+	struct Item {
+		std::string name;
+		bool is_dir;
+	};
+	std::vector<Item> items;
+	std::unordered_map<std::string, uint64_t> file_sizes;
+	uint64_t bytes = 0, files = 0;
+	for (int i = 0; i < ItemsNumber; ++i) {
+		if (!PanelItem[i].FindData.lpwszFileName) continue;
+		Item it{StrWide2MB(PanelItem[i].FindData.lpwszFileName),
+		        (PanelItem[i].FindData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0};
+		if (it.name.empty() || it.name == "." || it.name == "..") continue;
+		if (it.is_dir) {
+			ScanLocalDirectoryImpl(ADBUtils::JoinPath(srcDir, it.name), it.name, bytes, files, &file_sizes);
+		} else {
+			file_sizes[it.name] = PanelItem[i].FindData.nFileSize;
+			bytes += PanelItem[i].FindData.nFileSize;
+			++files;
+		}
+		items.push_back(std::move(it));
+	}
+	if (items.empty()) return FALSE;
+	const auto idx = BuildSubitemIndex(file_sizes);
+
+	auto results = RunOnDevices(Lng(MFanOutPushTitle), StrMB2Wide(srcDir), serials, bytes, files,
+		[&](ADBDevice& dev, ProgressTracker& tr) -> int {
+			if (int rc = dev.CreateDirectory(deviceDir)) return rc;
+			auto cb = [&](int pct, const std::string& path) { tr.Tick(pct, path, LookupSubitemSize(idx, path)); };
+			auto onAbort = [&]() { return tr.Aborted(); };
+			for (const auto& it : items) {
+				if (tr.Aborted()) return ECANCELED;
+				const std::string local = ADBUtils::JoinPath(srcDir, it.name);
+				const std::string remote = ADBUtils::JoinPath(deviceDir, it.name);
+				const int rc = it.is_dir ? dev.PushDirectory(local, remote, cb, onAbort)
+				                         : dev.PushFile(local, remote, cb, onAbort);
+				if (rc != 0) return rc;
+			}
+			return 0;
+		});
+
+	const bool all_ok = std::all_of(results.begin(), results.end(), [](int rc) { return rc == 0; });
+	// Move: the sources only go once every device has its copy.
+	if (Move && all_ok) {
+		for (const auto& it : items) (void)RemoveLocalPathRecursively(ADBUtils::JoinPath(srcDir, it.name));
+	}
+	ShowFanOutSummary(Lng(MFanOutPushTitle), serials, results);
+	return all_ok ? TRUE : FALSE;
+}
+
+int ADBPlugin::FanOutDelete(PluginPanelItem *PanelItem, int ItemsNumber, int OpMode)
+{
+	std::vector<std::string> serials;
+	for (int i = 0; i < ItemsNumber; ++i) {
+		if (!PanelItem[i].FindData.lpwszFileName || !(PanelItem[i].FindData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) continue;
+		std::string serial = StrWide2MB(PanelItem[i].FindData.lpwszFileName);
+		if (!serial.empty() && serial != "..") serials.push_back(std::move(serial));
+	}
+	if (serials.empty() || (OpMode & OPM_SILENT)) return FALSE;
+
+	std::string path;
+	if (!ADBDialogs::AskInput(Lng(MFanOutDeleteTitle), Lng(MFanOutDeletePrompt), L"ADB_FanOutDelete", path)) {
+		return FALSE;
+	}
+	// Relative paths would land in each shell's start directory, which differs between Android versions.
+	if (path[0] != '/' || path == "/") {
+		ADBDialogs::Message(FMSG_WARNING | FMSG_MB_OK, Lng(MFanOutDeleteTitle), Lng(MFanOutAbsolutePath));
+		return FALSE;
+	}
+	const std::wstring question = StrMB2Wide(path) + L" — " + Lng(MFanOutDevices) + std::to_wstring(serials.size());
+	if (!ADBDialogs::AskWarning(Lng(MFanOutDeleteTitle), question.c_str())) return FALSE;
+
+	auto results = RunOnDevices(Lng(MFanOutDeleteTitle), StrMB2Wide(path), serials, 0, 0,
+		[&](ADBDevice& dev, ProgressTracker& tr) -> int {
+			tr.PinNearDone();
+			return dev.DeleteDirectory(path);
+		});
+	ShowFanOutSummary(Lng(MFanOutDeleteTitle), serials, results);
+	return std::all_of(results.begin(), results.end(), [](int rc) { return rc == 0; }) ? TRUE : FALSE;
+}
+
+int ADBPlugin::FanOutShell(const std::vector<std::string>& serials, const std::string& command, HANDLE hPlugin)
+{
+	struct Reply {
+		std::string output;
+		int exit_code = -1;
+	};
+	std::vector<Reply> replies(serials.size());
+	std::map<std::string, size_t> slot;
+	for (size_t i = 0; i < serials.size(); ++i) slot[serials[i]] = i;
+
+	auto results = RunOnDevices(Lng(MFanOutShellTitle), StrMB2Wide(command), serials, 0, 0,
+		[&](ADBDevice& dev, ProgressTracker& tr) -> int {
+			tr.PinNearDone();
+			Reply& r = replies[slot.at(dev.GetDeviceSerial())];
+			r.output = dev.RunShellCommand(command, &r.exit_code);
+			return 0;
+		});
+
+	// Same "<where> $ <cmd>" echo as a single-device command, one block per device in selector order.
+	std::wstring text;
+	for (size_t i = 0; i < serials.size(); ++i) {
+		text += L"[" + DeviceLabel(serials[i]) + L"] $ " + StrMB2Wide(command) + L"\r\n";
+		if (results[i] != 0) {
+			text += L"->[" + (results[i] < 0 ? std::wstring(Lng(MFanOutNotRun)) : StrMB2Wide(strerror(results[i]))) + L"]\r\n";
+			continue;
+		}
+		ADBUtils::ForEachLine(replies[i].output, [&](std::string_view line) {
+			MB2Wide(line.data(), line.size(), text, true);
+			text += L"\r\n";
+		});
+		if (replies[i].exit_code != 0) text += L"->[Exit code: " + std::to_wstring(replies[i].exit_code) + L"]\r\n";
+	}
+	WriteUserScreen(hPlugin, text);
+	g_Info.Control(hPlugin, FCTL_SETCMDLINE, 0, (LONG_PTR)L"");
+	return TRUE;
+}
+
 int ADBPlugin::ProcessHostFile(PluginPanelItem *PanelItem, int ItemsNumber, int OpMode)
 {
 	return TRUE;
 }
 
 int ADBPlugin::DeleteFiles(PluginPanelItem *PanelItem, int ItemsNumber, int OpMode) {
+	if (ItemsNumber > 0 && PanelItem && !_isConnected) {
+		// F8 in the device selector deletes one device path on every marked device.
+		return FanOutDelete(PanelItem, ItemsNumber, OpMode);
+	}
 	if (ItemsNumber <= 0 || !_isConnected || !_adbDevice || !PanelItem) {
 		return FALSE;
 	}
@@ -2735,8 +3486,8 @@ int ADBPlugin::DeleteFiles(PluginPanelItem *PanelItem, int ItemsNumber, int OpMo
 			lastErrorCode = EIO;
 		}
 	} else {
-		// DeleteProgressDialog shows current file during deletion.
-		DeleteOperation op;
+		// StatusProgressDialog shows current file during deletion.
+		StatusOperation op(Lng(MDelete), Lng(MDeletingFileOrFolder));
 		op.GetState().count_total = itemsCount;
 
 		op.Run([&](ProgressState& state) {
@@ -6,6 +6,7 @@
 #include <string>
 #include <map>
 #include <unordered_map>
+#include <functional>
 
 // System includes
 #include <wchar.h>
@@ -42,6 +43,16 @@ private:
 	// Cache for device friendly names to avoid N+1 process spawns
 	std::map<std::string, std::string> _friendlyNamesCache;
 
+	// Strings behind each file listing handed to far2l by GetFindData, until its FreeFindData.
+	std::map<const PluginPanelItem*, std::shared_ptr<const class ADBItemStrings>> _panelStrings;
+
+	// Selector auto-refresh: host:track-devices stream, and its generation the panel was last built from.
+	std::unique_ptr<class ADBDeviceTracker> _deviceTracker;
+	unsigned _deviceTrackerSeen = 0;
+
+	// Selected folders at the last idle prefetch — redraws come with every keypress, prefetches only on a change.
+	std::vector<std::string> _prefetchDirs;
+
 	// Helper method to get current device path
 	std::string GetCurrentDevicePath() const;
 
@@ -66,6 +77,21 @@ private:
 	// Shift+F6 rename/move with full-path prompt + per-collision aside-rename.
 	bool ShiftF6Rename();
 
+	// Ctrl+Shift+F5: rsync-like mirror between this directory and the passive host panel — size/mtime manifests of
+	// both sides in one pass each, only new/changed files are transferred, extras optionally deleted.
+	bool SyncWithPassivePanel();
+
+	// Alt+F7: one device-side `find` (+ `grep -l`) below the current folder instead of far2l's per-directory plugin
+	// search; results in a menu, Enter jumps to the file.
+	bool FindOnDevice();
+	// Opens the folder of devicePath on this panel and puts the cursor on it.
+	void GoToDevicePath(const std::string& devicePath);
+	// Selected folders (or just the one under the cursor) start fetching their totals in the background, so the
+	// F5/F6 pre-scan finds them ready.
+	void PrefetchFolderTotals(bool current_only);
+	// Device paths of the selected folders (or of the one under the cursor); files, ".." and unselected items left out.
+	std::vector<std::string> PanelFolderPaths(bool current_only);
+
 	// Per-directory metadata. file_sizes keys are paths RELATIVE to that dir (matches adb -p output).
 	struct DirMeta {
 		uint64_t total_size = 0;
@@ -92,6 +118,21 @@ private:
 	                const std::map<std::string, DirMeta>& dirMetas,
 	                uint64_t totalBytes, uint64_t totalFiles, int OpMode);
 
+	// Device selector fan-out: one lane per device, each with its own ADBDevice; per-device errno (-1 = not run).
+	using FanOutFn = std::function<int(ADBDevice&, class ProgressTracker&)>;
+	std::vector<std::string> MarkedDevices(bool marked_only);
+	std::wstring DeviceLabel(const std::string& serial) const;
+	std::vector<int> RunOnDevices(const std::wstring& title, const std::wstring& what,
+	                              const std::vector<std::string>& serials,
+	                              uint64_t unit_bytes, uint64_t unit_files, const FanOutFn& run);
+	void ShowFanOutSummary(const std::wstring& title, const std::vector<std::string>& serials,
+	                       const std::vector<int>& results);
+	int FanOutPush(PluginPanelItem *PanelItem, int ItemsNumber, int Move, const std::string& srcDir, int OpMode);
+	int FanOutDelete(PluginPanelItem *PanelItem, int ItemsNumber, int OpMode);
+	int FanOutShell(const std::vector<std::string>& serials, const std::string& command, HANDLE hPlugin);
+	// Command output onto the user screen (Ctrl+O area).
+	void WriteUserScreen(HANDLE hPlugin, const std::wstring& text);
+
 public:
 	ADBPlugin();
 	// Non-virtual dtor — keeps _signature at offset 0 for cross-panel memcpy sig-check (no subclasses).
@@ -104,15 +145,16 @@ public:
 	int SetDirectory(const wchar_t *Dir, int OpMode);
 	int ProcessKey(int Key, unsigned int ControlState);
 	int ProcessEventCommand(const wchar_t *cmd, HANDLE hPlugin = nullptr);
+	// FE_REDRAW / FE_IDLE: follows selection changes for PrefetchFolderTotals.
+	void ProcessEventIdle();
 	
 
 	int ExitDeviceFilePanel();
 	int GetDeviceData(PluginPanelItem **pPanelItem, int *pItemsNumber);
-	int GetFileData(PluginPanelItem **pPanelItem, int *pItemsNumber);
+	int GetFileData(PluginPanelItem **pPanelItem, int *pItemsNumber, int OpMode = 0);
 	
 	// Device selection methods
 	bool ByKey_TryEnterSelectedDevice();
-	std::string GetDeviceFriendlyName(const std::string& serial);
 	std::string GetCurrentPanelItemDeviceName();
 	bool ConnectToDevice(const std::string &deviceSerial);
 
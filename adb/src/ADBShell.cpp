@@ -1,9 +1,11 @@
 // Local includes
 #include "ADBShell.h"
 #include "ADBLog.h"
+#include "ADBStats.h"
 
 // Standard library includes
 #include <cstring>
+#include <cstdlib>
 #include <sstream>
 #include <chrono>
 #include <cstdarg>
@@ -69,6 +71,7 @@ static bool tryAdbPath(const std::string& path) {
         return false;
     }
 
+    ADBStats::Add(ADBStats::PROCESS_SPAWNS);
     pid_t pid = fork();
     if (pid < 0) {
         close(pipefd[0]);
@@ -228,6 +231,17 @@ static void SetupChildEnv() {
 }
 
 bool ADBShell::start() {
+    std::lock_guard<std::mutex> lock(_shell_mutex);
+    return startLocked();
+}
+
+void ADBShell::stop() {
+    // Pending replies and the receive buffer belong to whoever holds the session.
+    std::lock_guard<std::mutex> lock(_shell_mutex);
+    stopLocked();
+}
+
+bool ADBShell::startLocked() {
     if (_is_running) {
         return true; // Already running
     }
@@ -252,6 +266,8 @@ bool ADBShell::start() {
         return false;
     }
 
+    ADBStats::Add(ADBStats::PROCESS_SPAWNS);
+    ADBStats::Add(ADBStats::SHELL_SESSIONS);
     pid_t pid = fork();
     if (pid == 0) {
         // --- Child ---
@@ -280,6 +296,10 @@ bool ADBShell::start() {
         close(pipe_stdin[0]);
         close(pipe_stdout[1]);
 
+#ifdef F_SETPIPE_SZ
+        // Larger pipe → fewer, bigger reads for multi-MB replies (RxBuffer grows its read size to match); best effort.
+        fcntl(pipe_stdout[0], F_SETPIPE_SZ, 1024 * 1024);
+#endif
         _shell_pipe = fdopen(pipe_stdout[0], "r");
         _shell_stdin = pipe_stdin[1];
         _shell_pid = pid;
@@ -395,6 +415,43 @@ bool ADBShell::writeCommand(const std::string& command, const std::string& marke
     return true;
 }
 
+void ADBShell::RxBuffer::consume(size_t n) {
+    _head += std::min(n, _tail - _head);
+    if (_head == _tail) _head = _tail = 0;
+}
+
+void ADBShell::RxBuffer::clear() {
+    _head = _tail = 0;
+    _read_size = kMinRead;
+    if (_capacity > kKeepCapacity) {
+        _buf.reset();
+        _capacity = 0;
+    }
+}
+
+ssize_t ADBShell::RxBuffer::readFrom(int fd) {
+    if (_capacity - _tail < _read_size) {
+        const size_t used = _tail - _head;
+        if (_head > 0 && _capacity - used >= _read_size) {
+            memmove(_buf.get(), _buf.get() + _head, used);
+        } else {
+            const size_t capacity = std::max(_capacity * 2, used + _read_size);
+            std::unique_ptr<char[]> grown(new char[capacity]);
+            if (used) memcpy(grown.get(), _buf.get() + _head, used);
+            _buf = std::move(grown);
+            _capacity = capacity;
+        }
+        _head = 0;
+        _tail = used;
+    }
+    const ssize_t n = read(fd, _buf.get() + _tail, _read_size);
+    if (n > 0) {
+        _tail += (size_t)n;
+        if ((size_t)n == _read_size && _read_size < kMaxRead) _read_size *= 2;
+    }
+    return n;
+}
+
 std::string ADBShell::readResponse(const std::string& marker) {
     if (!_is_running || !_shell_pipe) {
         setError("Shell not running");
@@ -407,20 +464,51 @@ std::string ADBShell::readResponse(const std::string& marker) {
         return "";
     }
 
-    const std::string start_marker = marker + "_S__";
-    const std::string end_marker_prefix = marker + "_E_";
+    const std::string start_marker = marker + kMarkerStartSuffix;
+    const std::string end_marker_prefix = marker + kMarkerEndPrefix;
 
-    std::string raw;
-    char buffer[4096];
+    // Pipelined commands: bytes already in _rx (read past the previous END marker) belong to this response.
+    // Offsets below are relative to _rx.view(), which stays put (nothing is consumed) until the END line is found.
     bool end_found = false;
     size_t end_pos = std::string::npos;
-    // Search floor: rescanning whole `raw` on every chunk is O(n²) for large outputs (e.g. big `cat`); advance past safely-scanned prefix.
+    size_t end_line_end = std::string::npos;
+    // Search floor: rescanning the whole reply on every chunk is O(n²) for large outputs (e.g. big `cat`); advance past safely-scanned prefix.
     size_t end_search_from = 0;
     _last_exit_code = -1;
     // Only consumed by DBG(); suppress unused-variable warning in release builds where DBG expands to nothing.
     [[maybe_unused]] size_t total_read = 0;
     [[maybe_unused]] int read_chunks = 0;
 
+    // Match full <prefix><digits>__ so we don't truncate mid-digit when the marker line arrives in pieces.
+    auto scan_for_end = [&]() {
+        const std::string_view raw = _rx.view();
+        size_t ep = raw.find(end_marker_prefix, end_search_from);
+        if (ep != std::string_view::npos) {
+            size_t digits_start = ep + end_marker_prefix.size();
+            size_t term = raw.find("__", digits_start);
+            if (term != std::string_view::npos && term > digits_start) {
+                std::string_view digits = raw.substr(digits_start, term - digits_start);
+                bool all_digits = std::all_of(digits.begin(), digits.end(),
+                    [](char c) { return c >= '0' && c <= '9'; });
+                if (all_digits) {
+                    // An absurd digit run can't be a real exit status.
+                    _last_exit_code = (digits.size() < 10) ? atoi(std::string(digits).c_str()) : -1;
+                    end_pos = ep;
+                    end_line_end = term + 2;
+                    end_found = true;
+                }
+            }
+        }
+        // Advance floor but leave (prefix_len-1) byte overlap so a marker straddling a chunk boundary still matches;
+        // a prefix whose digits/"__" haven't arrived yet is rescanned from its own start.
+        if (!end_found) {
+            size_t prefix_len = end_marker_prefix.size();
+            end_search_from = (ep != std::string_view::npos) ? ep
+                            : (raw.size() > prefix_len) ? raw.size() - (prefix_len - 1) : 0;
+        }
+    };
+    if (!_rx.empty()) scan_for_end();
+
     constexpr int kReadTimeoutMs = 30000;
     while (!end_found) {
         struct pollfd pfd{};
@@ -437,41 +525,11 @@ std::string ADBShell::readResponse(const std::string& marker) {
             break;
         }
 
-        ssize_t bytes_read = read(fd, buffer, sizeof(buffer));
+        ssize_t bytes_read = _rx.readFrom(fd);
         if (bytes_read > 0) {
-            size_t old_size = raw.size();
-            raw.append(buffer, (size_t)bytes_read);
             total_read += (size_t)bytes_read;
             read_chunks++;
-
-            // Match full <prefix><digits>__ so we don't truncate mid-digit when the marker line arrives in pieces.
-            size_t ep = raw.find(end_marker_prefix, end_search_from);
-            if (ep != std::string::npos) {
-                size_t digits_start = ep + end_marker_prefix.size();
-                size_t term = raw.find("__", digits_start);
-                if (term != std::string::npos && term > digits_start) {
-                    std::string digits = raw.substr(digits_start, term - digits_start);
-                    bool all_digits = !digits.empty() && std::all_of(digits.begin(), digits.end(),
-                        [](char c) { return c >= '0' && c <= '9'; });
-                    if (all_digits) {
-                        // Guard against out_of_range/invalid_argument if device output somehow produces an absurd digit run.
-                        try {
-                            _last_exit_code = std::stoi(digits);
-                        } catch (...) {
-                            _last_exit_code = -1;
-                        }
-                        end_pos = ep;
-                        end_found = true;
-                    }
-                }
-            }
-            // Advance floor but leave (prefix_len-1) byte overlap so a marker straddling a chunk boundary still matches.
-            if (!end_found) {
-                size_t prefix_len = end_marker_prefix.size();
-                end_search_from = (old_size + (size_t)bytes_read > prefix_len)
-                                  ? (old_size + (size_t)bytes_read) - (prefix_len - 1)
-                                  : 0;
-            }
+            scan_for_end();
         } else if (bytes_read == 0) {
             setError("Unexpected EOF from ADB shell");
             // EOF = shell exited; mark dead so next shellCommand restarts instead of writing into a closed pipe.
@@ -489,21 +547,29 @@ std::string ADBShell::readResponse(const std::string& marker) {
     }
 
     if (!end_found) {
+        ADBStats::Add(ADBStats::SHELL_FAILURES);
         DBG("end marker NOT found (timeout/error) total_read=%zu chunks=%d raw_head='%s'\n",
             total_read, read_chunks,
 #if defined(DEBUG) || defined(_DEBUG)
-            EscapeForLog(raw.substr(0, 200)).c_str()
+            EscapeForLog(std::string(_rx.view().substr(0, 200))).c_str()
 #else
             ""
 #endif
         );
+        // Half a reply can't be resynced; the next START marker filters whatever still arrives.
+        _rx.clear();
         return "";
     }
 
+    const std::string_view raw = _rx.view();
+    // Anything after the END line is the next pipelined response (or noise its START filter will drop).
+    if (end_line_end < raw.size() && raw[end_line_end] == '\r') ++end_line_end;
+    if (end_line_end < raw.size() && raw[end_line_end] == '\n') ++end_line_end;
+
     // Pre-START noise = leftover from prior hung commands or device boot messages on a fresh session; discard.
-    size_t sp = raw.find(start_marker);
+    size_t sp = raw.substr(0, end_pos).find(start_marker);
     size_t content_start = 0;
-    if (sp != std::string::npos) {
+    if (sp != std::string_view::npos) {
         content_start = sp + start_marker.size();
         // Skip the newline that follows the start marker echo
         if (content_start < raw.size() && raw[content_start] == '\r') content_start++;
@@ -512,20 +578,22 @@ std::string ADBShell::readResponse(const std::string& marker) {
         DBG("WARN: start marker not found — returning raw up to end marker\n");
     }
 
-    // Content is between content_start and end_pos (start of END marker line); trailing newlines trimmed below.
-    if (end_pos < content_start) {
-        // Out-of-order markers — shouldn't happen under the new protocol; fall through to empty output.
-        DBG("WARN: end marker appeared before start marker (end=%zu start=%zu)\n",
-            end_pos, sp);
-        return "";
+    // Content is between content_start and end_pos (start of END marker line); trailing newlines trimmed here,
+    // so the one copy made is exactly the payload.
+    std::string_view content;
+    if (end_pos >= content_start) {
+        content = raw.substr(content_start, end_pos - content_start);
+        while (!content.empty() && (content.back() == '\n' || content.back() == '\r')) content.remove_suffix(1);
+    } else {
+        // Out-of-order markers — shouldn't happen under the protocol; fall through to empty output.
+        DBG("WARN: end marker appeared before start marker (end=%zu start=%zu)\n", end_pos, sp);
     }
-    std::string output = raw.substr(content_start, end_pos - content_start);
-    ADBUtils::TrimTrailingNewlines(output);
+    std::string output(content);
 
 #if defined(DEBUG) || defined(_DEBUG)
     // Raw bytes between START/END (pre-filter) for diagnosing interleavings/escapes/prompts; head+tail to avoid flooding on `ls /`.
-    std::string between = (sp != std::string::npos && end_pos > content_start)
-                          ? raw.substr(content_start, end_pos - content_start)
+    std::string between = (sp != std::string_view::npos && end_pos > content_start)
+                          ? std::string(raw.substr(content_start, end_pos - content_start))
                           : std::string();
     size_t between_sz = between.size();
     if (between_sz <= 400) {
@@ -539,7 +607,7 @@ std::string ADBShell::readResponse(const std::string& marker) {
     }
 #endif
     DBG("end_found exit=%d pre_start_discarded=%zu content=%zu chunks=%d total=%zu head80='%s'\n",
-        _last_exit_code.load(), (sp != std::string::npos ? sp : (size_t)0),
+        _last_exit_code, (sp != std::string_view::npos ? sp : (size_t)0),
         output.size(), read_chunks, total_read,
 #if defined(DEBUG) || defined(_DEBUG)
         EscapeForLog(output.substr(0, 80)).c_str()
@@ -547,20 +615,28 @@ std::string ADBShell::readResponse(const std::string& marker) {
         ""
 #endif
     );
+    _rx.consume(end_line_end);
+    if (_rx.empty()) _rx.clear();
     return output;
 }
 
-std::string ADBShell::shellCommand(const std::string& command) {
-    // Empty command would expand to `{ ; } < /dev/null 2>&1` (shell syntax error); short-circuit. Preserve previous exit code so callers aren't misled by a bogus 0.
+std::string ADBShell::shellCommand(const std::string& command, int* exit_code) {
+    if (exit_code) *exit_code = -1;
+    // Empty command would expand to `{ ; } < /dev/null 2>&1` (shell syntax error); short-circuit with -1 rather than a bogus 0.
     if (command.empty()) {
         return "";
     }
 
     // Serialize: writeCommand+readResponse is one transaction; parallel callers would cross-corrupt the pipe pair.
     std::lock_guard<std::mutex> lock(_shell_mutex);
+    // Replies of earlier pipelined commands come first on the pipe.
+    drainPendingLocked();
+    // Timed from here: waiting for the session lock or for earlier replies isn't this command's round-trip.
+    ADBStats::Add(ADBStats::SHELL_COMMANDS);
+    ADBStats::ScopedTimer timer(ADBStats::SHELL_ROUNDTRIP_US);
 
     if (!_is_running) {
-        if (!start()) {
+        if (!startLocked()) {
             return "";
         }
     }
@@ -568,8 +644,8 @@ std::string ADBShell::shellCommand(const std::string& command) {
     if (!writeCommand(command, marker)) {
         // Session may have died (EPIPE / shell exit); restart once so next caller isn't stuck against a zombie _is_running flag.
         _is_running = false;
-        stop();
-        if (!start()) {
+        stopLocked();
+        if (!startLocked()) {
             return "";
         }
         if (!writeCommand(command, marker)) {
@@ -577,10 +653,221 @@ std::string ADBShell::shellCommand(const std::string& command) {
         }
     }
     std::string output = readResponse(marker);
+    if (exit_code) *exit_code = _last_exit_code;
     return output;
 }
 
-void ADBShell::stop() {
+bool ADBShell::readResponseLines(const std::string& marker, const LineFn& on_line,
+                                 const std::function<bool()>& abort_check) {
+    if (!_is_running || !_shell_pipe) {
+        setError("Shell not running");
+        return false;
+    }
+
+    int fd = fileno(_shell_pipe);
+    if (fd < 0) {
+        setError("Invalid file descriptor");
+        return false;
+    }
+
+    const std::string start_marker = marker + kMarkerStartSuffix;
+    const std::string end_marker_prefix = marker + kMarkerEndPrefix;
+    _last_exit_code = -1;
+
+    bool started = false;
+    // Returns true once the END marker line is consumed; lines before START are prior-command noise.
+    auto take_line = [&](std::string_view line) -> bool {
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        size_t ep = line.find(end_marker_prefix);
+        if (ep != std::string_view::npos) {
+            std::string_view digits = line.substr(ep + end_marker_prefix.size());
+            size_t term = digits.find("__");
+            if (term != std::string_view::npos && term > 0) {
+                digits = digits.substr(0, term);
+                if (std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+                    _last_exit_code = (digits.size() < 10) ? atoi(std::string(digits).c_str()) : -1;
+                    // Output without a trailing newline glues onto the END echo.
+                    if (started && ep > 0) on_line(line.substr(0, ep));
+                    return true;
+                }
+            }
+        }
+        if (!started) {
+            started = (line == start_marker);
+            return false;
+        }
+        on_line(line);
+        return false;
+    };
+
+    // Lines are handed out as views straight into _rx; a line straddling two reads just stays unconsumed until its '\n'
+    // arrives. `scanned` skips the part of that partial line already searched.
+    constexpr size_t kMaxLineBytes = 1 << 20;
+    bool end_found = false;
+    int idle_ms = 0;
+    size_t scanned = 0;
+
+    // Splits buffered bytes into lines; once END is consumed, the unread tail stays in _rx for the next response.
+    auto feed = [&]() {
+        const std::string_view data = _rx.view();
+        size_t pos = 0;
+        while (!end_found) {
+            size_t nl = data.find('\n', std::max(pos, scanned));
+            if (nl == std::string_view::npos) break;
+            end_found = take_line(data.substr(pos, nl - pos));
+            pos = nl + 1;
+        }
+        // A newline-less flood (binary cat, minified JSON) goes out in pieces instead of growing _rx without bound;
+        // the tail is held back in case the END marker is glued onto it.
+        const size_t keep = end_marker_prefix.size() + 32;
+        if (!end_found && started && data.size() - pos > kMaxLineBytes + keep) {
+            const size_t piece = data.size() - pos - keep;
+            on_line(data.substr(pos, piece));
+            pos += piece;
+        }
+        _rx.consume(pos);
+        scanned = end_found ? 0 : data.size() - pos;
+    };
+    if (!_rx.empty()) feed();
+
+    constexpr int kReadTimeoutMs = 30000;
+    constexpr int kAbortPollMs = 200;
+    const int slice_ms = abort_check ? kAbortPollMs : kReadTimeoutMs;
+    while (!end_found) {
+        if (abort_check && abort_check()) {
+            setError("Aborted");
+            // Rest of the response is still in flight — drop the session rather than resync the pipe.
+            stopLocked();
+            return false;
+        }
+        struct pollfd pfd{};
+        pfd.fd = fd;
+        pfd.events = POLLIN | POLLHUP | POLLERR;
+        int poll_result = poll(&pfd, 1, slice_ms);
+        if (poll_result == 0) {
+            idle_ms += slice_ms;
+            if (idle_ms >= kReadTimeoutMs) {
+                ADBStats::Add(ADBStats::SHELL_FAILURES);
+                setError("Timeout waiting for ADB shell response");
+                return false;
+            }
+            continue;
+        }
+        if (poll_result < 0) {
+            if (errno == EINTR) continue;
+            setError("Poll failed while reading ADB shell response");
+            return false;
+        }
+
+        ssize_t bytes_read = _rx.readFrom(fd);
+        if (bytes_read > 0) {
+            idle_ms = 0;
+            feed();
+        } else if (bytes_read == 0) {
+            ADBStats::Add(ADBStats::SHELL_FAILURES);
+            setError("Unexpected EOF from ADB shell");
+            _is_running = false;
+            return false;
+        } else {
+            if (errno == EINTR) continue;
+            ADBStats::Add(ADBStats::SHELL_FAILURES);
+            setError("Error reading from ADB shell: " + std::to_string(errno));
+            if (errno == EPIPE || errno == ECONNRESET || errno == EBADF) {
+                _is_running = false;
+            }
+            return false;
+        }
+    }
+    DBG("lines end_found exit=%d started=%d\n", _last_exit_code, started);
+    if (_rx.empty()) _rx.clear();
+    return true;
+}
+
+bool ADBShell::shellCommandLines(const std::string& command, const LineFn& on_line,
+                                 const std::function<bool()>& abort_check, int* exit_code) {
+    if (exit_code) *exit_code = -1;
+    if (command.empty()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_shell_mutex);
+    drainPendingLocked();
+    ADBStats::Add(ADBStats::SHELL_COMMANDS);
+
+    if (!_is_running) {
+        if (!startLocked()) {
+            return false;
+        }
+    }
+    std::string marker = generateMarker();
+    if (!writeCommand(command, marker)) {
+        _is_running = false;
+        stopLocked();
+        if (!startLocked()) {
+            return false;
+        }
+        if (!writeCommand(command, marker)) {
+            return false;
+        }
+    }
+    const bool ok = readResponseLines(marker, on_line, abort_check);
+    if (exit_code) *exit_code = _last_exit_code;
+    return ok;
+}
+
+void ADBShell::readNextPendingLocked() {
+    PendingReply p = std::move(_pending.front());
+    _pending.pop_front();
+    p.slot->reply.output = readResponse(p.marker);
+    p.slot->reply.exit_code = _last_exit_code;
+    p.slot->done = true;
+    // Timeout / broken pipe: later replies can't be trusted to line up — fail them; their output is skipped as pre-START noise.
+    if (p.slot->reply.exit_code == -1) failPendingLocked();
+}
+
+void ADBShell::drainPendingLocked() {
+    while (!_pending.empty()) readNextPendingLocked();
+}
+
+void ADBShell::failPendingLocked() {
+    for (auto& p : _pending) p.slot->done = true;
+    _pending.clear();
+}
+
+std::shared_future<ADBShell::Reply> ADBShell::shellCommandAsync(const std::string& command) {
+    auto slot = std::make_shared<ReplySlot>();
+    {
+        std::lock_guard<std::mutex> lock(_shell_mutex);
+        while (_pending.size() >= kMaxInFlight) readNextPendingLocked();
+
+        bool queued = false;
+        if (!command.empty() && (_is_running || startLocked())) {
+            std::string marker = generateMarker();
+            if (!writeCommand(command, marker)) {
+                // Same one-shot restart as shellCommand; whatever was in flight died with the session.
+                stopLocked();
+                if (startLocked() && writeCommand(command, marker)) queued = true;
+            } else {
+                queued = true;
+            }
+            if (queued) {
+                _pending.push_back({marker, slot});
+                ADBStats::Add(ADBStats::SHELL_COMMANDS);
+            }
+        }
+        if (!queued) slot->done = true;
+    }
+    // Deferred: whoever waits first pumps replies in order until this one is in.
+    return std::async(std::launch::deferred, [this, slot]() {
+        std::lock_guard<std::mutex> lock(_shell_mutex);
+        while (!slot->done && !_pending.empty()) readNextPendingLocked();
+        return slot->reply;
+    }).share();
+}
+
+void ADBShell::stopLocked() {
+    failPendingLocked();
+    _rx.clear();
     if (_shell_stdin != -1) {
         close(_shell_stdin);
         _shell_stdin = -1;
@@ -687,6 +974,8 @@ std::string ADBShell::runAdbProcess(const std::vector<std::string>& args, const
         return "";
     }
 
+    ADBStats::Add(ADBStats::PROCESS_SPAWNS);
+    ADBStats::ScopedTimer timer(ADBStats::PROCESS_RUN_US);
     pid_t pid = fork();
     if (pid < 0) {
         DBG("runAdbProcess: Failed to fork, errno=%d\n", errno);
@@ -731,7 +1020,8 @@ std::string ADBShell::runAdbProcess(const std::vector<std::string>& args, const
     return output;
 }
 
-std::string ADBShell::runAdbProcessWithPty(const std::vector<std::string>& args, const std::function<void(const std::string&)>& on_chunk, const std::function<bool()>& abort_check) {
+std::string ADBShell::runAdbProcessWithPty(const std::vector<std::string>& args, const std::function<void(const std::string&)>& on_chunk, const std::function<bool()>& abort_check, int* exit_status) {
+    if (exit_status) *exit_status = -1;
     std::string adbPath = findAdbExecutable();
     if (adbPath.empty()) return "";
 
@@ -740,6 +1030,8 @@ std::string ADBShell::runAdbProcessWithPty(const std::vector<std::string>& args,
     win.ws_col = 4096; win.ws_row = 24;
 
     int master_fd = -1;
+    ADBStats::Add(ADBStats::PROCESS_SPAWNS);
+    ADBStats::ScopedTimer timer(ADBStats::PROCESS_RUN_US);
     pid_t pid = forkpty(&master_fd, nullptr, nullptr, &win);
     if (pid < 0) return "";
 
@@ -800,15 +1092,13 @@ std::string ADBShell::runAdbProcessWithPty(const std::vector<std::string>& args,
 
     int status = 0;
     waitpid(pid, &status, 0);
-    _last_pty_exit.store(WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+    if (exit_status) *exit_status = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
     ADBUtils::TrimTrailingNewlines(output);
     return output;
 }
 
-std::atomic<int> ADBShell::_last_pty_exit{-1};
-
-std::string ADBShell::adbExecWithProgress(const std::vector<std::string>& args, const std::function<void(const std::string&)>& on_chunk, const std::function<bool()>& abort_check) {
-    return runAdbProcessWithPty(args, on_chunk, abort_check);
+std::string ADBShell::adbExecWithProgress(const std::vector<std::string>& args, const std::function<void(const std::string&)>& on_chunk, const std::function<bool()>& abort_check, int* exit_status) {
+    return runAdbProcessWithPty(args, on_chunk, abort_check, exit_status);
 }
 
 // Instance version for device-specific ADB commands with -s <device_serial>
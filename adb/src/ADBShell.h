@@ -8,6 +8,9 @@
 #include <mutex>
 #include <vector>
 #include <functional>
+#include <string_view>
+#include <deque>
+#include <future>
 
 
 class ADBShell {
@@ -21,22 +24,34 @@ public:
     
     // Start the ADB shell process
     bool start();
-    // Execute a command and return the output
-    std::string shellCommand(const std::string& command);
+    // Execute a command and return the output; exit_code (when given) gets its exit code, -1 on timeout / broken session.
+    std::string shellCommand(const std::string& command, int* exit_code = nullptr);
+    // Line-at-a-time variant: each output line (no EOL) goes to on_line as it arrives; the view is valid only during the call.
+    // Lines over 1 MiB arrive in several pieces, so memory stays bounded whatever the command prints.
+    // abort_check → shell is torn down (restarted by the next command). false on timeout / abort / broken session.
+    using LineFn = std::function<void(std::string_view)>;
+    bool shellCommandLines(const std::string& command, const LineFn& on_line,
+                           const std::function<bool()>& abort_check = {}, int* exit_code = nullptr);
+
+    struct Reply {
+        std::string output;
+        int exit_code = -1;  // -1: timeout / broken session
+    };
+    // Pipelined: the command is written now, replies are read back in order (demuxed by marker) when a future is waited on
+    // or the next synchronous command runs. For small-output probes; futures must not outlive this ADBShell.
+    std::shared_future<Reply> shellCommandAsync(const std::string& command);
     // Execute a device-specific ADB command with -s <device_serial> - instance version
     std::string adbCommand(const std::string& command) const;
     // Execute a global ADB command (e.g., "adb devices -l") - static version
     static std::string adbExec(const std::string& command);
     static std::string adbExec(const std::vector<std::string>& args);
     static std::string adbExec(const std::vector<std::string>& args, const std::function<void(const std::string&)>& on_chunk);
-    static std::string adbExecWithProgress(const std::vector<std::string>& args, const std::function<void(const std::string&)>& on_chunk, const std::function<bool()>& abort_check = {});
+    // exit_status (when given) gets the child's exit code; -1 if it died on a signal.
+    static std::string adbExecWithProgress(const std::vector<std::string>& args, const std::function<void(const std::string&)>& on_chunk, const std::function<bool()>& abort_check = {}, int* exit_status = nullptr);
     // Stop the shell process
     void stop();
-
-    // Exit code from most recent shellCommand's END marker; -1 if unparseable (timeout / broken session).
-    int lastExitCode() const { return _last_exit_code.load(); }
-    // Exit code of the most recent adbExecWithProgress() child process; -1 if unset / signal.
-    static int lastPtyExit() { return _last_pty_exit.load(); }
+    // false once the session died (EOF / broken pipe) or was stopped; the next command would restart it.
+    bool isRunning() const { return _is_running; }
 
 private:
     std::string _device_serial;
@@ -45,11 +60,50 @@ private:
     int _shell_pid;
     bool _is_running;
     std::string _last_error;
-    std::atomic<int> _last_exit_code{-1};
-    static std::atomic<int> _last_pty_exit;
-
     // Serializes shellCommand: write+read is one transaction, else callers cross-corrupt the pipe pair.
     std::mutex _shell_mutex;
+    // Exit code parsed from the END marker of the reply read last; only meaningful under _shell_mutex,
+    // so callers get it through shellCommand's exit_code rather than reading it afterwards.
+    int _last_exit_code = -1;
+
+    // Pipelined commands written but not yet read back, oldest first. Bounded so the shell's stdout pipe can't fill
+    // while we're still writing (it would stop reading stdin → both sides block).
+    struct ReplySlot {
+        bool done = false;
+        Reply reply;
+    };
+    struct PendingReply {
+        std::string marker;
+        std::shared_ptr<ReplySlot> slot;
+    };
+    static constexpr size_t kMaxInFlight = 32;
+    std::deque<PendingReply> _pending;
+
+    // Receive buffer kept across commands: read() lands straight in its tail and replies are parsed in place, so a big
+    // `cat` / `ls -la` is neither re-appended chunk by chunk nor split into a copy per line. Consumed bytes only move
+    // the head; the unread rest is compacted to the front when the tail runs out of room.
+    class RxBuffer {
+    public:
+        std::string_view view() const { return std::string_view(_buf.get() + _head, _tail - _head); }
+        bool empty() const { return _head == _tail; }
+        void consume(size_t n);
+        // Drops buffered bytes; memory beyond kKeepCapacity (left by one huge reply) goes back to the heap.
+        void clear();
+        // One read() into the tail. Read size doubles while reads fill it (a big reply is streaming) up to kMaxRead.
+        ssize_t readFrom(int fd);
+
+    private:
+        static constexpr size_t kMinRead = 16 * 1024;
+        static constexpr size_t kMaxRead = 1024 * 1024;
+        static constexpr size_t kKeepCapacity = 4 * kMaxRead;
+        std::unique_ptr<char[]> _buf;
+        size_t _capacity = 0;
+        size_t _head = 0;
+        size_t _tail = 0;
+        size_t _read_size = kMinRead;
+    };
+    // Bytes past the last consumed END marker belong to the next (pipelined) reply and stay here.
+    RxBuffer _rx;
 
     // Session management
     std::atomic<uint32_t> _command_counter;
@@ -58,9 +112,17 @@ private:
     static std::string findAdbExecutable();
     static std::vector<std::string> splitCommandArgs(const std::string& command);
     static std::string runAdbProcess(const std::vector<std::string>& args, const std::function<void(const std::string&)>* on_chunk = nullptr);
-    static std::string runAdbProcessWithPty(const std::vector<std::string>& args, const std::function<void(const std::string&)>& on_chunk, const std::function<bool()>& abort_check = {});
+    static std::string runAdbProcessWithPty(const std::vector<std::string>& args, const std::function<void(const std::string&)>& on_chunk, const std::function<bool()>& abort_check, int* exit_status);
+    // start()/stop() bodies, for callers already holding _shell_mutex.
+    bool startLocked();
+    void stopLocked();
     std::string generateMarker();
     bool writeCommand(const std::string& command, const std::string& marker);
     std::string readResponse(const std::string& marker);
+    bool readResponseLines(const std::string& marker, const LineFn& on_line,
+                           const std::function<bool()>& abort_check);
     void setError(const std::string& error);
+    void readNextPendingLocked();
+    void drainPendingLocked();
+    void failPendingLocked();
 };
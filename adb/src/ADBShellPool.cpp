@@ -0,0 +1,133 @@
+#include "ADBShellPool.h"
+#include "ADBShell.h"
+#include "ADBLog.h"
+#include "ADBStats.h"
+#include <map>
+#include <chrono>
+
+std::shared_ptr<ADBShellPool> ADBShellPool::ForDevice(const std::string& device_serial)
+{
+    static std::mutex s_registry_mutex;
+    static std::map<std::string, std::weak_ptr<ADBShellPool>> s_registry;
+
+    std::lock_guard<std::mutex> lock(s_registry_mutex);
+    auto& slot = s_registry[device_serial];
+    auto pool = slot.lock();
+    if (!pool) {
+        pool = std::make_shared<ADBShellPool>(device_serial);
+        slot = pool;
+    }
+    return pool;
+}
+
+ADBShellPool::Lease::Lease(std::shared_ptr<ADBShellPool> pool, std::unique_ptr<ADBShell> shell)
+    : _pool(std::move(pool)), _shell(std::move(shell))
+{
+}
+
+ADBShellPool::Lease::~Lease()
+{
+    if (_pool && _shell) _pool->Release(std::move(_shell));
+}
+
+ADBShellPool::ADBShellPool(const std::string& device_serial)
+    : _device_serial(device_serial)
+{
+}
+
+ADBShellPool::~ADBShellPool()
+{
+    PurgeAll();
+    WaitThread();
+}
+
+ADBShellPool::Lease ADBShellPool::Acquire(const std::shared_ptr<ADBShellPool>& pool)
+{
+    std::unique_ptr<ADBShell> shell;
+    {
+        std::lock_guard<std::mutex> lock(pool->_mutex);
+        if (!pool->_idle.empty()) {
+            // Most recently used first: the oldest ones are left to expire.
+            shell = std::move(pool->_idle.back().shell);
+            pool->_idle.pop_back();
+        }
+    }
+    if (!shell) {
+        shell = std::make_unique<ADBShell>(pool->_device_serial);
+        if (!shell->start()) return Lease();
+        ADBStats::Add(ADBStats::POOL_STARTS);
+        DBG("new pooled shell for '%s'\n", pool->_device_serial.c_str());
+    } else {
+        ADBStats::Add(ADBStats::POOL_REUSES);
+    }
+    return Lease(pool, std::move(shell));
+}
+
+void ADBShellPool::Release(std::unique_ptr<ADBShell> shell)
+{
+    if (!shell->isRunning()) return;
+
+    std::vector<std::unique_ptr<ADBShell>> purgeds; // stop shells out of lock
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_purging || _idle.size() >= kMaxIdle) {
+        purgeds.emplace_back(std::move(shell));
+        return;
+    }
+    _idle.push_back(IdleShell{time(nullptr), std::move(shell)});
+    PurgeExpired(purgeds);
+    UpdateThreadState();
+}
+
+void ADBShellPool::PurgeAll()
+{
+    std::vector<std::unique_ptr<ADBShell>> purgeds; // stop shells out of lock
+    std::lock_guard<std::mutex> lock(_mutex);
+    _purging = true;
+    for (auto& idle : _idle) purgeds.emplace_back(std::move(idle.shell));
+    _idle.clear();
+    _cond.notify_all();
+}
+
+void ADBShellPool::PurgeExpired(std::vector<std::unique_ptr<ADBShell>>& purgeds)
+{
+    const time_t now = time(nullptr);
+    for (auto it = _idle.begin(); it != _idle.end(); ) {
+        if (now - it->ts >= kExpirationSec || it->ts > now) {
+            purgeds.emplace_back(std::move(it->shell));
+            it = _idle.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void *ADBShellPool::ThreadProc()
+{
+    std::vector<std::unique_ptr<ADBShell>> purgeds;
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_idle.empty()) {
+        // _idle is in release order, so the front one expires first.
+        const time_t age = time(nullptr) - _idle.front().ts;
+        const time_t sleep_time = (age >= 0 && age < kExpirationSec) ? kExpirationSec - age : 0;
+        _cond.wait_for(lock, std::chrono::seconds(sleep_time + 1));
+
+        PurgeExpired(purgeds);
+        if (!purgeds.empty()) {
+            DBG("reaped %zu idle shell(s) for '%s'\n", purgeds.size(), _device_serial.c_str());
+            lock.unlock();
+            purgeds.clear();
+            lock.lock();
+        }
+    }
+    return nullptr;
+}
+
+void ADBShellPool::UpdateThreadState()
+{
+    if (!_idle.empty()) {
+        if (StartThread()) {
+            return;
+        }
+    }
+    _cond.notify_all();
+}
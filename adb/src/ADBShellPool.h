@@ -0,0 +1,68 @@
+#pragma once
+
+// Standard library includes
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <time.h>
+
+#include <Threaded.h>
+
+class ADBShell;
+
+// Warm `adb shell` sessions per device, leased per operation so slow background commands (find, cp -a, rm -rf)
+// don't queue behind — or block — the device's primary, cwd-bearing session used for browsing.
+// Idle sessions are reaped after kExpirationSec, same scheme as NetRocks' ConnectionsPool.
+class ADBShellPool : Threaded {
+public:
+    static constexpr time_t kExpirationSec = 30;
+    static constexpr size_t kMaxIdle = 4;
+
+    static std::shared_ptr<ADBShellPool> ForDevice(const std::string& device_serial);
+
+    // Exclusive use of one session; returned to the pool on destruction unless it broke.
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(std::shared_ptr<ADBShellPool> pool, std::unique_ptr<ADBShell> shell);
+        Lease(Lease&&) = default;
+        Lease& operator=(Lease&&) = default;
+        ~Lease();
+
+        ADBShell* operator->() const { return _shell.get(); }
+        ADBShell& operator*() const { return *_shell; }
+        explicit operator bool() const { return !!_shell; }
+
+    private:
+        std::shared_ptr<ADBShellPool> _pool;
+        std::unique_ptr<ADBShell> _shell;
+    };
+
+    explicit ADBShellPool(const std::string& device_serial);
+    virtual ~ADBShellPool();
+
+    // Idle session if any, else a freshly started one; empty Lease if the shell can't be started.
+    static Lease Acquire(const std::shared_ptr<ADBShellPool>& pool);
+    void PurgeAll();
+
+protected:
+    virtual void *ThreadProc();
+
+private:
+    struct IdleShell {
+        time_t ts;
+        std::unique_ptr<ADBShell> shell;
+    };
+
+    std::string _device_serial;
+    std::vector<IdleShell> _idle;
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    bool _purging = false;
+
+    void Release(std::unique_ptr<ADBShell> shell);
+    void PurgeExpired(std::vector<std::unique_ptr<ADBShell>>& purgeds);
+    void UpdateThreadState();
+};
@@ -0,0 +1,1071 @@
+// Local includes
+#include "ADBSocket.h"
+#include "ADBDevice.h"
+#include "ADBMd5.h"
+#include "ADBLog.h"
+#include "ADBStats.h"
+
+// Standard library includes
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+
+// System includes
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <dirent.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+#ifdef HAVE_BROTLI
+#include <brotli/decode.h>
+#include <brotli/encode.h>
+#endif
+
+// Wire constants from adb's file_sync_protocol.h — v1 records are 32-bit, v2 (stat_v2/ls_v2 features) carry 64-bit size/mtime.
+static constexpr size_t kSyncDataMax = 64 * 1024;
+static constexpr size_t kSyncPathMax = 1024;
+static constexpr size_t kStatV1Size = 16;
+static constexpr size_t kStatV2Size = 72;
+static constexpr size_t kDentV1Size = 20;
+static constexpr size_t kDentV2Size = 76;
+// sendrecv_v2 setup record flags; only brotli is implemented (devices advertising lz4/zstd advertise brotli too).
+static constexpr uint32_t kSyncFlagBrotli = 1;
+// Below this a compressed stream saves less than its own setup costs.
+static constexpr uint64_t kCompressMinSize = 4096;
+// Pulls this large go through a part file that survives a dropped link.
+static constexpr uint64_t kResumeMinSize = 16ull << 20;
+static constexpr const char* kPartSuffix = ".adbpart";
+// Resume offsets are rounded down to whole blocks of the device-side `dd bs=`.
+static constexpr uint64_t kResumeBlock = 64 * 1024;
+// Automatic resume attempts after a dropped link, with 1 s, 2 s, 4 s pauses for the device to come back.
+static constexpr int kResumeRetries = 3;
+// Device-side md5sum of a multi-GB file is slow and silent until the end.
+static constexpr int kHashTimeoutMs = 10 * 60 * 1000;
+// Same budget as ADBShell's marker read — a silent server for this long means the session is gone.
+static constexpr int kIdleTimeoutMs = 30000;
+// Shell protocol v2 packet ids (adb's shell_protocol.h) and the stdin chunk we send per packet.
+enum : uint8_t { kShellStdin = 0, kShellStdout = 1, kShellStderr = 2, kShellExit = 3, kShellCloseStdin = 4 };
+static constexpr size_t kShellChunk = 16 * 1024;
+static constexpr size_t kShellStderrMax = 64 * 1024;
+// Abort-check granularity while blocked on the socket.
+static constexpr int kPollSliceMs = 200;
+
+static uint32_t GetLe32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t GetLe64(const unsigned char* p) {
+    return (uint64_t)GetLe32(p) | ((uint64_t)GetLe32(p + 4) << 32);
+}
+
+static void PutLe32(unsigned char* p, uint32_t v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+static bool WriteFull(int fd, const void* buf, size_t len) {
+    const char* p = (const char*)buf;
+    while (len > 0) {
+#ifdef MSG_NOSIGNAL
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+#else
+        ssize_t n = send(fd, p, len, 0);
+#endif
+        if (n > 0) {
+            p += (size_t)n;
+            len -= (size_t)n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        return false;
+    }
+    return true;
+}
+
+static bool ReadFull(int fd, void* buf, size_t len, const ADBSocket::AbortFn& abort_check) {
+    char* p = (char*)buf;
+    int idle_ms = 0;
+    while (len > 0) {
+        if (abort_check && abort_check()) return false;
+        struct pollfd pfd{};
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        int pr = poll(&pfd, 1, kPollSliceMs);
+        if (pr == 0) {
+            idle_ms += kPollSliceMs;
+            if (idle_ms >= kIdleTimeoutMs) return false;
+            continue;
+        }
+        if (pr < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        ssize_t n = recv(fd, p, len, 0);
+        if (n > 0) {
+            p += (size_t)n;
+            len -= (size_t)n;
+            idle_ms = 0;
+            continue;
+        }
+        if (n < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+        return false;
+    }
+    return true;
+}
+
+// Reads a 4-hex-digit length prefixed payload (smart-socket reply body).
+static bool ReadHexBlock(int fd, std::string& out) {
+    char hex[5] = {0};
+    if (!ReadFull(fd, hex, 4, {})) return false;
+    char* end = nullptr;
+    unsigned long len = strtoul(hex, &end, 16);
+    if (end != hex + 4) return false;
+    out.resize(len);
+    return len == 0 || ReadFull(fd, &out[0], len, {});
+}
+
+static int WriteAllFd(int fd, const void* buf, size_t len) {
+    const char* p = (const char*)buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n > 0) { p += n; len -= (size_t)n; continue; }
+        if (n < 0 && errno == EINTR) continue;
+        return errno ? errno : EIO;
+    }
+    return 0;
+}
+
+// Reads fd until EOF, handing each chunk to sink (non-zero return stops with that errno); EIO on idle timeout/error.
+static int ReadToEof(int fd, const std::function<int(const char*, size_t)>& sink,
+                     const ADBSocket::AbortFn& abort_check, int idle_timeout_ms) {
+    std::vector<char> buf(kSyncDataMax);
+    int idle_ms = 0;
+    for (;;) {
+        if (abort_check && abort_check()) return ECANCELED;
+        struct pollfd pfd{};
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        int pr = poll(&pfd, 1, kPollSliceMs);
+        if (pr == 0) {
+            idle_ms += kPollSliceMs;
+            if (idle_ms >= idle_timeout_ms) return EIO;
+            continue;
+        }
+        if (pr < 0) {
+            if (errno == EINTR) continue;
+            return EIO;
+        }
+        ssize_t n = recv(fd, buf.data(), buf.size(), 0);
+        if (n == 0) return 0;
+        if (n < 0) {
+            if (errno == EINTR || errno == EAGAIN) continue;
+            return EIO;
+        }
+        idle_ms = 0;
+        if (int rc = sink(buf.data(), (size_t)n)) return rc;
+    }
+}
+
+// Byte offset an earlier pull's part file can be continued from; 0 = start over. The part is stamped with the
+// device file's mtime when it is left behind, so a part of some other/changed file is never continued.
+static uint64_t ResumeOffset(const std::string& part, const ADBSocket::Entry& st) {
+    struct stat pst{};
+    if (::stat(part.c_str(), &pst) != 0 || !S_ISREG(pst.st_mode)) return 0;
+    if ((int64_t)pst.st_mtime != st.mtime || (uint64_t)pst.st_size > st.size) return 0;
+    return ((uint64_t)pst.st_size / kResumeBlock) * kResumeBlock;
+}
+
+static int HashPrefix(int fd, uint64_t len, ADBMd5& md5) {
+    std::vector<char> buf(kSyncDataMax);
+    uint64_t done = 0;
+    while (done < len) {
+        const size_t want = (size_t)std::min<uint64_t>(buf.size(), len - done);
+        ssize_t n = pread(fd, buf.data(), want, (off_t)done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return n < 0 ? errno : EIO;
+        md5.Update(buf.data(), (size_t)n);
+        done += (uint64_t)n;
+    }
+    return 0;
+}
+
+static std::atomic<bool> s_verify_default{false};
+
+void ADBSocket::SetVerifyDefault(bool on) {
+    s_verify_default = on;
+}
+
+// FAR2L_ADB_VERIFY: "1"/"on"/"yes" or anything else; unset means the setting.
+static bool VerifyWanted() {
+    const char* env = getenv("FAR2L_ADB_VERIFY");
+    if (!env) return s_verify_default;
+    return strcmp(env, "1") == 0 || strcmp(env, "on") == 0 || strcmp(env, "yes") == 0;
+}
+
+static std::atomic<bool> s_compress_default{true};
+
+void ADBSocket::SetCompressDefault(bool on) {
+    s_compress_default = on;
+}
+
+#ifdef HAVE_BROTLI
+// FAR2L_ADB_COMPRESS: comma list of "on"/"off" (all devices) and "<serial>=on|off" overrides; unset means the setting.
+static bool CompressionWanted(const std::string& device_serial) {
+    const char* env = getenv("FAR2L_ADB_COMPRESS");
+    if (!env) return s_compress_default;
+    const std::string list(env);
+    bool wanted = s_compress_default, per_device = false;
+    size_t pos = 0;
+    while (pos <= list.size()) {
+        size_t comma = list.find(',', pos);
+        if (comma == std::string::npos) comma = list.size();
+        std::string value = list.substr(pos, comma - pos), who;
+        pos = comma + 1;
+        const size_t eq = value.rfind('=');
+        if (eq != std::string::npos) {
+            who = value.substr(0, eq);
+            value.erase(0, eq + 1);
+        }
+        const bool on = !(value == "0" || value == "off" || value == "no");
+        if (!who.empty()) {
+            if (who == device_serial) { wanted = on; per_device = true; }
+        } else if (!per_device) {
+            wanted = on;
+        }
+    }
+    return wanted;
+}
+#endif
+
+static int MkdirPLocal(const std::string& path) {
+    if (path.empty()) return 0;
+    for (size_t i = 1; i <= path.size(); ++i) {
+        if (i == path.size() || path[i] == '/') {
+            std::string cur = path.substr(0, i);
+            struct stat st{};
+            if (::stat(cur.c_str(), &st) == 0) {
+                if (!S_ISDIR(st.st_mode)) return ENOTDIR;
+            } else if (mkdir(cur.c_str(), 0755) != 0 && errno != EEXIST) {
+                return errno;
+            }
+        }
+    }
+    return 0;
+}
+
+ADBSocket::ADBSocket(const std::string& device_serial)
+    : _device_serial(device_serial)
+    , _fd(-1)
+    , _features_known(false)
+    , _stat_v2(false)
+    , _ls_v2(false)
+    , _brotli(false)
+    , _shell_v2(false)
+{
+}
+
+ADBSocket::~ADBSocket() {
+    close();
+}
+
+void ADBSocket::close() {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+// ADB_SERVER_SOCKET=tcp:[host:]port and ANDROID_ADB_SERVER_PORT follow the adb binary's own conventions, so a fake server can be swapped in.
+int ADBSocket::connectServer() {
+    std::string host = "127.0.0.1";
+    std::string port = "5037";
+    const char* spec = getenv("ADB_SERVER_SOCKET");
+    if (spec && *spec) {
+        if (strncmp(spec, "tcp:", 4) != 0) {
+            DBG("unsupported ADB_SERVER_SOCKET='%s' — using adb binary\n", spec);
+            return -1;
+        }
+        std::string rest = spec + 4;
+        size_t colon = rest.rfind(':');
+        if (colon == std::string::npos) {
+            port = rest;
+        } else {
+            host = rest.substr(0, colon);
+            port = rest.substr(colon + 1);
+        }
+    } else if (const char* env_port = getenv("ANDROID_ADB_SERVER_PORT")) {
+        if (*env_port) port = env_port;
+    }
+
+    struct addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* res = nullptr;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) != 0 || !res) {
+        return -1;
+    }
+    ADBStats::ScopedTimer timer(ADBStats::SOCKET_CONNECT_US);
+    int fd = -1;
+    for (struct addrinfo* ai = res; ai; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+        ::close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    if (fd < 0) {
+        ADBStats::Add(ADBStats::SOCKET_CONNECT_FAILURES);
+        return -1;
+    }
+    ADBStats::Add(ADBStats::SOCKET_CONNECTS);
+
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+#ifdef SO_NOSIGPIPE
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    return fd;
+}
+
+bool ADBSocket::sendRequest(int fd, const std::string& service) {
+    char hex[5];
+    snprintf(hex, sizeof(hex), "%04zx", service.size());
+    std::string req = std::string(hex, 4) + service;
+    return WriteFull(fd, req.data(), req.size());
+}
+
+bool ADBSocket::readStatus(int fd, std::string* fail_message) {
+    char status[4];
+    if (!ReadFull(fd, status, 4, {})) return false;
+    if (memcmp(status, "OKAY", 4) == 0) return true;
+    if (memcmp(status, "FAIL", 4) == 0) {
+        std::string msg;
+        ReadHexBlock(fd, msg);
+        DBG("server FAIL: %s\n", msg.c_str());
+        if (fail_message) *fail_message = msg;
+    }
+    return false;
+}
+
+bool ADBSocket::hostQuery(const std::string& service, std::string& out) {
+    int fd = connectServer();
+    if (fd < 0) return false;
+    bool ok = sendRequest(fd, service) && readStatus(fd) && ReadHexBlock(fd, out);
+    ::close(fd);
+    return ok;
+}
+
+bool ADBSocket::trackDevices(const std::function<void(const std::string&)>& on_list, const AbortFn& abort_check) {
+    int fd = connectServer();
+    if (fd < 0) return false;
+    if (!sendRequest(fd, "host:track-devices") || !readStatus(fd)) {
+        ::close(fd);
+        return false;
+    }
+    // The stream is silent between changes for as long as nothing is plugged in — no idle timeout here.
+    std::string list;
+    for (;;) {
+        struct pollfd pfd{};
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        const int pr = poll(&pfd, 1, kPollSliceMs);
+        if (abort_check && abort_check()) break;
+        if (pr == 0 || (pr < 0 && errno == EINTR)) continue;
+        if (pr < 0 || !ReadHexBlock(fd, list)) break;
+        on_list(list);
+    }
+    ::close(fd);
+    return true;
+}
+
+void ADBSocket::queryFeatures() {
+    if (_features_known) return;
+    std::string features;
+    const std::string service = _device_serial.empty()
+        ? std::string("host:features")
+        : "host-serial:" + _device_serial + ":features";
+    if (!hostQuery(service, features)) return;
+    // Comma-separated list; match whole tokens only ("ls_v2" must not hit "xls_v2").
+    auto has = [&](const char* name) {
+        size_t pos = 0;
+        const size_t len = strlen(name);
+        while ((pos = features.find(name, pos)) != std::string::npos) {
+            const bool starts = (pos == 0 || features[pos - 1] == ',');
+            const bool ends = (pos + len == features.size() || features[pos + len] == ',');
+            if (starts && ends) return true;
+            pos += len;
+        }
+        return false;
+    };
+    _stat_v2 = has("stat_v2");
+    _ls_v2 = has("ls_v2");
+    _shell_v2 = has("shell_v2");
+#ifdef HAVE_BROTLI
+    _brotli = has("sendrecv_v2") && has("sendrecv_v2_brotli") && CompressionWanted(_device_serial);
+#endif
+    _features_known = true;
+    DBG("features stat_v2=%d ls_v2=%d shell_v2=%d brotli=%d\n", _stat_v2, _ls_v2, _shell_v2, _brotli);
+}
+
+int ADBSocket::openService(const std::string& service) {
+    int fd = connectServer();
+    if (fd < 0) return -1;
+    const std::string transport = _device_serial.empty()
+        ? std::string("host:transport-any")
+        : "host:transport:" + _device_serial;
+    if (!sendRequest(fd, transport) || !readStatus(fd)
+        || !sendRequest(fd, service) || !readStatus(fd)) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool ADBSocket::ensureSession() {
+    if (_fd >= 0) return true;
+    queryFeatures();
+    _fd = openService("sync:");
+    return _fd >= 0;
+}
+
+bool ADBSocket::sendPacket(const char id[4], const void* data, size_t len) {
+    unsigned char hdr[8];
+    memcpy(hdr, id, 4);
+    PutLe32(hdr + 4, (uint32_t)len);
+    if (!WriteFull(_fd, hdr, sizeof(hdr)) || (len > 0 && !WriteFull(_fd, data, len))) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool ADBSocket::readExact(void* buf, size_t len, const AbortFn& abort_check) {
+    if (!ReadFull(_fd, buf, len, abort_check)) {
+        // Mid-packet state is unknowable; drop the session so the next request starts clean.
+        close();
+        return false;
+    }
+    return true;
+}
+
+int ADBSocket::readFail(uint32_t len) {
+    std::string msg(len, '\0');
+    if (len > 0 && !readExact(&msg[0], len)) return EIO;
+    DBG("sync FAIL: %s\n", msg.c_str());
+    return ADBDevice::Str2Errno(msg);
+}
+
+int ADBSocket::statLocked(const std::string& path, Entry& out) {
+    if (path.size() > kSyncPathMax) return ENAMETOOLONG;
+    unsigned char buf[kStatV2Size];
+    if (_stat_v2) {
+        if (!sendPacket("STA2", path.data(), path.size()) || !readExact(buf, kStatV2Size)) return kUnavailable;
+        if (memcmp(buf, "STA2", 4) != 0) { close(); return kUnavailable; }
+        if (uint32_t err = GetLe32(buf + 4)) return (int)err;
+        out.mode = GetLe32(buf + 24);
+        out.size = GetLe64(buf + 40);
+        out.mtime = (int64_t)GetLe64(buf + 56);
+    } else {
+        if (!sendPacket("STAT", path.data(), path.size()) || !readExact(buf, kStatV1Size)) return kUnavailable;
+        if (memcmp(buf, "STAT", 4) != 0) { close(); return kUnavailable; }
+        out.mode = GetLe32(buf + 4);
+        out.size = GetLe32(buf + 8);
+        out.mtime = GetLe32(buf + 12);
+        // v1 reports a missing path as an all-zero record.
+        if (out.mode == 0) return ENOENT;
+    }
+    out.name = ADBUtils::PathBasename(path);
+    return 0;
+}
+
+int ADBSocket::statPath(const std::string& path, Entry& out) {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    if (!ensureSession()) return kUnavailable;
+    return statLocked(path, out);
+}
+
+int ADBSocket::listLocked(const std::string& path, std::vector<Entry>& out) {
+    if (path.size() > kSyncPathMax) return ENAMETOOLONG;
+    const bool v2 = _ls_v2;
+    if (!sendPacket(v2 ? "LIS2" : "LIST", path.data(), path.size())) return kUnavailable;
+    const size_t rec_size = v2 ? kDentV2Size : kDentV1Size;
+    unsigned char buf[kDentV2Size];
+    for (;;) {
+        if (!readExact(buf, rec_size)) return EIO;
+        if (memcmp(buf, "DONE", 4) == 0) break;
+        if (memcmp(buf, v2 ? "DNT2" : "DENT", 4) != 0) { close(); return EIO; }
+        Entry e;
+        uint32_t namelen;
+        if (v2) {
+            e.mode = GetLe32(buf + 24);
+            e.size = GetLe64(buf + 40);
+            e.mtime = (int64_t)GetLe64(buf + 56);
+            namelen = GetLe32(buf + 72);
+        } else {
+            e.mode = GetLe32(buf + 4);
+            e.size = GetLe32(buf + 8);
+            e.mtime = GetLe32(buf + 12);
+            namelen = GetLe32(buf + 16);
+        }
+        if (namelen > kSyncPathMax) { close(); return EIO; }
+        e.name.resize(namelen);
+        if (namelen > 0 && !readExact(&e.name[0], namelen)) return EIO;
+        if (e.name == "." || e.name == "..") continue;
+        out.push_back(std::move(e));
+    }
+    return 0;
+}
+
+int ADBSocket::listDir(const std::string& path, std::vector<Entry>& out) {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    if (!ensureSession()) return kUnavailable;
+    return listLocked(path, out);
+}
+
+// Whole file over sync RECV (RCV2 + brotli when negotiated) into out_fd from its current position.
+int ADBSocket::recvData(const std::string& remote, int out_fd, const Entry& st, ADBMd5* md5,
+                        const ProgressFn& on_progress, const AbortFn& abort_check, const WireFn& on_wire) {
+#ifdef HAVE_BROTLI
+    // One brotli stream per file, spanning as many DATA packets as the device needs.
+    std::unique_ptr<BrotliDecoderState, void (*)(BrotliDecoderState*)> decoder(nullptr, BrotliDecoderDestroyInstance);
+    if (_brotli && st.size >= kCompressMinSize) {
+        decoder.reset(BrotliDecoderCreateInstance(nullptr, nullptr, nullptr));
+    }
+    const bool compressed = !!decoder;
+#else
+    const bool compressed = false;
+#endif
+    bool sent;
+    if (compressed) {
+        unsigned char setup[8];
+        memcpy(setup, "RCV2", 4);
+        PutLe32(setup + 4, kSyncFlagBrotli);
+        sent = sendPacket("RCV2", remote.data(), remote.size()) && WriteFull(_fd, setup, sizeof(setup));
+        if (!sent) close();
+    } else {
+        sent = sendPacket("RECV", remote.data(), remote.size());
+    }
+    if (!sent) return EIO;
+
+    std::vector<char> data(kSyncDataMax);
+    std::vector<char> plain(compressed ? kSyncDataMax : 0);
+    uint64_t done = 0;
+    int last_pct = 0;
+    int rc = 0;
+    auto put = [&](const char* p, size_t n) {
+        if (md5) md5->Update(p, n);
+        return WriteAllFd(out_fd, p, n);
+    };
+    for (;;) {
+        unsigned char hdr[8];
+        if (!readExact(hdr, sizeof(hdr), abort_check)) {
+            rc = (abort_check && abort_check()) ? ECANCELED : EIO;
+            break;
+        }
+        const uint32_t len = GetLe32(hdr + 4);
+        if (memcmp(hdr, "DONE", 4) == 0) {
+#ifdef HAVE_BROTLI
+            if (compressed && !BrotliDecoderIsFinished(decoder.get())) rc = EBADMSG;
+#endif
+            break;
+        }
+        if (memcmp(hdr, "FAIL", 4) == 0) { rc = readFail(len); break; }
+        if (memcmp(hdr, "DATA", 4) != 0 || len > kSyncDataMax) { close(); rc = EIO; break; }
+        if (!readExact(data.data(), len, abort_check)) {
+            rc = (abort_check && abort_check()) ? ECANCELED : EIO;
+            break;
+        }
+        uint64_t produced = len;
+        if (!compressed) {
+            rc = put(data.data(), len);
+        }
+#ifdef HAVE_BROTLI
+        else {
+            produced = 0;
+            const uint8_t* in = (const uint8_t*)data.data();
+            size_t avail_in = len;
+            for (;;) {
+                uint8_t* out = (uint8_t*)plain.data();
+                size_t avail_out = plain.size();
+                const BrotliDecoderResult r = BrotliDecoderDecompressStream(
+                    decoder.get(), &avail_in, &in, &avail_out, &out, nullptr);
+                const size_t n = plain.size() - avail_out;
+                if (n > 0) {
+                    rc = put(plain.data(), n);
+                    produced += n;
+                }
+                // Corrupt stream, not a dropped link: resuming would only append to bad data.
+                if (r == BROTLI_DECODER_RESULT_ERROR) rc = EBADMSG;
+                if (rc != 0 || r != BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT) break;
+            }
+            if (on_wire) on_wire(produced, len);
+        }
+#endif
+        if (rc != 0) {
+            // Rest of the stream is still in flight; the session can't be reused.
+            close();
+            break;
+        }
+        done += produced;
+        if (on_progress && st.size > 0) {
+            int pct = (int)((done * 100) / st.size);
+            if (pct > 100) pct = 100;
+            if (pct != last_pct) { last_pct = pct; on_progress(pct, remote); }
+        }
+    }
+    return rc;
+}
+
+// Rest of the file from `offset` (a kResumeBlock multiple) — sync RECV has no offset, so `dd skip=` over exec:.
+int ADBSocket::recvTail(const std::string& remote, int out_fd, const Entry& st, uint64_t offset, ADBMd5* md5,
+                        const ProgressFn& on_progress, const AbortFn& abort_check) {
+    const int fd = openService("exec:dd if=" + ADBUtils::ShellQuote(remote) + " bs=" + std::to_string(kResumeBlock)
+                               + " skip=" + std::to_string(offset / kResumeBlock) + " 2>/dev/null");
+    if (fd < 0) return EIO;
+    uint64_t done = offset;
+    int last_pct = -1;
+    int rc = ReadToEof(fd, [&](const char* p, size_t n) {
+        if (md5) md5->Update(p, n);
+        if (int err = WriteAllFd(out_fd, p, n)) return err;
+        done += n;
+        if (on_progress && st.size > 0) {
+            int pct = (int)((done * 100) / st.size);
+            if (pct > 100) pct = 100;
+            if (pct != last_pct) { last_pct = pct; on_progress(pct, remote); }
+        }
+        return 0;
+    }, abort_check, kIdleTimeoutMs);
+    ::close(fd);
+    // exec: has no status channel — a short stream is the only sign the link (or dd) died.
+    if (rc == 0 && done != st.size) rc = EIO;
+    DBG("resume '%s' from %llu: got %llu of %llu rc=%d\n", remote.c_str(), (unsigned long long)offset,
+        (unsigned long long)done, (unsigned long long)st.size, rc);
+    return rc;
+}
+
+// Device-side md5sum vs the digest of what was written/sent; a device without md5sum is not an error.
+int ADBSocket::verifyRemote(const std::string& remote, ADBMd5& md5, const AbortFn& abort_check) {
+    const std::string local_hex = md5.HexDigest();
+    const int fd = openService("exec:md5sum " + ADBUtils::ShellQuote(remote) + " 2>/dev/null");
+    if (fd < 0) return 0;
+    std::string out;
+    int rc = ReadToEof(fd, [&](const char* p, size_t n) { out.append(p, n); return 0; }, abort_check, kHashTimeoutMs);
+    ::close(fd);
+    if (rc == ECANCELED) return rc;
+    if (rc != 0 || out.size() < 32) {
+        DBG("verify '%s': no usable md5sum output (rc=%d) — skipped\n", remote.c_str(), rc);
+        return 0;
+    }
+    if (out.compare(0, 32, local_hex) != 0) {
+        DBG("verify '%s': MISMATCH device=%.32s host=%s\n", remote.c_str(), out.c_str(), local_hex.c_str());
+        return EIO;
+    }
+    return 0;
+}
+
+int ADBSocket::recvFile(const std::string& remote, const std::string& local, const Entry& st,
+                        const ProgressFn& on_progress, const AbortFn& abort_check, const WireFn& on_wire) {
+    if (remote.size() > kSyncPathMax) return ENAMETOOLONG;
+    const bool resumable = st.size >= kResumeMinSize;
+    const std::string target = resumable ? local + kPartSuffix : local;
+    if (on_progress) on_progress(0, remote);
+    const auto started = std::chrono::steady_clock::now();
+
+    // Read once: a settings change mid-file must not leave md5 covering only the tail.
+    const bool verify = VerifyWanted();
+    std::unique_ptr<ADBMd5> md5;
+    int rc = 0;
+    for (int attempt = 0; ; ++attempt) {
+        const uint64_t offset = resumable ? ResumeOffset(target, st) : 0;
+        int out_fd = open(target.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | (offset ? 0 : O_TRUNC), 0644);
+        if (out_fd < 0) return errno;
+        if (verify) md5.reset(new ADBMd5);
+        rc = 0;
+        if (offset) {
+            if (md5) rc = HashPrefix(out_fd, offset, *md5);
+            if (rc == 0 && (ftruncate(out_fd, (off_t)offset) != 0 || lseek(out_fd, (off_t)offset, SEEK_SET) < 0)) rc = errno;
+            if (rc == 0) rc = recvTail(remote, out_fd, st, offset, md5.get(), on_progress, abort_check);
+        } else if (!ensureSession()) {
+            rc = EIO;
+        } else {
+            rc = recvData(remote, out_fd, st, md5.get(), on_progress, abort_check, on_wire);
+        }
+        if (::close(out_fd) != 0 && rc == 0) rc = errno;
+        if (rc == 0 || !resumable || rc != EIO) break;
+
+        // Link-level failure: keep what arrived, stamped so this or a later pull can continue it.
+        // Esc (here or while waiting to retry) is a decision not to have the file — the part goes with it.
+        struct timeval tv[2] = {};
+        tv[0].tv_sec = tv[1].tv_sec = (time_t)st.mtime;
+        utimes(target.c_str(), tv);
+        if (attempt >= kResumeRetries) return rc;
+        DBG("pull '%s': link error, resume attempt %d\n", remote.c_str(), attempt + 1);
+        for (int waited = 0; waited < (1000 << attempt) && rc != ECANCELED; waited += kPollSliceMs) {
+            if (abort_check && abort_check()) rc = ECANCELED;
+            else usleep(kPollSliceMs * 1000);
+        }
+        if (rc == ECANCELED) break;
+    }
+    if (rc == 0 && md5) rc = verifyRemote(remote, *md5, abort_check);
+    if (rc == 0 && resumable && rename(target.c_str(), local.c_str()) != 0) rc = errno;
+    if (rc != 0) {
+        unlink(target.c_str());
+        return rc;
+    }
+    // `pull -a` semantics: keep device mode bits and mtime.
+    chmod(local.c_str(), st.mode & 07777);
+    struct timeval tv[2] = {};
+    tv[0].tv_sec = tv[1].tv_sec = (time_t)st.mtime;
+    utimes(local.c_str(), tv);
+    ADBStats::RecordTransfer(false, st.size, std::chrono::steady_clock::now() - started);
+    if (on_progress) on_progress(100, remote);
+    return 0;
+}
+
+int ADBSocket::sendFile(const std::string& local, const std::string& remote,
+                        const ProgressFn& on_progress, const AbortFn& abort_check, const WireFn& on_wire) {
+    struct stat st{};
+    if (lstat(local.c_str(), &st) != 0) return errno;
+    const std::string path_mode = remote + "," + std::to_string((unsigned)st.st_mode);
+    if (path_mode.size() > kSyncPathMax) return ENAMETOOLONG;
+
+    int in_fd = -1;
+    std::string link_target;
+    if (S_ISLNK(st.st_mode)) {
+        std::vector<char> target(kSyncPathMax + 1);
+        ssize_t n = readlink(local.c_str(), target.data(), kSyncPathMax);
+        if (n < 0) return errno;
+        link_target.assign(target.data(), (size_t)n);
+    } else {
+        in_fd = open(local.c_str(), O_RDONLY | O_CLOEXEC);
+        if (in_fd < 0) return errno;
+    }
+
+    // adbd drops a half-written SEND target on a broken link, so pushes can't resume — only be verified.
+    std::unique_ptr<ADBMd5> md5;
+    if (in_fd >= 0 && VerifyWanted()) md5.reset(new ADBMd5);
+    const auto started = std::chrono::steady_clock::now();
+    int rc = 0;
+    int last_pct = -1;
+    if (in_fd >= 0 && _brotli && (uint64_t)st.st_size >= kCompressMinSize) {
+        rc = sendCompressed(in_fd, local, remote, st, md5.get(), on_progress, abort_check, on_wire);
+        ::close(in_fd);
+    } else {
+        if (!sendPacket("SEND", path_mode.data(), path_mode.size())) {
+            if (in_fd >= 0) ::close(in_fd);
+            return EIO;
+        }
+
+        // Header + payload in one buffer so each DATA packet is a single send().
+        std::vector<unsigned char> pkt(8 + kSyncDataMax);
+        memcpy(pkt.data(), "DATA", 4);
+        uint64_t done = 0;
+        if (on_progress) { on_progress(0, local); last_pct = 0; }
+        if (in_fd < 0) {
+            memcpy(pkt.data() + 8, link_target.data(), link_target.size());
+            PutLe32(pkt.data() + 4, (uint32_t)link_target.size());
+            if (!WriteFull(_fd, pkt.data(), 8 + link_target.size())) { close(); rc = EIO; }
+        } else {
+            for (;;) {
+                if (abort_check && abort_check()) { close(); rc = ECANCELED; break; }
+                ssize_t n = read(in_fd, pkt.data() + 8, kSyncDataMax);
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0) { rc = errno; close(); break; }
+                if (n == 0) break;
+                if (md5) md5->Update(pkt.data() + 8, (size_t)n);
+                PutLe32(pkt.data() + 4, (uint32_t)n);
+                if (!WriteFull(_fd, pkt.data(), 8 + (size_t)n)) { close(); rc = EIO; break; }
+                done += (uint64_t)n;
+                if (on_progress && st.st_size > 0) {
+                    int pct = (int)((done * 100) / (uint64_t)st.st_size);
+                    if (pct > 100) pct = 100;
+                    if (pct != last_pct) { last_pct = pct; on_progress(pct, local); }
+                }
+            }
+            ::close(in_fd);
+        }
+    }
+    if (rc != 0) return rc;
+
+    unsigned char done_pkt[8];
+    memcpy(done_pkt, "DONE", 4);
+    PutLe32(done_pkt + 4, (uint32_t)st.st_mtime);
+    if (!WriteFull(_fd, done_pkt, sizeof(done_pkt))) { close(); return EIO; }
+
+    unsigned char reply[8];
+    if (!readExact(reply, sizeof(reply), abort_check)) {
+        return (abort_check && abort_check()) ? ECANCELED : EIO;
+    }
+    if (memcmp(reply, "FAIL", 4) == 0) return readFail(GetLe32(reply + 4));
+    if (memcmp(reply, "OKAY", 4) != 0) { close(); return EIO; }
+    if (md5) {
+        if (int err = verifyRemote(remote, *md5, abort_check)) return err;
+    }
+    ADBStats::RecordTransfer(true, in_fd >= 0 ? (uint64_t)st.st_size : 0, std::chrono::steady_clock::now() - started);
+    if (on_progress && last_pct != 100) on_progress(100, local);
+    return 0;
+}
+
+// SND2 request + brotli-compressed DATA stream of a regular file; DONE/OKAY is left to sendFile.
+int ADBSocket::sendCompressed(int in_fd, const std::string& local, const std::string& remote, const struct stat& st,
+                              ADBMd5* md5, const ProgressFn& on_progress, const AbortFn& abort_check, const WireFn& on_wire) {
+#ifdef HAVE_BROTLI
+    if (remote.size() > kSyncPathMax) return ENAMETOOLONG;
+    std::unique_ptr<BrotliEncoderState, void (*)(BrotliEncoderState*)> encoder(
+        BrotliEncoderCreateInstance(nullptr, nullptr, nullptr), BrotliEncoderDestroyInstance);
+    if (!encoder) return ENOMEM;
+    // Fastest level, like adb's own encoder: the point is fewer bytes on a slow link, not the best ratio.
+    BrotliEncoderSetParameter(encoder.get(), BROTLI_PARAM_QUALITY, 1);
+
+    unsigned char setup[12];
+    memcpy(setup, "SND2", 4);
+    PutLe32(setup + 4, (uint32_t)st.st_mode);
+    PutLe32(setup + 8, kSyncFlagBrotli);
+    if (!sendPacket("SND2", remote.data(), remote.size())) return EIO;
+    if (!WriteFull(_fd, setup, sizeof(setup))) { close(); return EIO; }
+
+    std::vector<uint8_t> plain(kSyncDataMax);
+    std::vector<unsigned char> pkt(8 + kSyncDataMax);
+    memcpy(pkt.data(), "DATA", 4);
+    uint64_t done = 0;
+    int last_pct = 0;
+    if (on_progress) on_progress(0, local);
+    for (;;) {
+        if (abort_check && abort_check()) { close(); return ECANCELED; }
+        ssize_t n = read(in_fd, plain.data(), plain.size());
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) { const int err = errno; close(); return err; }
+        const bool eof = (n == 0);
+        if (md5 && n > 0) md5->Update(plain.data(), (size_t)n);
+        const uint8_t* in = plain.data();
+        size_t avail_in = (size_t)n;
+        uint64_t wire = 0;
+        do {
+            uint8_t* out = pkt.data() + 8;
+            size_t avail_out = kSyncDataMax;
+            if (!BrotliEncoderCompressStream(encoder.get(), eof ? BROTLI_OPERATION_FINISH : BROTLI_OPERATION_PROCESS,
+                                             &avail_in, &in, &avail_out, &out, nullptr)) {
+                close();
+                return EIO;
+            }
+            const size_t produced = kSyncDataMax - avail_out;
+            if (produced > 0) {
+                PutLe32(pkt.data() + 4, (uint32_t)produced);
+                if (!WriteFull(_fd, pkt.data(), 8 + produced)) { close(); return EIO; }
+                wire += produced;
+            }
+        } while (avail_in > 0 || BrotliEncoderHasMoreOutput(encoder.get())
+                 || (eof && !BrotliEncoderIsFinished(encoder.get())));
+        if (on_wire && (n > 0 || wire > 0)) on_wire((uint64_t)n, wire);
+        if (eof) break;
+        done += (uint64_t)n;
+        if (on_progress && st.st_size > 0) {
+            int pct = (int)((done * 100) / (uint64_t)st.st_size);
+            if (pct > 100) pct = 100;
+            if (pct != last_pct) { last_pct = pct; on_progress(pct, local); }
+        }
+    }
+    return 0;
+#else
+    (void)in_fd; (void)local; (void)remote; (void)st; (void)md5; (void)on_progress; (void)abort_check; (void)on_wire;
+    return EIO;
+#endif
+}
+
+int ADBSocket::exec(const std::string& command, const SourceFn& source, const SinkFn& sink,
+                    const AbortFn& abort_check, int& exit_code, std::string* err_out) {
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        queryFeatures();
+        if (!_shell_v2) return kUnavailable;
+    }
+    // Own connection: the sync session stays free for other requests meanwhile.
+    const int fd = openService("shell,v2,raw:" + command);
+    if (fd < 0) return kUnavailable;
+
+    exit_code = -1;
+    std::vector<char> out(5 + kShellChunk);
+    std::vector<char> in;
+    bool stdin_open = true;
+    int rc = 0;
+    for (;;) {
+        if (abort_check && abort_check()) { rc = ECANCELED; break; }
+        if (stdin_open) {
+            const ssize_t n = source ? source(out.data() + 5, kShellChunk) : 0;
+            if (n < 0) { rc = (int)-n; break; }
+            out[0] = (char)(n > 0 ? kShellStdin : kShellCloseStdin);
+            PutLe32((unsigned char*)out.data() + 1, (uint32_t)n);
+            if (!WriteFull(fd, out.data(), 5 + (size_t)n)) { rc = EIO; break; }
+            if (n == 0) stdin_open = false;
+            // While feeding stdin, only pick up packets that are already there.
+            struct pollfd pfd{};
+            pfd.fd = fd;
+            pfd.events = POLLIN;
+            if (stdin_open && poll(&pfd, 1, 0) <= 0) continue;
+        }
+        unsigned char hdr[5];
+        if (!ReadFull(fd, hdr, sizeof(hdr), abort_check)) {
+            rc = (abort_check && abort_check()) ? ECANCELED : EIO;
+            break;
+        }
+        const uint32_t len = GetLe32(hdr + 1);
+        in.resize(len);
+        if (len > 0 && !ReadFull(fd, in.data(), len, abort_check)) {
+            rc = (abort_check && abort_check()) ? ECANCELED : EIO;
+            break;
+        }
+        if (hdr[0] == kShellStdout) {
+            if (sink && len > 0 && (rc = sink(in.data(), len)) != 0) break;
+        } else if (hdr[0] == kShellStderr) {
+            if (err_out && err_out->size() < kShellStderrMax) err_out->append(in.data(), len);
+        } else if (hdr[0] == kShellExit) {
+            exit_code = (len > 0) ? (unsigned char)in[0] : -1;
+            break;
+        }
+    }
+    // Closing before the exit packet makes adbd hang up on the command (Esc / sink error).
+    ::close(fd);
+    DBG("exec '%s': rc=%d exit=%d\n", command.c_str(), rc, exit_code);
+    return rc;
+}
+
+int ADBSocket::pull(const std::string& remote, const std::string& local,
+                    const ProgressFn& on_progress, const AbortFn& abort_check, const WireFn& on_wire) {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    if (!ensureSession()) return kUnavailable;
+
+    Entry st;
+    int rc = statLocked(remote, st);
+    if (rc != 0) return rc;
+
+    // Same target rule as `adb pull`: an existing local directory receives the item under its basename.
+    std::string dst = local;
+    struct stat lst{};
+    if (::stat(local.c_str(), &lst) == 0 && S_ISDIR(lst.st_mode)) {
+        dst = ADBUtils::JoinPath(local, ADBUtils::PathBasename(remote));
+    }
+
+    if (S_ISREG(st.mode)) {
+        return recvFile(remote, dst, st, on_progress, abort_check, on_wire);
+    }
+    if (!S_ISDIR(st.mode)) {
+        // Symlink seen through v1 lstat, device node, fifo — leave the special cases to the adb binary.
+        return kUnavailable;
+    }
+
+    // List the whole tree before writing anything, so an unsupported entry can still fall back cleanly.
+    struct Item { std::string remote, local; Entry st; };
+    std::vector<Item> files;
+    std::vector<std::string> dirs{dst};
+    std::vector<std::pair<std::string, std::string>> pending{{remote, dst}};
+    while (!pending.empty()) {
+        auto cur = std::move(pending.back());
+        pending.pop_back();
+        std::vector<Entry> entries;
+        rc = listLocked(cur.first, entries);
+        if (rc != 0) return rc;
+        for (auto& e : entries) {
+            std::string r = ADBUtils::JoinPath(cur.first, e.name);
+            std::string l = ADBUtils::JoinPath(cur.second, e.name);
+            if (S_ISDIR(e.mode)) {
+                dirs.push_back(l);
+                pending.emplace_back(std::move(r), std::move(l));
+            } else if (S_ISREG(e.mode)) {
+                files.push_back(Item{std::move(r), std::move(l), std::move(e)});
+            } else {
+                DBG("pull '%s': non-regular entry '%s' mode=0%o — deferring to adb binary\n",
+                    remote.c_str(), r.c_str(), e.mode);
+                return kUnavailable;
+            }
+        }
+    }
+
+    for (const auto& d : dirs) {
+        if (int err = MkdirPLocal(d)) return err;
+    }
+    for (const auto& f : files) {
+        if (abort_check && abort_check()) return ECANCELED;
+        rc = recvFile(f.remote, f.local, f.st, on_progress, abort_check, on_wire);
+        if (rc != 0) return rc;
+    }
+    return 0;
+}
+
+int ADBSocket::push(const std::string& local, const std::string& remote,
+                    const ProgressFn& on_progress, const AbortFn& abort_check,
+                    std::vector<std::string>* empty_dirs, const WireFn& on_wire) {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    struct stat lst{};
+    if (::stat(local.c_str(), &lst) != 0) return errno;
+    if (!ensureSession()) return kUnavailable;
+
+    // Same target rule as `adb push`: an existing device directory receives the item under its basename.
+    std::string dst = remote;
+    Entry rst;
+    int rc = statLocked(remote, rst);
+    if (rc == kUnavailable) return rc;
+    if (rc == 0 && S_ISDIR(rst.mode)) {
+        dst = ADBUtils::JoinPath(remote, ADBUtils::PathBasename(local));
+    }
+
+    if (!S_ISDIR(lst.st_mode)) {
+        return sendFile(local, dst, on_progress, abort_check, on_wire);
+    }
+
+    std::vector<std::pair<std::string, std::string>> files;
+    std::vector<std::pair<std::string, std::string>> pending{{local, dst}};
+    while (!pending.empty()) {
+        auto cur = std::move(pending.back());
+        pending.pop_back();
+        DIR* dir = opendir(cur.first.c_str());
+        if (!dir) return errno;
+        bool empty = true;
+        for (;;) {
+            errno = 0;
+            struct dirent* ent = readdir(dir);
+            if (!ent) {
+                const int err = errno;
+                if (err != 0) {
+                    closedir(dir);
+                    return err;
+                }
+                break;
+            }
+            if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) continue;
+            empty = false;
+            std::string l = ADBUtils::JoinPath(cur.first, ent->d_name);
+            std::string r = ADBUtils::JoinPath(cur.second, ent->d_name);
+            struct stat st{};
+            if (lstat(l.c_str(), &st) != 0) {
+                const int err = errno;
+                closedir(dir);
+                return err;
+            }
+            if (S_ISDIR(st.st_mode)) pending.emplace_back(std::move(l), std::move(r));
+            else files.emplace_back(std::move(l), std::move(r));
+        }
+        closedir(dir);
+        if (empty && empty_dirs) empty_dirs->push_back(cur.second);
+    }
+
+    for (const auto& f : files) {
+        if (abort_check && abort_check()) return ECANCELED;
+        rc = sendFile(f.first, f.second, on_progress, abort_check, on_wire);
+        if (rc != 0) return rc;
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+// Standard library includes
+#include <string>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include <functional>
+
+// System includes
+#include <sys/stat.h>
+#include <sys/types.h>
+
+
+class ADBMd5;
+
+// In-process client for the adb host server's smart-socket protocol (host:*, host:transport:<serial>, sync:).
+// One sync session is kept open per device, so per-file STAT/RECV/SEND skip the fork/exec + server handshake of the adb binary.
+class ADBSocket {
+public:
+    // Returned instead of an errno when the server/session can't be used at all — caller falls back to the adb binary.
+    static constexpr int kUnavailable = -1;
+
+    struct Entry {
+        std::string name;
+        uint32_t mode = 0;
+        uint64_t size = 0;
+        int64_t mtime = 0;
+    };
+
+    using ProgressFn = std::function<void(int, const std::string&)>;
+    using AbortFn = std::function<bool()>;
+    // Compressed transfers only: (payload bytes, bytes that crossed the link) as each DATA packet goes by.
+    using WireFn = std::function<void(uint64_t, uint64_t)>;
+    // exec() stdin: fills the buffer, returns bytes, 0 at EOF or -errno. stdout: a non-zero errno stops the command.
+    using SourceFn = std::function<ssize_t(char*, size_t)>;
+    using SinkFn = std::function<int(const char*, size_t)>;
+
+    explicit ADBSocket(const std::string& device_serial = "");
+    ~ADBSocket();
+
+    ADBSocket(const ADBSocket&) = delete;
+    ADBSocket& operator=(const ADBSocket&) = delete;
+
+    // Settings defaults for compressed / md5-verified transfers; FAR2L_ADB_COMPRESS / FAR2L_ADB_VERIFY, when set, still decide.
+    static void SetCompressDefault(bool on);
+    static void SetVerifyDefault(bool on);
+
+    // One-shot host service (e.g. "host:devices-l"); false if the server is unreachable or replied FAIL.
+    static bool hostQuery(const std::string& service, std::string& out);
+
+    // host:track-devices: on_list gets the full device list (`adb devices` body) once at start and again on every
+    // change, for as long as the server keeps the stream open and abort_check stays false; false if it never opened.
+    static bool trackDevices(const std::function<void(const std::string&)>& on_list, const AbortFn& abort_check);
+
+    // sync STAT (follows symlinks when the device has stat_v2); 0, device errno (ENOENT...) or kUnavailable.
+    int statPath(const std::string& path, Entry& out);
+    // sync LIST of one directory, "." and ".." dropped.
+    int listDir(const std::string& path, std::vector<Entry>& out);
+    // `adb pull -a` / `adb push` equivalents for a file or a whole tree. on_progress gets (percent, path) per file.
+    // push: empty local dirs are not representable in sync SEND — their device paths are appended to empty_dirs.
+    // File data is brotli-compressed (sendrecv_v2) when the device advertises it and FAR2L_ADB_COMPRESS allows it.
+    // Large pulls go through "<local>.adbpart": a dropped link is retried from the partial size, and a part left behind
+    // when the retries ran out is picked up again by a later pull of the unchanged file. Esc removes the part.
+    // Verification (setting or FAR2L_ADB_VERIFY=1) checks each file against the device's md5sum.
+    int pull(const std::string& remote, const std::string& local,
+             const ProgressFn& on_progress = {}, const AbortFn& abort_check = {},
+             const WireFn& on_wire = {});
+    int push(const std::string& local, const std::string& remote,
+             const ProgressFn& on_progress = {}, const AbortFn& abort_check = {},
+             std::vector<std::string>* empty_dirs = nullptr, const WireFn& on_wire = {});
+
+    // Device command over shell protocol v2 — stdin EOF and an exit status, which plain exec: can't carry.
+    // 0 with exit_code set, an errno, or kUnavailable when the device has no shell_v2. stderr goes to err_out.
+    int exec(const std::string& command, const SourceFn& source, const SinkFn& sink, const AbortFn& abort_check,
+             int& exit_code, std::string* err_out = nullptr);
+
+    // Drop the sync session (next call reconnects).
+    void close();
+
+private:
+    std::string _device_serial;
+    int _fd;
+    bool _features_known;
+    bool _stat_v2;
+    bool _ls_v2;
+    bool _brotli;
+    bool _shell_v2;
+
+    // Serializes sync packets: one request/response exchange at a time on the shared session.
+    std::recursive_mutex _mutex;
+
+    static int connectServer();
+    static bool sendRequest(int fd, const std::string& service);
+    static bool readStatus(int fd, std::string* fail_message = nullptr);
+
+    bool ensureSession();
+    // host:transport + `service`; a raw fd (e.g. for exec:) or -1.
+    int openService(const std::string& service);
+    void queryFeatures();
+    int statLocked(const std::string& path, Entry& out);
+    int listLocked(const std::string& path, std::vector<Entry>& out);
+    int recvFile(const std::string& remote, const std::string& local, const Entry& st,
+                 const ProgressFn& on_progress, const AbortFn& abort_check, const WireFn& on_wire);
+    int recvData(const std::string& remote, int out_fd, const Entry& st, ADBMd5* md5,
+                 const ProgressFn& on_progress, const AbortFn& abort_check, const WireFn& on_wire);
+    int recvTail(const std::string& remote, int out_fd, const Entry& st, uint64_t offset, ADBMd5* md5,
+                 const ProgressFn& on_progress, const AbortFn& abort_check);
+    int verifyRemote(const std::string& remote, ADBMd5& md5, const AbortFn& abort_check);
+    int sendFile(const std::string& local, const std::string& remote,
+                 const ProgressFn& on_progress, const AbortFn& abort_check, const WireFn& on_wire);
+    int sendCompressed(int in_fd, const std::string& local, const std::string& remote, const struct stat& st,
+                       ADBMd5* md5, const ProgressFn& on_progress, const AbortFn& abort_check, const WireFn& on_wire);
+    bool sendPacket(const char id[4], const void* data, size_t len);
+    bool readExact(void* buf, size_t len, const AbortFn& abort_check = {});
+    int readFail(uint32_t len);
+};
@@ -0,0 +1,160 @@
+#include "ADBStats.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <ctime>
+
+namespace ADBStats {
+
+namespace {
+
+// Bucket b holds values in [2^(b-1), 2^b); bucket 0 is exactly 0. 40 buckets cover ~6 days in µs.
+constexpr int kBuckets = 40;
+
+struct Hist {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> max{0};
+    std::atomic<uint64_t> buckets[kBuckets] = {};
+};
+
+std::atomic<uint64_t> g_counters[COUNTER_COUNT] = {};
+Hist g_hists[HISTOGRAM_COUNT];
+std::atomic<int64_t> g_since{(int64_t)time(nullptr)};
+
+constexpr const char* kCounterNames[COUNTER_COUNT] = {
+    "shell commands",
+    "shell timeouts/failures",
+    "shell sessions started",
+    "adb processes spawned",
+    "server connections",
+    "server connect failures",
+    "pooled shells reused",
+    "pooled shells started",
+    "listing cache hits",
+    "listing cache misses",
+    "files pulled",
+    "files pushed",
+    "bytes pulled",
+    "bytes pushed",
+};
+
+struct HistInfo {
+    const char* name;
+    double scale;   // stored unit → shown unit
+};
+constexpr HistInfo kHistInfo[HISTOGRAM_COUNT] = {
+    {"shell round-trip, ms", 1000.0},
+    {"adb process run, ms", 1000.0},
+    {"server connect, ms", 1000.0},
+    {"device listing, ms", 1000.0},
+    {"pull per file, MiB/s", 1024.0},
+    {"push per file, MiB/s", 1024.0},
+};
+
+int BucketOf(uint64_t v) {
+    int b = 0;
+    while (v && b < kBuckets - 1) { v >>= 1; ++b; }
+    return b;
+}
+
+uint64_t BucketTop(int b) {
+    return b == 0 ? 0 : (uint64_t(1) << b) - 1;
+}
+
+// Upper bound of the bucket holding the q-quantile, clipped to the observed max.
+uint64_t Quantile(const Hist& h, uint64_t count, double q) {
+    const uint64_t want = (uint64_t)(q * (double)count + 0.5);
+    uint64_t seen = 0;
+    for (int b = 0; b < kBuckets; ++b) {
+        seen += h.buckets[b].load(std::memory_order_relaxed);
+        if (seen >= want && seen > 0) return std::min(BucketTop(b), h.max.load(std::memory_order_relaxed));
+    }
+    return h.max.load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+void Add(Counter c, uint64_t n) {
+    g_counters[c].fetch_add(n, std::memory_order_relaxed);
+}
+
+uint64_t Get(Counter c) {
+    return g_counters[c].load(std::memory_order_relaxed);
+}
+
+void Record(Histogram h, uint64_t value) {
+    Hist& s = g_hists[h];
+    s.count.fetch_add(1, std::memory_order_relaxed);
+    s.sum.fetch_add(value, std::memory_order_relaxed);
+    s.buckets[BucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    uint64_t prev = s.max.load(std::memory_order_relaxed);
+    while (value > prev && !s.max.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {}
+}
+
+void RecordTransfer(bool push, uint64_t bytes, std::chrono::steady_clock::duration elapsed) {
+    Add(push ? FILES_PUSHED : FILES_PULLED);
+    Add(push ? BYTES_PUSHED : BYTES_PULLED, bytes);
+    // Sub-64 KiB files say more about round-trips than bandwidth; they'd swamp the throughput picture.
+    const auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    if (bytes >= 64 * 1024 && us > 0) {
+        Record(push ? PUSH_KIBPS : PULL_KIBPS, (uint64_t)((double)bytes / 1024.0 * 1e6 / (double)us));
+    }
+}
+
+std::string Report() {
+    char line[160];
+    std::string out;
+    snprintf(line, sizeof(line), "Since %lld s ago\n",
+             (long long)(time(nullptr) - g_since.load(std::memory_order_relaxed)));
+    out += line;
+    for (int c = 0; c < COUNTER_COUNT; ++c) {
+        snprintf(line, sizeof(line), "%-26s %12llu\n", kCounterNames[c],
+                 (unsigned long long)g_counters[c].load(std::memory_order_relaxed));
+        out += line;
+    }
+    snprintf(line, sizeof(line), "%-26s %7s %8s %8s %8s %8s %8s\n", "", "count", "avg", "p50", "p90", "p99", "max");
+    out += line;
+    for (int h = 0; h < HISTOGRAM_COUNT; ++h) {
+        const Hist& s = g_hists[h];
+        const uint64_t count = s.count.load(std::memory_order_relaxed);
+        const double scale = kHistInfo[h].scale;
+        const double avg = count ? (double)s.sum.load(std::memory_order_relaxed) / (double)count / scale : 0.0;
+        snprintf(line, sizeof(line), "%-26s %7llu %8.1f %8.1f %8.1f %8.1f %8.1f\n", kHistInfo[h].name,
+                 (unsigned long long)count, avg,
+                 Quantile(s, count, 0.50) / scale, Quantile(s, count, 0.90) / scale,
+                 Quantile(s, count, 0.99) / scale, s.max.load(std::memory_order_relaxed) / scale);
+        out += line;
+    }
+    return out;
+}
+
+bool AppendReport(const std::string& path) {
+    FILE* f = fopen(path.c_str(), "a");
+    if (!f) return false;
+    const time_t now = time(nullptr);
+    struct tm tm_buf;
+    char stamp[64] = "?";
+    if (localtime_r(&now, &tm_buf)) strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &tm_buf);
+    const std::string report = Report();
+    const bool ok = fprintf(f, "=== ADB plugin statistics, %s ===\n%s\n", stamp, report.c_str()) > 0;
+    return (fclose(f) == 0) && ok;
+}
+
+void Reset() {
+    for (auto& c : g_counters) c.store(0, std::memory_order_relaxed);
+    for (auto& s : g_hists) {
+        s.count.store(0, std::memory_order_relaxed);
+        s.sum.store(0, std::memory_order_relaxed);
+        s.max.store(0, std::memory_order_relaxed);
+        for (auto& b : s.buckets) b.store(0, std::memory_order_relaxed);
+    }
+    g_since.store((int64_t)time(nullptr), std::memory_order_relaxed);
+}
+
+ScopedTimer::~ScopedTimer() {
+    Record(_h, (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - _start).count());
+}
+
+} // namespace ADBStats
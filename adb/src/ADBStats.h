@@ -0,0 +1,69 @@
+#pragma once
+
+// Standard library includes
+#include <string>
+#include <chrono>
+#include <cstdint>
+
+
+// Always-on counters and histograms — unlike DBG() they stay in release builds, so a slow copy on a user's device
+// can be told apart as USB-, round-trip- or fork-bound. Lock-free (relaxed atomics); process-wide, all devices.
+// Shown from F9 → Options → Plugins configuration → ADB statistics; FAR2L_ADB_STATS=<file> also appends the
+// report there when far2l exits.
+namespace ADBStats {
+
+enum Counter {
+    SHELL_COMMANDS,         // commands sent over persistent `adb shell` sessions (sync, streamed and pipelined)
+    SHELL_FAILURES,         // no end marker: timeout or broken session
+    SHELL_SESSIONS,         // `adb shell` sessions started
+    PROCESS_SPAWNS,         // every fork() of the adb client
+    SOCKET_CONNECTS,        // direct connections to the adb server
+    SOCKET_CONNECT_FAILURES,
+    POOL_REUSES,            // pooled shell leases served by an idle session
+    POOL_STARTS,            // ... that had to start a new one
+    LISTING_CACHE_HITS,
+    LISTING_CACHE_MISSES,
+    FILES_PULLED,
+    FILES_PUSHED,
+    BYTES_PULLED,
+    BYTES_PUSHED,
+    COUNTER_COUNT
+};
+
+enum Histogram {
+    SHELL_ROUNDTRIP_US,     // synchronous shell command, write to end marker
+    PROCESS_RUN_US,         // one-shot adb client process, fork to exit
+    SOCKET_CONNECT_US,
+    LISTING_US,             // directory listing fetched from the device (cache misses only)
+    PULL_KIBPS,             // per-file throughput
+    PUSH_KIBPS,
+    HISTOGRAM_COUNT
+};
+
+void Add(Counter c, uint64_t n = 1);
+uint64_t Get(Counter c);
+void Record(Histogram h, uint64_t value);
+// One finished file transfer: byte counters plus its throughput sample.
+void RecordTransfer(bool push, uint64_t bytes, std::chrono::steady_clock::duration elapsed);
+
+// Plain-text table, one line per counter/histogram (count, avg, p50/p90/p99 as log2-bucket upper bounds, max).
+std::string Report();
+// Appends a timestamped Report() to path; false if it can't be written.
+bool AppendReport(const std::string& path);
+void Reset();
+
+// Records the lifetime of the scope into a microsecond histogram.
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Histogram h) : _h(h), _start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer();
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Histogram _h;
+    std::chrono::steady_clock::time_point _start;
+};
+
+} // namespace ADBStats
@@ -0,0 +1,458 @@
+#include "ADBTar.h"
+#include "ADBLog.h"
+
+// Standard library includes
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+
+// System includes
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+static constexpr size_t kBlock = 512;
+// ustar numeric fields hold 11 octal digits; bigger sizes use GNU base-256.
+static constexpr uint64_t kOctalSizeMax = 077777777777ull;
+
+// Octal (NUL/space terminated) or GNU base-256 (high bit of the first byte set).
+static uint64_t ParseNumber(const char* field, size_t len) {
+    const unsigned char* p = (const unsigned char*)field;
+    if (p[0] & 0x80) {
+        uint64_t v = p[0] & 0x7f;
+        for (size_t i = 1; i < len; ++i) v = (v << 8) | p[i];
+        return v;
+    }
+    uint64_t v = 0;
+    size_t i = 0;
+    while (i < len && (p[i] == ' ' || p[i] == 0)) ++i;
+    for (; i < len && p[i] >= '0' && p[i] <= '7'; ++i) v = v * 8 + (p[i] - '0');
+    return v;
+}
+
+static std::string FieldString(const char* field, size_t len) {
+    return std::string(field, strnlen(field, len));
+}
+
+// Tree-relative, no "./" noise; empty if the name escapes the root (absolute or "..").
+static std::string SanitizeRel(const std::string& name) {
+    std::string out;
+    size_t pos = 0;
+    while (pos <= name.size()) {
+        size_t slash = name.find('/', pos);
+        if (slash == std::string::npos) slash = name.size();
+        const std::string part = name.substr(pos, slash - pos);
+        pos = slash + 1;
+        if (part.empty() || part == ".") continue;
+        if (part == "..") return std::string();
+        if (!out.empty()) out += '/';
+        out += part;
+    }
+    return out;
+}
+
+// A symlink among rel's parents (planted by an earlier entry) would let "link/name" write outside the root.
+static bool ParentIsSymlink(const std::string& root, const std::string& rel) {
+    for (size_t slash = rel.find('/'); slash != std::string::npos; slash = rel.find('/', slash + 1)) {
+        struct stat st{};
+        if (lstat((root + "/" + rel.substr(0, slash)).c_str(), &st) == 0 && S_ISLNK(st.st_mode)) return true;
+    }
+    return false;
+}
+
+static int MkdirP(const std::string& path) {
+    if (path.empty() || path == "/") return 0;
+    for (size_t i = 1; i <= path.size(); ++i) {
+        if (i == path.size() || path[i] == '/') {
+            std::string cur = path.substr(0, i);
+            struct stat st{};
+            if (stat(cur.c_str(), &st) == 0) {
+                if (!S_ISDIR(st.st_mode)) return ENOTDIR;
+            } else if (mkdir(cur.c_str(), 0755) != 0 && errno != EEXIST) {
+                return errno;
+            }
+        }
+    }
+    return 0;
+}
+
+static int MkdirParent(const std::string& path) {
+    auto slash = path.find_last_of('/');
+    return (slash == std::string::npos || slash == 0) ? 0 : MkdirP(path.substr(0, slash));
+}
+
+TarExtractor::TarExtractor(const std::string& root, const TarProgressFn& on_progress)
+    : _root(root), _on_progress(on_progress)
+{
+}
+
+TarExtractor::~TarExtractor() {
+    if (_fd >= 0) ::close(_fd);
+}
+
+int TarExtractor::Feed(const char* data, size_t len) {
+    while (len > 0) {
+        switch (_state) {
+        case State::HEADER: {
+            const size_t take = std::min(len, kBlock - _block_fill);
+            memcpy(_block + _block_fill, data, take);
+            _block_fill += take;
+            data += take;
+            len -= take;
+            if (_block_fill == kBlock) {
+                _block_fill = 0;
+                if (int rc = OnHeader()) return rc;
+            }
+            break;
+        }
+        case State::DATA: {
+            const size_t take = (size_t)std::min<uint64_t>(len, _left);
+            if (int rc = OnData(data, take)) return rc;
+            data += take;
+            len -= take;
+            _left -= take;
+            if (_left == 0) {
+                if (int rc = EndEntry()) return rc;
+                _state = _padding ? State::PADDING : State::HEADER;
+            }
+            break;
+        }
+        case State::PADDING: {
+            const size_t take = (size_t)std::min<uint64_t>(len, _padding);
+            data += take;
+            len -= take;
+            _padding -= take;
+            if (_padding == 0) _state = State::HEADER;
+            break;
+        }
+        case State::END:
+            // Trailing zero blocks / record padding after the end marker.
+            return 0;
+        }
+    }
+    return 0;
+}
+
+int TarExtractor::Finish() {
+    if (_state == State::DATA || _state == State::PADDING || _block_fill != 0) return EIO;
+    return 0;
+}
+
+int TarExtractor::OnHeader() {
+    bool zero = true;
+    for (size_t i = 0; i < kBlock && zero; ++i) zero = (_block[i] == 0);
+    if (zero) {
+        _state = State::END;
+        return 0;
+    }
+    uint64_t sum = 0;
+    for (size_t i = 0; i < kBlock; ++i) sum += (i >= 148 && i < 156) ? ' ' : (unsigned char)_block[i];
+    if (sum != ParseNumber(_block + 148, 8)) {
+        DBG("bad header checksum\n");
+        return EIO;
+    }
+    _started = true;
+
+    _type = _block[156];
+    _size = ParseNumber(_block + 124, 12);
+    _mode = (uint32_t)ParseNumber(_block + 100, 8);
+    _mtime = (int64_t)ParseNumber(_block + 136, 12);
+    std::string name = FieldString(_block, 100);
+    if (memcmp(_block + 257, "ustar", 5) == 0 && _block[345]) {
+        name = FieldString(_block + 345, 155) + "/" + name;
+    }
+    _path = _next_path.empty() ? name : _next_path;
+    _link = _next_link.empty() ? FieldString(_block + 157, 100) : _next_link;
+    if (_have_next_size) _size = _next_size;
+    if (_type != 'L' && _type != 'K' && _type != 'x' && _type != 'g') {
+        _next_path.clear();
+        _next_link.clear();
+        _have_next_size = false;
+    }
+    // Links/dirs carry no data whatever the size field says.
+    if (_type == '1' || _type == '2' || _type == '5') _size = 0;
+    _left = _size;
+    _padding = (kBlock - _size % kBlock) % kBlock;
+    if (int rc = BeginEntry()) return rc;
+    if (_left > 0) {
+        _state = State::DATA;
+    } else {
+        if (int rc = EndEntry()) return rc;
+        _state = State::HEADER;
+    }
+    return 0;
+}
+
+int TarExtractor::BeginEntry() {
+    _meta.clear();
+    if (_type == 'L' || _type == 'K' || _type == 'x' || _type == 'g') return 0;
+
+    const std::string rel = SanitizeRel(_path);
+    if (rel.empty()) {
+        if (_type == '5') return 0;  // "./" itself
+        DBG("refusing entry '%s'\n", _path.c_str());
+        return EPERM;
+    }
+    if (ParentIsSymlink(_root, rel)) {
+        DBG("refusing entry '%s' below a symlink\n", rel.c_str());
+        return EPERM;
+    }
+    _path = rel;
+    const std::string full = _root + "/" + rel;
+    _last_pct = -1;
+
+    switch (_type) {
+    case '5':
+        return MkdirP(full);
+    case '0': case '\0': case '7': {
+        if (int rc = MkdirParent(full)) return rc;
+        // Replace, don't write through: the old file may be a symlink or read-only.
+        unlink(full.c_str());
+        _fd = open(full.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (_fd < 0) return errno;
+        if (_on_progress) { _on_progress(0, rel); _last_pct = 0; }
+        return 0;
+    }
+    case '2':
+        if (int rc = MkdirParent(full)) return rc;
+        unlink(full.c_str());
+        return (symlink(_link.c_str(), full.c_str()) == 0) ? 0 : errno;
+    case '1': {
+        const std::string target = SanitizeRel(_link);
+        if (target.empty()) return EPERM;
+        if (ParentIsSymlink(_root, target)) {
+            DBG("refusing hard link '%s' to '%s' below a symlink\n", rel.c_str(), target.c_str());
+            return EPERM;
+        }
+        if (int rc = MkdirParent(full)) return rc;
+        unlink(full.c_str());
+        return (link((_root + "/" + target).c_str(), full.c_str()) == 0) ? 0 : errno;
+    }
+    default:
+        DBG("skipping '%s' type '%c'\n", rel.c_str(), _type);
+        return 0;
+    }
+}
+
+int TarExtractor::OnData(const char* data, size_t len) {
+    if (_type == 'L' || _type == 'K' || _type == 'x') {
+        _meta.append(data, len);
+        return 0;
+    }
+    if (_fd < 0) return 0;
+    const size_t chunk = len;
+    while (len > 0) {
+        ssize_t n = write(_fd, data, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) return errno;
+        data += n;
+        len -= (size_t)n;
+    }
+    if (_on_progress && _size > 0) {
+        const int pct = (int)(((_size - _left + chunk) * 100) / _size);
+        if (pct != _last_pct && pct < 100) { _last_pct = pct; _on_progress(pct, _path); }
+    }
+    return 0;
+}
+
+int TarExtractor::EndEntry() {
+    switch (_type) {
+    case 'L':
+        _next_path = _meta.c_str();
+        return 0;
+    case 'K':
+        _next_link = _meta.c_str();
+        return 0;
+    case 'x':
+        ApplyPax(_meta);
+        return 0;
+    case 'g':
+        return 0;
+    }
+    if (_fd >= 0) {
+        // `pull -a` semantics: keep device mode bits and mtime.
+        fchmod(_fd, _mode & 07777);
+        const int rc = (::close(_fd) == 0) ? 0 : errno;
+        _fd = -1;
+        if (rc) return rc;
+        struct timeval tv[2] = {};
+        tv[0].tv_sec = tv[1].tv_sec = (time_t)_mtime;
+        utimes((_root + "/" + _path).c_str(), tv);
+        if (_on_progress) _on_progress(100, _path);
+    }
+    return 0;
+}
+
+// "<len> key=value\n" records; only path/linkpath/size matter here.
+void TarExtractor::ApplyPax(const std::string& records) {
+    size_t pos = 0;
+    while (pos < records.size()) {
+        char* end = nullptr;
+        const unsigned long len = strtoul(records.c_str() + pos, &end, 10);
+        if (!end || *end != ' ' || len == 0 || pos + len > records.size()) break;
+        const std::string rec = records.substr(pos, len);
+        pos += len;
+        const size_t sp = rec.find(' ');
+        const size_t eq = rec.find('=', sp);
+        if (sp == std::string::npos || eq == std::string::npos) continue;
+        const std::string key = rec.substr(sp + 1, eq - sp - 1);
+        std::string value = rec.substr(eq + 1);
+        if (!value.empty() && value.back() == '\n') value.pop_back();
+        if (key == "path") _next_path = value;
+        else if (key == "linkpath") _next_link = value;
+        else if (key == "size") { _next_size = strtoull(value.c_str(), nullptr, 10); _have_next_size = true; }
+    }
+}
+
+TarBuilder::TarBuilder(const std::string& root, const TarProgressFn& on_progress)
+    : _root(root), _on_progress(on_progress)
+{
+    _error = Walk(root, std::string());
+    if (_error) DBG("walk of '%s' failed: %d\n", root.c_str(), _error);
+}
+
+TarBuilder::~TarBuilder() {
+    if (_fd >= 0) ::close(_fd);
+}
+
+int TarBuilder::Walk(const std::string& path, const std::string& rel) {
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return errno;
+    int rc = 0;
+    for (;;) {
+        errno = 0;
+        struct dirent* ent = readdir(dir);
+        if (!ent) { rc = errno; break; }
+        if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) continue;
+        const std::string sub = path + "/" + ent->d_name;
+        const std::string sub_rel = rel.empty() ? std::string(ent->d_name) : rel + "/" + ent->d_name;
+        struct stat st{};
+        if (lstat(sub.c_str(), &st) != 0) { rc = errno; break; }
+        Item item{sub_rel, 0, (uint32_t)(st.st_mode & 07777), 0, (int64_t)st.st_mtime, std::string()};
+        if (S_ISDIR(st.st_mode)) {
+            item.type = '5';
+            _items.push_back(item);
+            if ((rc = Walk(sub, sub_rel)) != 0) break;
+        } else if (S_ISREG(st.st_mode)) {
+            item.type = '0';
+            item.size = (uint64_t)st.st_size;
+            _items.push_back(item);
+        } else if (S_ISLNK(st.st_mode)) {
+            std::vector<char> target((size_t)std::max<off_t>(st.st_size, 255) + 1);
+            ssize_t n = readlink(sub.c_str(), target.data(), target.size() - 1);
+            if (n < 0) { rc = errno; break; }
+            item.type = '2';
+            item.link.assign(target.data(), (size_t)n);
+            _items.push_back(item);
+        }
+    }
+    closedir(dir);
+    return rc;
+}
+
+void TarBuilder::AppendHeader(const std::string& name, char type, uint32_t mode, uint64_t size, int64_t mtime,
+                              const std::string& link) {
+    // Names/link targets that don't fit ustar go first as GNU ././@LongLink records (toybox and busybox read them).
+    auto long_record = [&](char kind, const std::string& value) {
+        const std::string body = value + '\0';
+        AppendHeader("././@LongLink", kind, 0, body.size(), 0, std::string());
+        _pending += body;
+        _pending.append((kBlock - body.size() % kBlock) % kBlock, '\0');
+    };
+    if (name.size() > 100) long_record('L', name);
+    if (link.size() > 100) long_record('K', link);
+
+    char h[kBlock] = {};
+    memcpy(h, name.data(), std::min<size_t>(name.size(), 100));
+    snprintf(h + 100, 8, "%07o", mode & 07777);
+    snprintf(h + 108, 8, "%07o", 0);
+    snprintf(h + 116, 8, "%07o", 0);
+    if (size <= kOctalSizeMax) {
+        snprintf(h + 124, 12, "%011llo", (unsigned long long)size);
+    } else {
+        h[124] = (char)0x80;
+        for (int i = 0; i < 8; ++i) h[135 - i] = (char)(size >> (8 * i));
+    }
+    snprintf(h + 136, 12, "%011llo", (unsigned long long)std::min<uint64_t>(mtime > 0 ? mtime : 0, kOctalSizeMax));
+    h[156] = type;
+    memcpy(h + 157, link.data(), std::min<size_t>(link.size(), 100));
+    memcpy(h + 257, "ustar", 6);
+    memcpy(h + 263, "00", 2);
+    memset(h + 148, ' ', 8);
+    unsigned sum = 0;
+    for (size_t i = 0; i < kBlock; ++i) sum += (unsigned char)h[i];
+    snprintf(h + 148, 8, "%06o", sum);
+    _pending.append(h, kBlock);
+}
+
+int TarBuilder::StartItem(const Item& item) {
+    uint64_t size = 0;
+    if (item.type == '0') {
+        _fd = open((_root + "/" + item.rel).c_str(), O_RDONLY | O_CLOEXEC);
+        if (_fd < 0) return errno;
+        size = item.size;
+    }
+    AppendHeader(item.rel, item.type, item.mode, size, item.mtime, item.link);
+    _left = _size = size;
+    _cur = item.rel;
+    _last_pct = -1;
+    if (_fd >= 0 && _on_progress) { _on_progress(0, _cur); _last_pct = 0; }
+    return 0;
+}
+
+ssize_t TarBuilder::Read(char* buf, size_t len) {
+    if (_error) return -_error;
+    size_t out = 0;
+    while (out < len) {
+        if (_pending_pos < _pending.size()) {
+            const size_t take = std::min(len - out, _pending.size() - _pending_pos);
+            memcpy(buf + out, _pending.data() + _pending_pos, take);
+            _pending_pos += take;
+            out += take;
+            continue;
+        }
+        _pending.clear();
+        _pending_pos = 0;
+
+        if (_fd >= 0) {
+            if (_left > 0) {
+                const size_t want = (size_t)std::min<uint64_t>(len - out, _left);
+                ssize_t n = read(_fd, buf + out, want);
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0) return -errno;
+                if (n == 0) {
+                    // Shrank since the walk: the header promised _left more bytes, so pad with zeros.
+                    memset(buf + out, 0, want);
+                    n = (ssize_t)want;
+                }
+                out += (size_t)n;
+                _left -= (uint64_t)n;
+                if (_on_progress && _size > 0) {
+                    const int pct = (int)(((_size - _left) * 100) / _size);
+                    if (pct != _last_pct) { _last_pct = pct; _on_progress(pct, _cur); }
+                }
+                continue;
+            }
+            ::close(_fd);
+            _fd = -1;
+            _pending.append((kBlock - _size % kBlock) % kBlock, '\0');
+            if (_on_progress && _last_pct != 100) _on_progress(100, _cur);
+            continue;
+        }
+
+        if (_next < _items.size()) {
+            if (int rc = StartItem(_items[_next++])) return -rc;
+            continue;
+        }
+        if (!_trailer) {
+            _trailer = true;
+            _pending.assign(2 * kBlock, '\0');
+            continue;
+        }
+        break;
+    }
+    return (ssize_t)out;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+// Standard library includes
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+// System includes
+#include <sys/types.h>
+
+
+// Streaming ustar for bulk transfers of many small files: one `tar` stream instead of a sync request per file.
+// Both sides report per-file progress as (percent, path relative to the tree root), like adb's -p output.
+using TarProgressFn = std::function<void(int, const std::string&)>;
+
+// Unpacks a `tar -c` stream into `root` as it arrives. Handles ustar, GNU long names and pax path/size records;
+// leading "/" is dropped, ".." components and paths through an extracted symlink are refused, device nodes/fifos skipped.
+class TarExtractor {
+public:
+    TarExtractor(const std::string& root, const TarProgressFn& on_progress = {});
+    ~TarExtractor();
+
+    TarExtractor(const TarExtractor&) = delete;
+    TarExtractor& operator=(const TarExtractor&) = delete;
+
+    // 0 or errno; the extractor is unusable after an error.
+    int Feed(const char* data, size_t len);
+    // EIO if the stream stopped inside an entry.
+    int Finish();
+    // Any header seen — lets the caller tell "no tar on device" from "tar failed halfway".
+    bool Started() const { return _started; }
+
+private:
+    enum class State { HEADER, DATA, PADDING, END };
+
+    std::string _root;
+    TarProgressFn _on_progress;
+    State _state = State::HEADER;
+    bool _started = false;
+    char _block[512];
+    size_t _block_fill = 0;
+
+    // Current entry
+    char _type = 0;
+    std::string _path;
+    std::string _link;
+    uint32_t _mode = 0;
+    int64_t _mtime = 0;
+    uint64_t _size = 0;
+    uint64_t _left = 0;
+    uint64_t _padding = 0;
+    int _fd = -1;
+    int _last_pct = -1;
+    // GNU 'L'/'K' and pax 'x' bodies are collected here, then override the next header.
+    std::string _meta;
+    std::string _next_path, _next_link;
+    bool _have_next_size = false;
+    uint64_t _next_size = 0;
+
+    int OnHeader();
+    int BeginEntry();
+    int OnData(const char* data, size_t len);
+    int EndEntry();
+    void ApplyPax(const std::string& records);
+};
+
+// Produces a tar stream of a host tree (contents of `root`, names relative to it) on demand, for `tar -x` on the device.
+// Directories are included, so empty ones arrive too; symlinks are stored as links.
+class TarBuilder {
+public:
+    TarBuilder(const std::string& root, const TarProgressFn& on_progress = {});
+    ~TarBuilder();
+
+    TarBuilder(const TarBuilder&) = delete;
+    TarBuilder& operator=(const TarBuilder&) = delete;
+
+    // Next chunk of the archive into buf: bytes written, 0 at the end, -errno on a host read error.
+    ssize_t Read(char* buf, size_t len);
+    // errno of the first unreadable directory or entry met while walking the tree; Read() fails with it too.
+    int Error() const { return _error; }
+
+private:
+    struct Item {
+        std::string rel;
+        char type;
+        uint32_t mode;
+        uint64_t size;
+        int64_t mtime;
+        std::string link;
+    };
+
+    std::string _root;
+    TarProgressFn _on_progress;
+    std::vector<Item> _items;
+    size_t _next = 0;
+    std::string _pending;      // header/padding bytes not handed out yet
+    size_t _pending_pos = 0;
+    int _fd = -1;
+    uint64_t _left = 0;
+    uint64_t _size = 0;
+    std::string _cur;
+    int _last_pct = -1;
+    bool _trailer = false;
+    int _error = 0;
+
+    int Walk(const std::string& path, const std::string& rel);
+    int StartItem(const Item& item);
+    void AppendHeader(const std::string& name, char type, uint32_t mode, uint64_t size, int64_t mtime,
+                      const std::string& link);
+};
@@ -7,6 +7,8 @@
 // Local includes
 #include "ADBPlugin.h"
 #include "ADBLog.h"
+#include "ADBStats.h"
+#include "ADBDialogs.h"
 #include "FARPlugin.h"
 #include "lng.h"
 
@@ -29,6 +31,7 @@ SHAREDSYMBOL void WINAPI SetStartupInfoW(const PluginStartupInfo *Info)
 			g_FSF = *(Info->FSF);
 			g_Info.FSF = &g_FSF;
 		}
+		ADBDialogs::LoadSettings();
 	}
 }
 
@@ -47,9 +50,10 @@ SHAREDSYMBOL void WINAPI GetPluginInfoW(PluginInfo *Info)
 	static const wchar_t *s_menu_strings[] = {Lng(MPluginTitle)};
 	Info->PluginMenuStrings = s_menu_strings;
 	Info->PluginMenuStringsNumber = 1;
-	// No PluginConfigStrings — plugin has no settings; hide from F9 → Options → Plugins.
-	Info->PluginConfigStrings = nullptr;
-	Info->PluginConfigStringsNumber = 0;
+	// Two configuration entries: transfer settings (compression, verify) and timing/throughput statistics.
+	static const wchar_t *s_config_strings[] = {Lng(MConfigTitle), Lng(MStatsTitle)};
+	Info->PluginConfigStrings = s_config_strings;
+	Info->PluginConfigStringsNumber = ARRAYSIZE(s_config_strings);
 	static const wchar_t *s_command_prefix = L"adb";
 	Info->CommandPrefix = s_command_prefix;
 }
@@ -130,6 +134,10 @@ SHAREDSYMBOL int WINAPI ProcessEventW(HANDLE hPlugin, int Event, void *Param)
 				return plugin->ProcessEventCommand((const wchar_t *)Param, hPlugin);
 			}
 			break;
+		case FE_REDRAW:
+		case FE_IDLE:
+			((ADBPlugin*)hPlugin)->ProcessEventIdle();
+			break;
 		default:
 			;
 	}
@@ -231,12 +239,20 @@ SHAREDSYMBOL int WINAPI ExecuteW(HANDLE hPlugin, PluginPanelItem *PanelItem, int
 SHAREDSYMBOL int WINAPI ConfigureW(int ItemNumber)
 {
 	DBG("ConfigureW called: ItemNumber=%d\n", ItemNumber);
+	if (ItemNumber == 0) {
+		return ADBDialogs::Configure() ? 1 : 0;
+	}
+	ADBDialogs::ShowStatistics();
 	return 0;
 }
 
 SHAREDSYMBOL void WINAPI ExitFARW()
 {
 	DBG("ExitFARW called\n");
+	const char *stats_path = getenv("FAR2L_ADB_STATS");
+	if (stats_path && *stats_path) {
+		ADBStats::AppendReport(stats_path);
+	}
 }
 
 SHAREDSYMBOL int WINAPI MayExitFARW()
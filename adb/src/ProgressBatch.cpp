@@ -5,6 +5,8 @@
 #include <farplug-wide.h>
 #include <windows.h>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
 using ADBUtils::PathBasename;
 
@@ -18,6 +20,16 @@ void NudgeDialog()
 	WINPORT(WriteConsoleInput)(0, &ir, 1, &dw);
 }
 
+// CAS upward only; true if this call moved the value.
+bool RaiseTo(std::atomic<uint64_t>& a, uint64_t v)
+{
+	uint64_t prev = a.load();
+	while (v > prev) {
+		if (a.compare_exchange_weak(prev, v)) return true;
+	}
+	return false;
+}
+
 }  // namespace
 
 uint64_t LookupSubitemSize(
@@ -54,12 +66,37 @@ BuildSubitemIndex(const std::unordered_map<std::string, uint64_t>& file_sizes)
 	return idx;
 }
 
-ProgressTracker::ProgressTracker(ProgressState& state,
-                                 uint64_t bytes_before, uint64_t files_before,
+std::pair<uint64_t, uint64_t> BatchProgress::SumLocked() const
+{
+	uint64_t bytes = _done_bytes, files = _done_files;
+	for (const auto& f : _inflight) {
+		bytes += f.first;
+		files += f.second;
+	}
+	return {bytes, files};
+}
+
+std::pair<uint64_t, uint64_t> BatchProgress::Publish(size_t lane, uint64_t bytes, uint64_t files)
+{
+	std::lock_guard<std::mutex> lk(_mtx);
+	_inflight[lane] = {bytes, files};
+	return SumLocked();
+}
+
+std::pair<uint64_t, uint64_t> BatchProgress::Commit(size_t lane, uint64_t bytes, uint64_t files)
+{
+	std::lock_guard<std::mutex> lk(_mtx);
+	_done_bytes += bytes;
+	_done_files += files;
+	_inflight[lane] = {0, 0};
+	return SumLocked();
+}
+
+ProgressTracker::ProgressTracker(ProgressState& state, BatchProgress& batch, size_t lane,
                                  uint64_t unit_bytes, uint64_t unit_files)
 	: _state(state),
-	  _bytes_before(bytes_before),
-	  _files_before(files_before),
+	  _batch(batch),
+	  _lane(lane),
 	  _unit_bytes(unit_bytes),
 	  _unit_files(unit_files)
 {}
@@ -108,7 +145,6 @@ void ProgressTracker::Tick(int percent, const std::string& sub_path, uint64_t su
 	uint64_t in_progress = (!_cur_counted && _cur_size > 0) ? (_cur_size * percent) / 100 : 0;
 	uint64_t this_unit = _bytes_done + in_progress;
 	if (_unit_bytes > 0 && this_unit > _unit_bytes) this_unit = _unit_bytes;
-	const uint64_t total_bytes_now = _bytes_before + this_unit;
 
 	// Bytes-derived file count smooths the counter when adb -p skips per-file emits.
 	uint64_t bytes_est_files = 0;
@@ -116,23 +152,19 @@ void ProgressTracker::Tick(int percent, const std::string& sub_path, uint64_t su
 		bytes_est_files = (_unit_files * this_unit) / _unit_bytes;
 		if (bytes_est_files > _unit_files) bytes_est_files = _unit_files;
 	}
-	uint64_t cnt = _files_before + std::max<uint64_t>(_files_done, bytes_est_files);
-	if (_unit_files > 0 && cnt > _files_before + _unit_files) cnt = _files_before + _unit_files;
+	uint64_t unit_cnt = std::max<uint64_t>(_files_done, bytes_est_files);
+	if (_unit_files > 0 && unit_cnt > _unit_files) unit_cnt = _unit_files;
+
+	// Other lanes' in-flight units contribute to the same totals.
+	const auto agg = _batch.Publish(_lane, this_unit, unit_cnt);
+	const uint64_t total_bytes_now = agg.first;
+	const uint64_t cnt = agg.second;
 
 	// All three monotonic — CAS upward only (no jumps back from glitches/stale values).
-	uint64_t prev_count = _state.count_complete.load();
-	bool count_advanced = false;
-	while (cnt > prev_count && !_state.count_complete.compare_exchange_weak(prev_count, cnt)) {}
-	if (cnt > prev_count) count_advanced = true;  // we won the CAS
+	const bool count_advanced = RaiseTo(_state.count_complete, cnt);
 	// Bump count_total only when we have a real total — otherwise the "of N" grows in lockstep with count_complete.
-	if (_state.all_total.load() > 0) {
-		uint64_t total_prev = _state.count_total.load();
-		while (cnt > total_prev && !_state.count_total.compare_exchange_weak(total_prev, cnt)) {}
-	}
-	uint64_t bytes_prev = _state.all_complete.load();
-	bool bytes_advanced = false;
-	while (total_bytes_now > bytes_prev && !_state.all_complete.compare_exchange_weak(bytes_prev, total_bytes_now)) {}
-	if (total_bytes_now > bytes_prev) bytes_advanced = true;
+	if (_state.all_total.load() > 0) RaiseTo(_state.count_total, cnt);
+	const bool bytes_advanced = RaiseTo(_state.all_complete, total_bytes_now);
 
 	// Log only on real state movement — keeps log readable on busy adb -p emit streams.
 	if (path_changed || credited_100 || count_advanced || bytes_advanced) {
@@ -187,7 +219,8 @@ bool ProgressTracker::Aborted() const
 BatchResult RunBatch(const std::wstring& title,
                      const std::wstring& source_label,
                      const std::wstring& dest_label,
-                     std::vector<WorkUnit> units)
+                     std::vector<WorkUnit> units,
+                     size_t lanes)
 {
 	BatchResult result;
 	if (units.empty()) return result;
@@ -200,9 +233,10 @@ BatchResult RunBatch(const std::wstring& title,
 		if (u.is_directory) any_dir = true;
 	}
 	const bool is_multi = units.size() > 1 || totalFiles > 1 || any_dir;
+	lanes = std::max<size_t>(1, std::min(lanes, units.size()));
 
-	DBG("RunBatch START units=%zu totalBytes=%llu totalFiles=%llu any_dir=%d\n",
-		units.size(), (unsigned long long)totalBytes, (unsigned long long)totalFiles, any_dir);
+	DBG("RunBatch START units=%zu lanes=%zu totalBytes=%llu totalFiles=%llu any_dir=%d\n",
+		units.size(), lanes, (unsigned long long)totalBytes, (unsigned long long)totalFiles, any_dir);
 
 	ProgressOperation op(title, is_multi);
 	op.GetState().all_total = totalBytes;
@@ -211,74 +245,98 @@ BatchResult RunBatch(const std::wstring& title,
 	op.GetState().dest_path = dest_label;
 
 	op.Run([&](ProgressState& state) {
-		uint64_t bytes_done = 0, files_done = 0;
-		size_t unit_idx = 0;
-		try {
-			for (auto& u : units) {
-				if (state.ShouldAbort()) { result.aborted = true; break; }
-
-				DBG("UNIT[%zu/%zu] START name='%ls' dir=%d bytes=%llu files=%llu | "
-					"before bytes=%llu files=%llu\n",
-					++unit_idx, units.size(), u.display_name.c_str(), u.is_directory,
-					(unsigned long long)u.total_bytes, (unsigned long long)u.total_files,
-					(unsigned long long)bytes_done, (unsigned long long)files_done);
-
-				{
-					std::lock_guard<std::mutex> lk(state.mtx_strings);
-					state.current_file = u.display_name;
-				}
-				state.is_directory = u.is_directory;
-				state.file_complete = 0;
-				state.file_total = u.total_bytes;
-
-				ProgressTracker tr(state, bytes_done, files_done,
-				                   u.total_bytes, u.total_files);
-				int r = u.execute ? u.execute(tr) : 0;
-
-				if (tr.Skipped()) {
-					DBG("UNIT[%zu] SKIP\n", unit_idx);
-				} else if (r == 0 && !state.ShouldAbort()) {
-					++result.success_count;
-					bytes_done += u.total_bytes;
-					files_done += u.total_files;
-					state.file_complete = 100;
-					state.all_complete = bytes_done;
-					state.count_complete = files_done;
-					DBG("UNIT[%zu] OK expected=%llu emitted=%llu credited=%llu bytes_credited=%llu/%llu | "
-						"cumul bytes=%llu/%llu files=%llu/%llu\n",
-						unit_idx,
-						(unsigned long long)u.total_files,
-						(unsigned long long)tr.EmittedPaths(),
-						(unsigned long long)tr.FilesDone(),
-						(unsigned long long)tr.BytesDone(), (unsigned long long)u.total_bytes,
-						(unsigned long long)bytes_done, (unsigned long long)totalBytes,
-						(unsigned long long)files_done, (unsigned long long)totalFiles);
-					if (tr.EmittedPaths() < u.total_files) {
-						DBG("UNIT[%zu] WARN adb -p emitted only %llu of %llu expected files (missing %llu)\n",
-							unit_idx, (unsigned long long)tr.EmittedPaths(),
+		BatchProgress batch(lanes);
+		std::atomic<size_t> next_unit{0};
+		std::mutex mtx_result;
+
+		// Lanes pull the next unit index until the list (or the user's patience) runs out.
+		auto lane_main = [&](size_t lane) {
+			try {
+				for (;;) {
+					if (state.ShouldAbort()) break;
+					const size_t unit_idx = next_unit.fetch_add(1);
+					if (unit_idx >= units.size()) break;
+					auto& u = units[unit_idx];
+
+					DBG("UNIT[%zu/%zu] START lane=%zu name='%ls' dir=%d bytes=%llu files=%llu\n",
+						unit_idx + 1, units.size(), lane, u.display_name.c_str(), u.is_directory,
+						(unsigned long long)u.total_bytes, (unsigned long long)u.total_files);
+
+					{
+						std::lock_guard<std::mutex> lk(state.mtx_strings);
+						state.current_file = u.display_name;
+					}
+					state.is_directory = u.is_directory;
+					state.file_complete = 0;
+					state.file_total = u.total_bytes;
+
+					ProgressTracker tr(state, batch, lane, u.total_bytes, u.total_files);
+					int r = u.execute ? u.execute(tr) : 0;
+
+					if (tr.Skipped()) {
+						batch.Commit(lane, 0, 0);
+						DBG("UNIT[%zu] SKIP\n", unit_idx + 1);
+					} else if (r == 0 && !state.ShouldAbort()) {
+						const auto agg = batch.Commit(lane, u.total_bytes, u.total_files);
+						{
+							std::lock_guard<std::mutex> lk(mtx_result);
+							++result.success_count;
+						}
+						state.file_complete = 100;
+						RaiseTo(state.all_complete, agg.first);
+						RaiseTo(state.count_complete, agg.second);
+						DBG("UNIT[%zu] OK expected=%llu emitted=%llu credited=%llu bytes_credited=%llu/%llu | "
+							"cumul bytes=%llu/%llu files=%llu/%llu\n",
+							unit_idx + 1,
 							(unsigned long long)u.total_files,
-							(unsigned long long)(u.total_files - tr.EmittedPaths()));
+							(unsigned long long)tr.EmittedPaths(),
+							(unsigned long long)tr.FilesDone(),
+							(unsigned long long)tr.BytesDone(), (unsigned long long)u.total_bytes,
+							(unsigned long long)agg.first, (unsigned long long)totalBytes,
+							(unsigned long long)agg.second, (unsigned long long)totalFiles);
+						if (tr.EmittedPaths() < u.total_files) {
+							DBG("UNIT[%zu] WARN adb -p emitted only %llu of %llu expected files (missing %llu)\n",
+								unit_idx + 1, (unsigned long long)tr.EmittedPaths(),
+								(unsigned long long)u.total_files,
+								(unsigned long long)(u.total_files - tr.EmittedPaths()));
+						}
+					} else {
+						batch.Commit(lane, 0, 0);
+						if (r != 0) {
+							std::lock_guard<std::mutex> lk(mtx_result);
+							result.last_error = r;
+						}
+						DBG("UNIT[%zu] ERR rc=%d emitted=%llu credited=%llu\n", unit_idx + 1, r,
+							(unsigned long long)tr.EmittedPaths(), (unsigned long long)tr.FilesDone());
 					}
-				} else if (r != 0) {
-					result.last_error = r;
-					DBG("UNIT[%zu] ERR rc=%d emitted=%llu credited=%llu\n", unit_idx, r,
-						(unsigned long long)tr.EmittedPaths(), (unsigned long long)tr.FilesDone());
 				}
+			} catch (const std::exception& ex) {
+				DBG("RunBatch lane %zu exception: %s\n", lane, ex.what());
+				std::lock_guard<std::mutex> lk(mtx_result);
+				result.last_error = EIO;
+				state.SetAborting();
+			} catch (...) {
+				DBG("RunBatch lane %zu: unknown exception\n", lane);
+				std::lock_guard<std::mutex> lk(mtx_result);
+				result.last_error = EIO;
+				state.SetAborting();
 			}
-			if (state.ShouldAbort()) result.aborted = true;
-			DBG("RunBatch END success=%d aborted=%d last_err=%d final state.bytes=%llu/%llu cnt=%llu/%llu\n",
-				result.success_count, result.aborted, result.last_error,
-				(unsigned long long)state.all_complete.load(), (unsigned long long)state.all_total.load(),
-				(unsigned long long)state.count_complete.load(), (unsigned long long)state.count_total.load());
-		} catch (const std::exception& ex) {
-			DBG("RunBatch worker exception: %s\n", ex.what());
-			result.last_error = EIO;
-			state.SetAborting();
-		} catch (...) {
-			DBG("RunBatch worker: unknown exception\n");
-			result.last_error = EIO;
-			state.SetAborting();
+		};
+
+		// Lane 0 runs on the operation's worker; the rest get their own threads.
+		std::vector<std::thread> extra;
+		extra.reserve(lanes - 1);
+		for (size_t lane = 1; lane < lanes; ++lane) {
+			extra.emplace_back(lane_main, lane);
 		}
+		lane_main(0);
+		for (auto& t : extra) t.join();
+
+		if (state.ShouldAbort()) result.aborted = true;
+		DBG("RunBatch END success=%d aborted=%d last_err=%d final state.bytes=%llu/%llu cnt=%llu/%llu\n",
+			result.success_count, result.aborted, result.last_error,
+			(unsigned long long)state.all_complete.load(), (unsigned long long)state.all_total.load(),
+			(unsigned long long)state.count_complete.load(), (unsigned long long)state.count_total.load());
 	});
 
 	return result;
@@ -2,11 +2,12 @@
 
 #include "ADBDialogs.h"
 #include <functional>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
-// Multi-item driver: RunBatch walks WorkUnits; all progress arithmetic lives in ProgressTracker (sole writer of state.all_complete).
+// Multi-item driver: RunBatch spreads WorkUnits over N lanes; all progress arithmetic lives in ProgressTracker (sole writer of state.all_complete).
 
 struct WorkUnit
 {
@@ -17,12 +18,31 @@ struct WorkUnit
 	std::function<int(class ProgressTracker&)> execute;
 };
 
+// Cross-lane totals: bytes/files of finished units + each lane's in-flight share of its current unit.
+class BatchProgress
+{
+public:
+	explicit BatchProgress(size_t lanes) : _inflight(lanes) {}
+
+	// Replace lane's in-flight share; returns aggregate {bytes, files} across all lanes.
+	std::pair<uint64_t, uint64_t> Publish(size_t lane, uint64_t bytes, uint64_t files);
+	// Unit on `lane` finished — fold credited totals into done, clear its in-flight share.
+	std::pair<uint64_t, uint64_t> Commit(size_t lane, uint64_t bytes, uint64_t files);
+
+private:
+	std::mutex _mtx;
+	uint64_t _done_bytes = 0;
+	uint64_t _done_files = 0;
+	std::vector<std::pair<uint64_t, uint64_t>> _inflight;
+
+	std::pair<uint64_t, uint64_t> SumLocked() const;
+};
+
 // Sub-progress reporter. Tick advances bytes/count on path-change; TickDisplayOnly only updates filename + bar.
 class ProgressTracker
 {
 public:
-	ProgressTracker(ProgressState& state,
-	                uint64_t bytes_before, uint64_t files_before,
+	ProgressTracker(ProgressState& state, BatchProgress& batch, size_t lane,
 	                uint64_t unit_bytes, uint64_t unit_files);
 
 	void Tick(int percent, const std::string& sub_path, uint64_t sub_size);
@@ -39,13 +59,15 @@ public:
 	// Keeps modal alive at near-100% during opaque shell ops (cp/mv) without progress.
 	static constexpr int kPinPercent = 99;
 	void PinNearDone() { _state.file_complete = kPinPercent; }
+	// Compressed sync traffic (payload vs wire bytes) for the dialog's ratio; safe from any lane.
+	void AddWire(uint64_t payload, uint64_t wire) { _state.wire_payload += payload; _state.wire_bytes += wire; }
 	// Escape hatch: raw state access for UI helpers like CheckOverwrite.
 	ProgressState& StateRef() { return _state; }
 
 private:
 	ProgressState& _state;
-	uint64_t _bytes_before;
-	uint64_t _files_before;
+	BatchProgress& _batch;
+	size_t _lane;
 	uint64_t _unit_bytes;
 	uint64_t _unit_files;
 	std::string _cur_path;
@@ -65,10 +87,12 @@ struct BatchResult
 	bool aborted = false;
 };
 
+// lanes > 1: units run concurrently (execute must be thread-safe; modal prompts go through state.mtx_prompt).
 BatchResult RunBatch(const std::wstring& title,
                      const std::wstring& source_label,
                      const std::wstring& dest_label,
-                     std::vector<WorkUnit> units);
+                     std::vector<WorkUnit> units,
+                     size_t lanes = 1);
 
 // Resolve adb's emitted path → size via basename → [(rel_path, size)] index, suffix-match on collisions. 0 on miss.
 uint64_t LookupSubitemSize(
@@ -113,6 +113,69 @@ enum ADBLng
     MUnknownError,          // "unknown error"
     MDeleteFolderTitle,     // "Delete folder"
     MItemsSuffix,           // " items"
+
+    // Directory listing
+    MReadDirTitle,          // "Read directory"
+    MReadingDirEntries,     // "Reading directory entries"
+
+    // Progress dialog
+    MCompressedTo,          // "Compressed to"
+
+    // Folder sync (Ctrl+Shift+F5)
+    MSyncTitle,             // "Synchronize folders"
+    MSyncDeviceToHost,      // "Device → &host"
+    MSyncHostToDevice,      // "Host → &device"
+    MSyncComparing,         // "Comparing folders"
+    MSyncNeedsHostPanel,    // "The other panel must show a host folder"
+    MSyncUpToDate,          // "Folders are already in sync"
+    MSyncNewFiles,          // "New files:"
+    MSyncChangedFiles,      // "Changed files:"
+    MSyncExtraFiles,        // "Only at destination:"
+    MSyncToTransfer,        // "To transfer:"
+    MSyncRun,               // "&Sync"
+    MSyncRunDelete,         // "Sync, &delete extras"
+    MSyncFailed,            // "Sync finished with errors"
+    MSyncIncomplete,        // "Some folders could not be read — nothing will be deleted"
+
+    // Device-side search (Alt+F7)
+    MFindTitle,             // "Find file on device"
+    MFindMasks,             // "File &mask(s), separated by commas:"
+    MFindText,              // "&Containing text:"
+    MFindCaseSensitive,     // "Case &sensitive"
+    MFindMinSize,           // "Larger than, KiB:"
+    MFindMaxSize,           // "Smaller than, KiB:"
+    MFindDays,              // "Modified within, days:"
+    MFindBtn,               // "&Find"
+    MFindSearching,         // "Searching on device"
+    MFindFound,             // "Found: "
+    MFindResultsBottom,     // "Enter - go to file"
+    MFindNothing,           // "No files found"
+    MFindInterrupted,       // "Search was interrupted; results are incomplete"
+
+    // Statistics (F9 → Options → Plugins configuration)
+    MStatsTitle,            // "ADB statistics"
+    MStatsSave,             // "&Save"
+    MStatsReset,            // "&Reset"
+    MStatsSaved,            // "Statistics appended to"
+    MStatsSaveFailed,       // "Cannot write statistics to"
+
+    // Device selector fan-out (marked devices)
+    MFanOutPushTitle,       // "Copy to devices"
+    MFanOutPushPrompt,      // "Copy to this folder on every device:"
+    MFanOutDeleteTitle,     // "Delete on devices"
+    MFanOutDeletePrompt,    // "Delete this path on every device:"
+    MFanOutAbsolutePath,    // "Enter an absolute device path other than /"
+    MFanOutShellTitle,      // "Run on devices"
+    MFanOutDevices,         // "Devices: "
+    MFanOutOk,              // "OK"
+    MFanOutFailedCount,     // "failed: "
+    MFanOutNotRun,          // "not run"
+
+    // Settings (F9 → Options → Plugins configuration)
+    MConfigTitle,           // "ADB"
+    MConfigCompress,        // "&Compress transfers when the device supports it"
+    MConfigEnvNote,         // "FAR2L_ADB_* environment variables, when set, take precedence"
+    MConfigVerify,          // "&Verify transferred files with the device's md5sum"
 };
 
 inline const wchar_t* Lng(ADBLng id)
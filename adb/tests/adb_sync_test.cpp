@@ -0,0 +1,188 @@
+// adb_sync_test: ADBSocket's sync client (STAT/LIST/SEND/RECV) and the device tracker against
+// tests/fake_adb_server.py, whose "device" is this host. Run through the fake server, which points ADB_SERVER_SOCKET at itself:
+//
+//   fake_adb_server.py adb_sync_test
+
+// Standard library includes
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+// System includes
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+// Local includes
+#include "ADBSocket.h"
+#include "ADBDeviceList.h"
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+        ++g_failures; \
+    } \
+} while (0)
+
+bool WriteFile(const std::string& path, const std::string& body) {
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    const bool ok = write(fd, body.data(), body.size()) == (ssize_t)body.size();
+    return (close(fd) == 0) && ok;
+}
+
+std::string ReadFile(const std::string& path) {
+    std::string out;
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return "<missing>";
+    char buf[4096];
+    for (ssize_t n; (n = read(fd, buf, sizeof(buf))) > 0;) out.append(buf, (size_t)n);
+    close(fd);
+    return out;
+}
+
+std::string ReadLink(const std::string& path) {
+    char buf[PATH_MAX];
+    const ssize_t n = readlink(path.c_str(), buf, sizeof(buf));
+    return n < 0 ? std::string("<missing>") : std::string(buf, (size_t)n);
+}
+
+// Spans several DATA packets and isn't a multiple of the packet size.
+std::string BigBody() {
+    std::string out;
+    for (unsigned i = 0; out.size() < 200 * 1024 + 17; ++i) out += std::to_string(i) + ",";
+    return out;
+}
+
+void TestStatAndList(ADBSocket& sock, const std::string& dev) {
+    ADBSocket::Entry e;
+    CHECK(sock.statPath(dev + "/a.txt", e) == 0);
+    CHECK(S_ISREG(e.mode));
+    CHECK(e.size == 5);
+    CHECK(e.name == "a.txt");
+    CHECK(sock.statPath(dev + "/sub", e) == 0 && S_ISDIR(e.mode));
+    CHECK(sock.statPath(dev + "/missing", e) == ENOENT);
+
+    std::vector<ADBSocket::Entry> list;
+    CHECK(sock.listDir(dev, list) == 0);
+    std::vector<std::string> names;
+    for (const auto& it : list) names.push_back(it.name);
+    std::sort(names.begin(), names.end());
+    CHECK((names == std::vector<std::string>{"a.txt", "big.bin", "sub"}));
+}
+
+void TestPull(ADBSocket& sock, const std::string& dev, const std::string& host) {
+    CHECK(sock.pull(dev + "/a.txt", host + "/a.txt") == 0);
+    CHECK(ReadFile(host + "/a.txt") == "hello");
+
+    // Whole tree into a new local path, nested files included.
+    CHECK(sock.pull(dev, host + "/tree") == 0);
+    CHECK(ReadFile(host + "/tree/big.bin") == BigBody());
+    CHECK(ReadFile(host + "/tree/sub/b.txt") == "nested");
+
+    CHECK(sock.pull(dev + "/missing", host + "/missing") == ENOENT);
+
+    // Esc on a resumable (>= 16 MiB) pull leaves neither the file nor its .adbpart behind.
+    const std::string huge = dev + "/huge.bin";
+    CHECK(WriteFile(huge, "") && truncate(huge.c_str(), 20 << 20) == 0);
+    bool started = false;
+    CHECK(sock.pull(huge, host + "/huge.bin", [&](int, const std::string&) { started = true; },
+                    [&] { return started; }) == ECANCELED);
+    struct stat st{};
+    CHECK(lstat((host + "/huge.bin").c_str(), &st) != 0);
+    CHECK(lstat((host + "/huge.bin.adbpart").c_str(), &st) != 0);
+    unlink(huge.c_str());
+}
+
+void TestPush(ADBSocket& sock, const std::string& src, const std::string& dev) {
+    // Into an existing directory: the item lands under its basename, like `adb push`.
+    std::vector<std::string> empty_dirs;
+    CHECK(sock.push(src, dev, {}, {}, &empty_dirs) == 0);
+    const std::string dst = dev + "/src";
+    CHECK(ReadFile(dst + "/c.txt") == "pushed");
+    CHECK(ReadFile(dst + "/deep/d.txt") == "deeper");
+    CHECK(ReadFile(dst + "/deep/big.bin") == BigBody());
+    CHECK(ReadLink(dst + "/link") == "c.txt");
+    CHECK((empty_dirs == std::vector<std::string>{dst + "/empty"}));
+
+    // Single file to a new path.
+    CHECK(sock.push(src + "/c.txt", dev + "/renamed.txt") == 0);
+    CHECK(ReadFile(dev + "/renamed.txt") == "pushed");
+
+    CHECK(sock.push(src + "/missing", dev + "/x") == ENOENT);
+
+    // An unreadable subdirectory fails the whole push instead of being skipped (root reads everything).
+    if (geteuid() != 0) {
+        const std::string locked = src + "/locked";
+        mkdir(locked.c_str(), 0755);
+        WriteFile(locked + "/e.txt", "hidden");
+        chmod(locked.c_str(), 0);
+        CHECK(sock.push(src, dev + "/again") == EACCES);
+        chmod(locked.c_str(), 0755);
+    }
+}
+
+// The fake server drops the first track-devices stream: the tracker must notice the lost list, reconnect and see the
+// new one.
+void TestTrackerReconnect() {
+    ADBDeviceTracker tracker;
+    CHECK(tracker.Start());
+    for (int i = 0; i < 100 && tracker.Generation() < 2; ++i) usleep(50 * 1000);
+    CHECK(tracker.Generation() >= 2);
+}
+
+} // namespace
+
+int main() {
+    if (!getenv("ADB_SERVER_SOCKET")) {
+        fprintf(stderr, "run through fake_adb_server.py\n");
+        return 2;
+    }
+    char tmpl[] = "/tmp/adb_sync_test.XXXXXX";
+    if (!mkdtemp(tmpl)) {
+        perror("mkdtemp");
+        return 2;
+    }
+    const std::string work = tmpl;
+    const std::string dev = work + "/device", host = work + "/host", src = work + "/src";
+    mkdir(dev.c_str(), 0755);
+    mkdir((dev + "/sub").c_str(), 0755);
+    mkdir(host.c_str(), 0755);
+    mkdir(src.c_str(), 0755);
+    mkdir((src + "/deep").c_str(), 0755);
+    mkdir((src + "/empty").c_str(), 0755);
+    WriteFile(dev + "/a.txt", "hello");
+    WriteFile(dev + "/big.bin", BigBody());
+    WriteFile(dev + "/sub/b.txt", "nested");
+    WriteFile(src + "/c.txt", "pushed");
+    WriteFile(src + "/deep/d.txt", "deeper");
+    WriteFile(src + "/deep/big.bin", BigBody());
+    symlink("c.txt", (src + "/link").c_str());
+
+    const char* serial = getenv("FAKE_ADB_SERIAL");
+    ADBSocket sock(serial ? serial : "");
+    TestStatAndList(sock, dev);
+    TestPull(sock, dev, host);
+    TestPush(sock, src, dev);
+
+    // A session dropped in between is reopened by the next request.
+    sock.close();
+    ADBSocket::Entry e;
+    CHECK(sock.statPath(dev + "/a.txt", e) == 0);
+
+    TestTrackerReconnect();
+
+    const std::string cleanup = "rm -rf '" + work + "'";
+    if (system(cleanup.c_str()) != 0) fprintf(stderr, "cannot remove %s\n", work.c_str());
+    printf("%s\n", g_failures ? "FAILED" : "OK");
+    return g_failures ? 1 : 0;
+}
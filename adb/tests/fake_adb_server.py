@@ -0,0 +1,218 @@
+#!/usr/bin/env python3
+"""Stand-in adb *server* for adb_sync_test: speaks the smart-socket protocol on a local TCP port.
+
+The "device" is this host: sync paths are host paths. Serves host:features / host-serial:<s>:features,
+host:transport:<serial> / host:transport-any and, on top of it, sync: with STAT/STA2, LIST/LIS2, SEND, RECV and QUIT.
+host:track-devices sends one list and hangs up, like a server restart; the streams after it add a second device.
+FAKE_ADB_FEATURES sets the advertised feature list (default "stat_v2,ls_v2").
+
+  fake_adb_server.py COMMAND [ARGS...]   serves while COMMAND runs with ADB_SERVER_SOCKET pointing here, exits with its status
+"""
+
+import os
+import socket
+import stat
+import struct
+import subprocess
+import sys
+import threading
+import time
+
+SERIAL = os.environ.get("FAKE_ADB_SERIAL", "test-0001")
+FEATURES = os.environ.get("FAKE_ADB_FEATURES", "stat_v2,ls_v2")
+SYNC_DATA_MAX = 64 * 1024
+
+track_lock = threading.Lock()
+track_streams = 0
+
+
+def read_exact(conn, n):
+    buf = b""
+    while len(buf) < n:
+        chunk = conn.recv(n - len(buf))
+        if not chunk:
+            raise EOFError()
+        buf += chunk
+    return buf
+
+
+def read_request(conn):
+    return read_exact(conn, int(read_exact(conn, 4), 16)).decode()
+
+
+def hex_block(data):
+    return b"%04x" % len(data) + data
+
+
+def sync_fail(conn, err):
+    msg = os.strerror(err).encode()
+    conn.sendall(b"FAIL" + struct.pack("<I", len(msg)) + msg)
+
+
+def stat_v2_record(path):
+    try:
+        st = os.stat(path)
+    except OSError as e:
+        return b"STA2" + struct.pack("<I", e.errno) + b"\0" * 64
+    return b"STA2" + struct.pack("<IQQIIIIQqqq", 0, st.st_dev, st.st_ino, st.st_mode, st.st_nlink,
+                                 st.st_uid, st.st_gid, st.st_size, int(st.st_atime), int(st.st_mtime),
+                                 int(st.st_ctime))
+
+
+def stat_v1_record(path):
+    try:
+        st = os.lstat(path)
+    except OSError:
+        return b"STAT" + b"\0" * 12
+    return b"STAT" + struct.pack("<III", st.st_mode, st.st_size & 0xffffffff, int(st.st_mtime))
+
+
+def serve_list(conn, path, v2):
+    names = [".", ".."]
+    try:
+        names += sorted(os.listdir(path))
+    except OSError:
+        names = []
+    for name in names:
+        try:
+            st = os.lstat(os.path.join(path, name))
+        except OSError:
+            continue
+        raw = name.encode()
+        if v2:
+            conn.sendall(b"DNT2" + struct.pack("<IQQIIIIQqqqI", 0, st.st_dev, st.st_ino, st.st_mode, st.st_nlink,
+                                               st.st_uid, st.st_gid, st.st_size, int(st.st_atime),
+                                               int(st.st_mtime), int(st.st_ctime), len(raw)) + raw)
+        else:
+            conn.sendall(b"DENT" + struct.pack("<IIII", st.st_mode, st.st_size & 0xffffffff,
+                                               int(st.st_mtime), len(raw)) + raw)
+    conn.sendall(b"DONE" + b"\0" * (72 if v2 else 16))
+
+
+def serve_recv(conn, path):
+    try:
+        with open(path, "rb") as f:
+            while True:
+                data = f.read(SYNC_DATA_MAX)
+                if not data:
+                    break
+                conn.sendall(b"DATA" + struct.pack("<I", len(data)) + data)
+    except OSError as e:
+        sync_fail(conn, e.errno)
+        return
+    conn.sendall(b"DONE" + struct.pack("<I", 0))
+
+
+def serve_send(conn, path_mode):
+    path, _, mode = path_mode.rpartition(",")
+    mode = int(mode)
+    body = b""
+    while True:
+        ident = read_exact(conn, 4)
+        arg = struct.unpack("<I", read_exact(conn, 4))[0]
+        if ident == b"DATA":
+            body += read_exact(conn, arg)
+        elif ident == b"DONE":
+            mtime = arg
+            break
+        else:
+            raise EOFError()
+    try:
+        os.makedirs(os.path.dirname(path), exist_ok=True)
+        if stat.S_ISLNK(mode):
+            if os.path.lexists(path):
+                os.unlink(path)
+            os.symlink(body.decode(), path)
+        else:
+            with open(path, "wb") as f:
+                f.write(body)
+            os.chmod(path, stat.S_IMODE(mode))
+            os.utime(path, (mtime, mtime))
+    except OSError as e:
+        sync_fail(conn, e.errno)
+        return
+    conn.sendall(b"OKAY" + struct.pack("<I", 0))
+
+
+def serve_sync(conn):
+    while True:
+        ident = read_exact(conn, 4)
+        arg = read_exact(conn, struct.unpack("<I", read_exact(conn, 4))[0]).decode()
+        if ident == b"STA2":
+            conn.sendall(stat_v2_record(arg))
+        elif ident == b"STAT":
+            conn.sendall(stat_v1_record(arg))
+        elif ident in (b"LIST", b"LIS2"):
+            serve_list(conn, arg, ident == b"LIS2")
+        elif ident == b"RECV":
+            serve_recv(conn, arg)
+        elif ident == b"SEND":
+            serve_send(conn, arg)
+        else:
+            return
+
+
+def serve_track(conn):
+    global track_streams
+    with track_lock:
+        track_streams += 1
+        first = track_streams == 1
+    conn.sendall(b"OKAY")
+    listing = "%s\tdevice\n" % SERIAL
+    if not first:
+        listing += "%s-2\tdevice\n" % SERIAL
+    conn.sendall(hex_block(listing.encode()))
+    if first:
+        time.sleep(0.3)
+        return
+    while conn.recv(4096):
+        pass
+
+
+def serve(conn):
+    try:
+        service = read_request(conn)
+        if service == "host:track-devices":
+            serve_track(conn)
+            return
+        if service in ("host:features", "host-serial:%s:features" % SERIAL):
+            conn.sendall(b"OKAY" + hex_block(FEATURES.encode()))
+            return
+        if service not in ("host:transport-any", "host:transport:" + SERIAL):
+            conn.sendall(b"FAIL" + hex_block(b"device '" + service.encode() + b"' not found"))
+            return
+        conn.sendall(b"OKAY")
+        service = read_request(conn)
+        if service != "sync:":
+            conn.sendall(b"FAIL" + hex_block(b"unsupported service"))
+            return
+        conn.sendall(b"OKAY")
+        serve_sync(conn)
+    except (EOFError, OSError):
+        pass
+    finally:
+        conn.close()
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.stderr.write(__doc__)
+        return 2
+    listener = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    listener.bind(("127.0.0.1", 0))
+    listener.listen(16)
+
+    def accept_loop():
+        while True:
+            conn, _ = listener.accept()
+            threading.Thread(target=serve, args=(conn,), daemon=True).start()
+
+    threading.Thread(target=accept_loop, daemon=True).start()
+    env = dict(os.environ)
+    env["ADB_SERVER_SOCKET"] = "tcp:127.0.0.1:%d" % listener.getsockname()[1]
+    env.setdefault("FAKE_ADB_SERIAL", SERIAL)
+    return subprocess.call(sys.argv[1:], env=env)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
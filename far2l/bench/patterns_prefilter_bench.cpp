@@ -0,0 +1,185 @@
+// patterns_prefilter_bench: measures PatternsPrefilter used by Find File's FindPattern against per-pattern scanning
+// of same buffer, with patterns set similar to case-insensitive search of a word in several codepages.
+// Also checks that SIMD kernel yields exactly same candidates as plain tables one. Not a test: it prints numbers.
+//
+//   patterns_prefilter_bench [--mb N] [--word WORD] [--rounds N]
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <stdint.h>
+
+#include "PatternsPrefilter.h"
+
+namespace {
+
+struct Options {
+	size_t mb = 64;
+	std::string word = "needle";
+	unsigned rounds = 3;
+};
+
+typedef std::vector<uint8_t> Bytes;
+
+// Variants of word like FindPattern generates for "all codepages" case-insensitive search:
+// lower/upper case for single byte, UTF-16LE/BE and UTF-32LE encodings.
+std::vector<Bytes> MakeVariants(const std::string &word)
+{
+	std::vector<Bytes> out;
+	for (int upper = 0; upper < 2; ++upper) {
+		Bytes b8, b16le, b16be, b32le;
+		for (char c : word) {
+			const uint8_t ch = upper ? (uint8_t)toupper((unsigned char)c) : (uint8_t)tolower((unsigned char)c);
+			b8.push_back(ch);
+			b16le.insert(b16le.end(), {ch, 0});
+			b16be.insert(b16be.end(), {0, ch});
+			b32le.insert(b32le.end(), {ch, 0, 0, 0});
+		}
+		out.push_back(b8);
+		out.push_back(b16le);
+		out.push_back(b16be);
+		out.push_back(b32le);
+	}
+	return out;
+}
+
+Bytes MakeText(size_t size, const std::vector<Bytes> &variants)
+{
+	static const char alphabet[] = "abcdefghijklmnopqrstuvwxyz      ,.\nABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+	Bytes out(size);
+	uint32_t seed = 0x12345678;
+	for (auto &b : out) {
+		seed = seed * 1103515245 + 12345;
+		b = (uint8_t)alphabet[(seed >> 16) % (sizeof(alphabet) - 1)];
+	}
+	// sprinkle some real occurrences, one per megabyte
+	for (size_t pos = 0x80000, i = 0; pos + 64 < size; pos+= 0x100000, ++i) {
+		const auto &v = variants[i % variants.size()];
+		memcpy(&out[pos & ~size_t(3)], v.data(), v.size());
+	}
+	return out;
+}
+
+double Seconds(std::chrono::steady_clock::time_point since)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+}
+
+// Reference: each variant scanned separately byte-by-byte, like FindPattern did before prefilter
+size_t CountPerPattern(const Bytes &text, const std::vector<Bytes> &variants)
+{
+	size_t found = 0;
+	for (const auto &v : variants) {
+		for (size_t pos = 0; pos + v.size() <= text.size(); ++pos) {
+			if (text[pos] == v[0] && memcmp(&text[pos], v.data(), v.size()) == 0) {
+				++found;
+			}
+		}
+	}
+	return found;
+}
+
+size_t CountPrefiltered(const PatternsPrefilter &pf, const Bytes &text, const std::vector<Bytes> &variants,
+	size_t &candidates)
+{
+	size_t found = 0;
+	candidates = 0;
+	uint8_t buckets = 0;
+	for (size_t pos = 0; (pos = pf.NextCandidate(text.data(), text.size(), pos, buckets)) < text.size(); ++pos) {
+		++candidates;
+		for (size_t i = 0; i != variants.size(); ++i) {
+			const auto &v = variants[i];
+			if ((buckets & (1u << (i % PatternsPrefilter::BUCKETS))) && pos + v.size() <= text.size()
+					&& memcmp(&text[pos], v.data(), v.size()) == 0) {
+				++found;
+			}
+		}
+	}
+	return found;
+}
+
+bool SameCandidates(const PatternsPrefilter &a, const PatternsPrefilter &b, const Bytes &text)
+{
+	uint8_t buckets_a = 0, buckets_b = 0;
+	for (size_t pos_a = 0, pos_b = 0;; ++pos_a, ++pos_b) {
+		pos_a = a.NextCandidate(text.data(), text.size(), pos_a, buckets_a);
+		pos_b = b.NextCandidate(text.data(), text.size(), pos_b, buckets_b);
+		if (pos_a != pos_b || (pos_a < text.size() && buckets_a != buckets_b)) {
+			fprintf(stderr, "MISMATCH: %s at %lu/0x%x vs %s at %lu/0x%x\n",
+				a.KernelName(), (unsigned long)pos_a, buckets_a, b.KernelName(), (unsigned long)pos_b, buckets_b);
+			return false;
+		}
+		if (pos_a >= text.size()) {
+			return true;
+		}
+	}
+}
+
+void Report(const char *what, size_t bytes, double seconds, size_t found)
+{
+	printf("%-14s %8.1f MB/s  found=%lu\n", what, bytes / seconds / 1048576.0, (unsigned long)found);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	Options opt;
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--mb") == 0 && i + 1 < argc) {
+			opt.mb = (size_t)atol(argv[++i]);
+		} else if (strcmp(argv[i], "--word") == 0 && i + 1 < argc) {
+			opt.word = argv[++i];
+		} else if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) {
+			opt.rounds = (unsigned)atoi(argv[++i]);
+		} else {
+			fprintf(stderr, "Usage: %s [--mb N] [--word WORD] [--rounds N]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (opt.word.empty() || opt.mb == 0) {
+		fprintf(stderr, "Nothing to do\n");
+		return 1;
+	}
+
+	const auto variants = MakeVariants(opt.word);
+	const Bytes text = MakeText(opt.mb * 1048576, variants);
+
+	PatternsPrefilter scalar, simd;
+	for (size_t i = 0; i != variants.size(); ++i) {
+		const auto &v = variants[i];
+		scalar.AddLeadingPair(i % PatternsPrefilter::BUCKETS, v[0], v.size() > 1 ? v[1] : -1);
+		simd.AddLeadingPair(i % PatternsPrefilter::BUCKETS, v[0], v.size() > 1 ? v[1] : -1);
+	}
+	scalar.GetReady(false);
+	simd.GetReady(true);
+
+	printf("%lu MB, %lu patterns of '%s', kernel: %s, usable: %s\n", (unsigned long)opt.mb,
+		(unsigned long)variants.size(), opt.word.c_str(), simd.KernelName(), simd.Usable() ? "yes" : "no");
+
+	if (!SameCandidates(scalar, simd, text)) {
+		return 2;
+	}
+
+	for (unsigned round = 0; round < opt.rounds; ++round) {
+		auto start = std::chrono::steady_clock::now();
+		size_t found = CountPerPattern(text, variants);
+		Report("per-pattern", text.size(), Seconds(start), found);
+
+		size_t candidates = 0;
+		start = std::chrono::steady_clock::now();
+		found = CountPrefiltered(scalar, text, variants, candidates);
+		Report(scalar.KernelName(), text.size(), Seconds(start), found);
+
+		start = std::chrono::steady_clock::now();
+		found = CountPrefiltered(simd, text, variants, candidates);
+		Report(simd.KernelName(), text.size(), Seconds(start), found);
+		printf("candidates: %lu\n\n", (unsigned long)candidates);
+	}
+
+	return 0;
+}
@@ -2504,6 +2504,12 @@ directory tree. The value is used during file operations such as copying, deleti
 Enable to sum up the space occupied by files only. Disable to include directory overhead
 (space used to store the metadata of directories themselves) as well.
 
+  #Remember folders sizes for, seconds#
+  Folders sizes once measured are remembered for given number of seconds, so measuring them again
+(like by F3 or quick view) or measuring their parent folder doesn't need to scan whole tree again.
+Remembered size is used only if none of directories inside folder were changed since that, so it
+can be inexact only if some file changed its size in place. 0 disables remembering.
+
   #Inactivity time#
   Terminate FAR2L after a specified interval without keyboard or mouse activity. This works only if FAR2L waits for command line
 input without viewer or editor screens in the background.
@@ -2542,6 +2542,12 @@ $ #Системные параметры#
 Включите, чтобы суммировать пространство, занимаемое только файлами. Отключите, чтобы учитывать также накладные
 расходы на хранение метаданных самих директорий.
 
+  #Помнить размеры папок, секунд#
+  Однажды измеренные размеры папок запоминаются на заданное число секунд, так что повторное измерение
+(например по F3 или в быстром просмотре) или измерение родительской папки не требует заново сканировать всё дерево.
+Запомненный размер используется, только если ни одна директория внутри папки с тех пор не изменилась, так что
+он может быть неточным, только если какой-то файл изменил размер на месте. 0 отключает запоминание.
+
   #Время бездействия#
   Завершает работу FAR2L, если в течение указанного интервала не было нажатий клавиш мыши или клавиатуры,
 FAR2L ожидал ввода из командной строки и отсутствовали фоновые экраны редактирования или просмотра.
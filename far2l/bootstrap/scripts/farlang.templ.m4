@@ -1967,6 +1967,17 @@ upd:"Use only files size in estimation"
 "Враховувати лише розмір файлів"
 "Улічваць толькі памер файлаў"
 
+ConfigDirInfoCacheTTL
+"Помнить размеры папок, секунд"
+"Remember folders sizes for, seconds"
+upd:"Remember folders sizes for, seconds"
+upd:"Remember folders sizes for, seconds"
+upd:"Remember folders sizes for, seconds"
+upd:"Remember folders sizes for, seconds"
+upd:"Remember folders sizes for, seconds"
+"Пам'ятати розміри тек, секунд"
+"Памятаць памеры тэчак, секунд"
+
 ConfigScanJunction
 "Ск&анировать символические ссылки"
 "Scan s&ymbolic links"
@@ -61,6 +61,11 @@ public:
 			&& (_alt_cnt == 0 || memcmp(_alt, other._alt, _alt_cnt * sizeof(CodeUnitT)) == 0);
 	}
 
+	inline const CodeUnitT *BaseData() const noexcept { return _base; }
+	inline size_t BaseCnt() const noexcept { return _base_cnt; }
+	inline const CodeUnitT *AltData() const noexcept { return _alt; }
+	inline size_t AltCnt() const noexcept { return _alt_cnt; }
+
 	inline size_t Rewind() const noexcept
 	{
 		return _rew;
@@ -152,6 +157,10 @@ struct IScannedPattern
 	virtual const Metrics &GetMetrics() const noexcept = 0;
 	virtual size_t GetCapacity() const noexcept = 0;
 	virtual std::pair<size_t, size_t> FindMatch(const void *begin, size_t len, bool first_fragment, bool last_fragment) const noexcept = 0;
+	// returns length in bytes of match that starts exactly at pos or zero if there is no such match
+	virtual size_t MatchAt(const void *begin, size_t len, size_t pos, bool first_fragment, bool last_fragment) const noexcept = 0;
+	// two leading bytes of every possible matching content, negative second byte means any byte
+	virtual void GetLeadingPairs(std::vector<std::pair<uint8_t, int>> &pairs) const = 0;
 	virtual void AppendCodePoint(const void *base, size_t base_size, const void *alt, size_t alt_size) = 0;
 
 	// used to check for duplicated patterns
@@ -355,6 +364,63 @@ template <class CodePointT>
 			r * sizeof(CodeUnit));
 	}
 
+	virtual size_t MatchAt(const void *begin, size_t len, size_t pos, bool first_fragment, bool last_fragment) const noexcept
+	{
+		if (pos % sizeof(CodeUnit) != 0) {
+			return 0;
+		}
+
+		const CodeUnit *cu_begin = (const CodeUnit *)begin;
+		const CodeUnit *cu_end = cu_begin + len / sizeof(CodeUnit);
+		const CodeUnit *cu_start = cu_begin + pos / sizeof(CodeUnit);
+		const CodeUnit *cur = cu_start;
+		for (const auto &code_point : _seq) {
+			const size_t match = _case_sensitive
+				? code_point.MatchOnlyBase(cur, cu_end - cur)
+				: code_point.Match(cur, cu_end - cur);
+			if (!match) {
+				return 0;
+			}
+			cur+= match;
+		}
+
+		if (_whole_words) {
+			const bool left_div = (cu_start == cu_begin) ? first_fragment : IsCodeUnitDiv(*(cu_start - 1));
+			const bool right_div = (cur == cu_end) ? last_fragment : IsCodeUnitDiv(*cur);
+			if (!left_div || !right_div) {
+				return 0;
+			}
+		}
+
+		return (cur - cu_start) * sizeof(CodeUnit);
+	}
+
+	void AppendLeadingPair(std::vector<std::pair<uint8_t, int>> &pairs, const CodeUnit *data, size_t cnt) const
+	{
+		const uint8_t *bytes = (const uint8_t *)data;
+		if (cnt * sizeof(CodeUnit) >= 2) {
+			pairs.emplace_back(bytes[0], bytes[1]);
+
+		} else if (_seq.size() < 2) {
+			pairs.emplace_back(bytes[0], -1);
+
+		} else { // single byte codepoint followed by next codepoint's first byte
+			const auto &next = _seq[1];
+			pairs.emplace_back(bytes[0], *(const uint8_t *)next.BaseData());
+			if (!_case_sensitive && next.AltCnt()) {
+				pairs.emplace_back(bytes[0], *(const uint8_t *)next.AltData());
+			}
+		}
+	}
+
+	virtual void GetLeadingPairs(std::vector<std::pair<uint8_t, int>> &pairs) const
+	{
+		AppendLeadingPair(pairs, _seq[0].BaseData(), _seq[0].BaseCnt());
+		if (!_case_sensitive && _seq[0].AltCnt()) {
+			AppendLeadingPair(pairs, _seq[0].AltData(), _seq[0].AltCnt());
+		}
+	}
+
 public:
 	ScannedPattern(bool case_sensitive, bool whole_words, bool foreign_endian)
 		: _case_sensitive(case_sensitive), _whole_words(whole_words), _foreign_endian(foreign_endian)
@@ -518,7 +584,7 @@ void FindPattern::AddPattern(ScannedPatternPtr &&new_p)
 	_patterns.emplace_back(std::move(new_p));
 }
 
-void FindPattern::GetReady()
+void FindPattern::GetReady(bool prefilter)
 {
 	_min_pattern_size = std::numeric_limits<size_t>::max();
 	_look_behind = 0;
@@ -532,16 +598,44 @@ void FindPattern::GetReady()
 	}
 	_look_behind = AlignUp(_look_behind, max_code_unit);
 
-	fprintf(stderr, "FindPattern::GetReady: count:%lu MPS=%lu LB=%lu\n",
-		_patterns.size(), _min_pattern_size, _look_behind);
-
 	if (_patterns.empty()) {
 		ThrowPrintf("no patterns defined");
 	}
+
+	std::vector<std::pair<uint8_t, int>> pairs;
+	for (size_t i = 0; prefilter && i != _patterns.size(); ++i) {
+		pairs.clear();
+		_patterns[i]->GetLeadingPairs(pairs);
+		for (const auto &pair : pairs) {
+			_prefilter.AddLeadingPair(i % PatternsPrefilter::BUCKETS, pair.first, pair.second);
+		}
+	}
+	_prefilter.GetReady();
+
+	fprintf(stderr, "FindPattern::GetReady: count:%lu MPS=%lu LB=%lu prefilter:%s\n",
+		_patterns.size(), _min_pattern_size, _look_behind,
+		_prefilter.Usable() ? _prefilter.KernelName() : "none");
 }
 
 std::pair<size_t, size_t> FindPattern::FindMatch(const void *data, size_t len, bool first_fragment, bool last_fragment) const noexcept
 {
+	if (_prefilter.Usable()) {
+		// single pass finding candidates for all patterns, then confirming each by patterns of its buckets
+		const uint8_t *bytes = (const uint8_t *)data;
+		uint8_t buckets = 0;
+		for (size_t pos = 0; (pos = _prefilter.NextCandidate(bytes, len, pos, buckets)) < len; ++pos) {
+			for (size_t i = 0; i != _patterns.size(); ++i) {
+				if (buckets & (1u << (i % PatternsPrefilter::BUCKETS))) {
+					const size_t r = _patterns[i]->MatchAt(data, len, pos, first_fragment, last_fragment);
+					if (r) {
+						return std::make_pair(pos, r);
+					}
+				}
+			}
+		}
+		return std::make_pair((size_t)-1, 0);
+	}
+
 	for (const auto &pattern : _patterns) {
 		const auto &r = pattern->FindMatch(data, len, first_fragment, last_fragment);
 		if (r.second) {
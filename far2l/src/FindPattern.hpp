@@ -2,6 +2,7 @@
 #include <vector>
 #include <memory>
 #include <stdint.h>
+#include "PatternsPrefilter.h"
 
 
 typedef std::unique_ptr<struct IScannedPattern> ScannedPatternPtr;
@@ -15,6 +16,7 @@ class FindPattern
 	size_t _look_behind{0};
 
 	std::vector<ScannedPatternPtr> _patterns;
+	PatternsPrefilter _prefilter;
 	void AddPattern(ScannedPatternPtr &&new_p);
 
 public:
@@ -26,8 +28,9 @@ public:
 
 	/**
 		Call this once after all patterns added but before using any other method below.
+		<prefilter> false makes each pattern scan data by its own, without common prefilter pass.
 	*/
-	void GetReady();
+	void GetReady(bool prefilter = true);
 
 	/**
 		Minimal size (in bytes) of content that can match any of added pattern.
@@ -41,6 +44,11 @@ public:
 	*/
 	inline size_t LookBehind() const noexcept { return _look_behind; }
 
+	/**
+		True if FindMatch scans data by single prefilter pass for all patterns.
+	*/
+	inline bool Prefiltered() const noexcept { return _prefilter.Usable(); }
+
 	/**
 		Searches given data array for substring matching any of added pattern.
 		Data array pointer expected to be aligned by size of largest searched codeunit.
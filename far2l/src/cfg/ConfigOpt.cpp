@@ -288,6 +288,7 @@ const ConfigOpt g_cfg_opts[] {
 	{OST_COMMON, NSecSystem, "SudoPasswordExpiration", &Opt.SudoPasswordExpiration, 15 * 60},
 
 	{OST_COMMON, NSecSystem, "UseCOW", &Opt.CMOpt.UseCOW, 0},
+	{OST_COMMON, NSecSystem, "UseIOUring", &Opt.CMOpt.UseIOUring, 1},
 	{OST_COMMON, NSecSystem, "SparseFiles", &Opt.CMOpt.SparseFiles, 0},
 	{OST_COMMON, NSecSystem, "HowCopySymlink", &Opt.CMOpt.HowCopySymlink, 1},
 	{OST_COMMON, NSecSystem, "WriteThrough", &Opt.CMOpt.WriteThrough, 0},
@@ -295,6 +296,7 @@ const ConfigOpt g_cfg_opts[] {
 	{OST_NONE,   NSecSystem, "CopyAccessMode", &Opt.CMOpt.CopyAccessMode, 1},
 	{OST_COMMON, NSecSystem, "MultiCopy", &Opt.CMOpt.MultiCopy, 0},
 	{OST_COMMON, NSecSystem, "CopyTimeRule", &Opt.CMOpt.CopyTimeRule, 3},
+	{OST_COMMON, NSecSystem, "CopyThreads", &Opt.CMOpt.CopyThreads, 0},
 
 	{OST_COMMON, NSecSystem, "MakeLinkSuggestSymlinkAlways", &Opt.MakeLinkSuggestSymlinkAlways, 1},
 
@@ -345,6 +347,7 @@ const ConfigOpt g_cfg_opts[] {
 	{OST_NONE,   NSecSystem, "AllCtrlAltShiftRule", &Opt.AllCtrlAltShiftRule, 0x0000FFFF},
 	{OST_COMMON, NSecSystem, "ScanJunction", &Opt.ScanJunction, 1},
 	{OST_COMMON, NSecSystem, "OnlyFilesSize", &Opt.OnlyFilesSize, 0},
+	{OST_COMMON, NSecSystem, "DirInfoCacheTTL", &Opt.DirInfoCacheTTL, 60},
 	{OST_NONE,   NSecSystem, "UsePrintManager", &Opt.UsePrintManager, 1},
 
 	{OST_COMMON, NSecSystem, "ExcludeCmdHistory", &Opt.ExcludeCmdHistory, 0}, //AN
@@ -171,6 +171,8 @@ void SystemSettings()
 	//	Builder.AddCheckbox(CopyWriteThrough, &Opt.CMOpt.WriteThrough);
 	Builder.AddCheckbox(Msg::ConfigScanJunction, &Opt.ScanJunction);
 	Builder.AddCheckbox(Msg::ConfigOnlyFilesSize, &Opt.OnlyFilesSize);
+	auto DirInfoCacheTTLEdit = Builder.AddIntEditField(&Opt.DirInfoCacheTTL, 5);
+	Builder.AddTextBefore(DirInfoCacheTTLEdit, Msg::ConfigDirInfoCacheTTL);
 
 	auto InactivityExit = Builder.AddCheckbox(Msg::ConfigInactivity, &Opt.InactivityExit);
 	auto InactivityExitTime = Builder.AddIntEditField(&Opt.InactivityExitTime, 2);
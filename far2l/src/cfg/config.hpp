@@ -380,6 +380,8 @@ struct CopyMoveOptions
 	int HowCopySymlink;
 	int SparseFiles;
 	int UseCOW;
+	int UseIOUring;			// Linux: copy big files with several reads/writes in flight via io_uring
+	int CopyThreads;		// threads copying small files bodies: 0 - by CPU count, 1 - copy by main thread only
 };
 
 struct DeleteOptions
@@ -624,6 +626,7 @@ struct Options
 	int UseNumPad;
 	int ScanJunction;
 	int OnlyFilesSize;
+	int DirInfoCacheTTL;	// seconds to remember folders sizes for unchanged folders, 0 - don't remember
 
 	DWORD ShowTimeoutDelFiles;	// таймаут в процессе удаления (в ms)
 	DWORD ShowTimeoutDACLFiles;
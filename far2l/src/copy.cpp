@@ -72,8 +72,11 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "DlgGuid.hpp"
 #include "console.hpp"
 #include "wakeful.hpp"
+#include "IOUring.h"
+#include "ThreadedWorkQueue.h"
 #include <unistd.h>
 #include <algorithm>
+#include <atomic>
 
 #if defined(__APPLE__)
 #include <AvailabilityMacros.h>
@@ -98,7 +101,9 @@ static long OldCalcTime;
 enum
 {
 	COPY_BUFFER_SIZE   = 0x800000,
-	COPY_PIECE_MINIMAL = 0x10000
+	COPY_PIECE_MINIMAL = 0x10000,
+	COPY_BODY_MAXIMAL  = 0x100000,	// larger files are copied by main thread, with own progress and retry prompts
+	COPY_RING_SLOTS    = 4			// pieces in flight when copying via io_uring
 };
 
 enum
@@ -125,6 +130,10 @@ static int UseFilter = FALSE;
 
 static clock_t ProgressUpdateTime;	// Last progress bar update time
 
+static std::atomic<uint64_t> FileBodiesCopiedSize;	// copied by worker threads, not yet added to TotalCopiedSize
+static std::atomic<bool> FileBodiesCancel;
+static std::atomic<bool> IOUringUnavailable;
+
 ShellCopyFileExtendedAttributes::ShellCopyFileExtendedAttributes(File &f)
 {
 	_apply = (f.QueryFileExtendedAttributes(_xattr) != FB_NO && !_xattr.empty());
@@ -566,9 +575,9 @@ static T AlignPageUp(T v)
 	return v;
 }
 
-ShellCopyBuffer::ShellCopyBuffer()
+ShellCopyBuffer::ShellCopyBuffer(DWORD WantCapacity)
 	:
-	Capacity(AlignPageUp((DWORD)COPY_BUFFER_SIZE)),
+	Capacity(AlignPageUp(WantCapacity ? WantCapacity : (DWORD)COPY_BUFFER_SIZE)),
 	Size(std::min((DWORD)COPY_PIECE_MINIMAL, Capacity)),
 	// allocate page-aligned memory: IO works faster on that, also direct-io requires buffer to be aligned sometimes
 	// OSX lacks aligned_malloc so do it manually
@@ -578,9 +587,29 @@ ShellCopyBuffer::ShellCopyBuffer()
 
 ShellCopyBuffer::~ShellCopyBuffer()
 {
+	Ring.reset();	// unregisters buffer
 	delete[] Buffer;
 }
 
+IOUring *ShellCopyBuffer::GetRing()
+{
+	if (!Ring && !IOUringUnavailable) {
+		Ring.reset(new IOUring(COPY_RING_SLOTS * 2));
+		if (Ring->Valid()) {
+			Ring->RegisterBuffer(Ptr, Capacity);
+		} else {
+			IOUringUnavailable = true;	// don't retry for each copy
+			Ring.reset();
+		}
+	}
+	return Ring.get();
+}
+
+void ShellCopyBuffer::DropRing()
+{
+	Ring.reset();
+}
+
 ShellCopy::ShellCopy(Panel *SrcPanel,		// исходная панель (активная)
 		int Move,							// =1 - операция Move
 		int Link,							// =1 - Sym/Hard Link
@@ -1496,6 +1525,25 @@ ShellCopy::~ShellCopy()
 }
 
 COPY_CODES ShellCopy::CopyFileTree(const wchar_t *Dest)
+{
+	StartFileBodies(Dest);
+
+	COPY_CODES CopyCode = CopyFileTreeItems(Dest);
+	if (CopyCode != COPY_SUCCESS) {
+		FinishFileBodies(true);
+		return CopyCode;
+	}
+
+	// directories get their times only after all file bodies within them are written
+	if (!FinishFileBodies(false))
+		return COPY_CANCEL;
+
+	SetEnqueuedDirectoriesAttributes();
+
+	return COPY_SUCCESS;
+}
+
+COPY_CODES ShellCopy::CopyFileTreeItems(const wchar_t *Dest)
 {
 	ChangePriority ChPriority(ChangePriority::NORMAL);
 	// SaveScreen SaveScr;
@@ -1864,8 +1912,6 @@ COPY_CODES ShellCopy::CopyFileTree(const wchar_t *Dest)
 		}
 	}
 
-	SetEnqueuedDirectoriesAttributes();
-
 	return COPY_SUCCESS;	// COPY_SUCCESS_MOVE???
 }
 
@@ -2070,7 +2116,7 @@ COPY_CODES ShellCopy::ShellCopyOneFileNoRetry(const wchar_t *Src, const FAR_FIND
 {
 	CurCopiedSize = 0;	// Сбросить текущий прогресс
 
-	if (CP->Cancelled()) {
+	if (CP->Cancelled() || FileBodiesCancel) {
 		return (COPY_CANCEL);
 	}
 
@@ -2347,6 +2393,11 @@ COPY_CODES ShellCopy::ShellCopyOneFileNoRetry(const wchar_t *Src, const FAR_FIND
 				return (COPY_SUCCESS_MOVE);
 			}
 		} else {
+			if (!Append && !Resume && QueueFileBody(Src, SrcData, strDestPath)) {
+				strCopiedName = PointToName(strDestPath);
+				return COPY_SUCCESS;
+			}
+
 			do {
 				CopyCode = ShellCopyFile(Src, SrcData, strDestPath, Append, Resume);
 			} while (CopyCode == COPY_RETRY);
@@ -2481,6 +2532,7 @@ int ShellCopy::DeleteAfterMove(const wchar_t *Name, DWORD Attr)
 static void ProgressUpdate(bool force, const FAR_FIND_DATA_EX &SrcData, const wchar_t *DestName)
 {
 	if (force || GetProcessUptimeMSec() - ProgressUpdateTime >= PROGRESS_REFRESH_THRESHOLD) {
+		TotalCopiedSize+= FileBodiesCopiedSize.exchange(0);
 		CP->SetProgressValue(CurCopiedSize, SrcData.nFileSize);
 
 		if (ShowTotalCopySize) {
@@ -2496,9 +2548,11 @@ static void ProgressUpdate(bool force, const FAR_FIND_DATA_EX &SrcData, const wc
 /////////////////////////////////////////////////////////// BEGIN OF ShellFileTransfer
 
 ShellFileTransfer::ShellFileTransfer(const wchar_t *SrcName, const FAR_FIND_DATA_EX &SrcData,
-		const FARString &strDestName, bool Append, bool Resume, ShellCopyBuffer &CopyBuffer, COPY_FLAGS &Flags)
+		const FARString &strDestName, bool Append, bool Resume, ShellCopyBuffer &CopyBuffer, COPY_FLAGS &Flags,
+		bool Background)
 	:
-	_SrcName(SrcName), _strDestName(strDestName), _CopyBuffer(CopyBuffer), _Flags(Flags), _SrcData(SrcData)
+	_SrcName(SrcName), _strDestName(strDestName), _CopyBuffer(CopyBuffer), _Flags(Flags), _SrcData(SrcData),
+	_Background(Background)
 {
 	if (!_SrcFile.Open(SrcName, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
 				OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN))
@@ -2589,8 +2643,10 @@ ShellFileTransfer::~ShellFileTransfer()
 		try {
 			fprintf(stderr, "~ShellFileTransfer: discarding '%ls'\n", _strDestName.CPtr());
 			_SrcFile.Close();
-			CP->SetProgressValue(0, 0);
-			CurCopiedSize = 0;	// Сбросить текущий прогресс
+			if (!_Background) {
+				CP->SetProgressValue(0, 0);
+				CurCopiedSize = 0;	// Сбросить текущий прогресс
+			}
 
 			if (_AppendPos != -1) {
 				_DestFile.SetPointer(_AppendPos, nullptr, FILE_BEGIN);
@@ -2604,7 +2660,8 @@ ShellFileTransfer::~ShellFileTransfer()
 				apiDeleteFile(_strDestName);
 			}
 
-			ProgressUpdate(true, _SrcData, _strDestName);
+			if (!_Background)
+				ProgressUpdate(true, _SrcData, _strDestName);
 		} catch (std::exception &ex) {
 			fprintf(stderr, "~ShellFileTransfer: %s\n", ex.what());
 		} catch (...) {
@@ -2612,23 +2669,50 @@ ShellFileTransfer::~ShellFileTransfer()
 		}
 }
 
-void ShellFileTransfer::Do()
+bool ShellFileTransfer::ProgressTick()
 {
-	CP->SetProgressValue(0, 0);
+	if (_Background)
+		return !FileBodiesCancel;
 
-	for (;;) {
-		ProgressUpdate(false, _SrcData, _strDestName);
+	ProgressUpdate(false, _SrcData, _strDestName);
 
-		if (OrigScrX != ScrX || OrigScrY != ScrY) {
-			OrigScrX = ScrX;
-			OrigScrY = ScrY;
-			PR_ShellCopyMsg();
-		}
+	if (OrigScrX != ScrX || OrigScrY != ScrY) {
+		OrigScrX = ScrX;
+		OrigScrY = ScrY;
+		PR_ShellCopyMsg();
+	}
+
+	return !CP->Cancelled();
+}
+
+void ShellFileTransfer::CountCopied(DWORD BytesWritten)
+{
+	_CopiedSize+= BytesWritten;
+	if (!_Background)
+		CurCopiedSize+= BytesWritten;
+
+	if (ShowTotalCopySize) {
+		if (_Background)
+			FileBodiesCopiedSize+= BytesWritten;
+		else
+			TotalCopiedSize+= BytesWritten;
+	}
+}
+
+void ShellFileTransfer::Do()
+{
+	if (!_Background)
+		CP->SetProgressValue(0, 0);
+
+	const bool RingUsed = RingCopy();
+	if (RingUsed && _Interrupted)
+		return;
 
-		if (CP->Cancelled())
+	while (!RingUsed) {
+		if (!ProgressTick())
 			return;
 
-		_Stopwatch = (_SrcData.nFileSize - CurCopiedSize > (uint64_t)_CopyBuffer.Size)
+		_Stopwatch = (_SrcData.nFileSize - _CopiedSize > (uint64_t)_CopyBuffer.Size)
 				? GetProcessUptimeMSec()
 				: 0;
 
@@ -2636,8 +2720,6 @@ void ShellFileTransfer::Do()
 		if (BytesWritten == 0)
 			break;
 
-		CurCopiedSize+= BytesWritten;
-
 		if (_Stopwatch != 0 && BytesWritten == _CopyBuffer.Size) {
 			_Stopwatch = GetProcessUptimeMSec() - _Stopwatch;
 			if (_Stopwatch < 100) {
@@ -2651,8 +2733,7 @@ void ShellFileTransfer::Do()
 			}
 		}
 
-		if (ShowTotalCopySize)
-			TotalCopiedSize+= BytesWritten;
+		CountCopied(BytesWritten);
 	}
 
 	_SrcFile.Close();
@@ -2686,12 +2767,16 @@ void ShellFileTransfer::Do()
 
 	_Done = true;
 
-	ProgressUpdate(false, _SrcData, _strDestName);
+	if (!_Background)
+		ProgressUpdate(false, _SrcData, _strDestName);
 }
 
 void ShellFileTransfer::RetryCancel(const wchar_t *Text, const wchar_t *Object)
 {
 	ErrnoSaver ErSr;
+	if (_Background)
+		throw ErSr;
+
 	_Stopwatch = 0;		// UI messes timings
 	const int MsgCode =
 			Message(_Flags.ErrorMessageFlags, 2, Msg::Error, Text, Object, Msg::Retry, Msg::Cancel);
@@ -2764,7 +2849,7 @@ DWORD ShellFileTransfer::PieceCopy()
 		while (BytesWritten < WriteSize) {
 			const unsigned char *Data = (const unsigned char *)_CopyBuffer.Ptr + BytesWritten;
 			const std::pair<DWORD, DWORD> &NH =
-					LookupNextHole(Data, WriteSize - BytesWritten, CurCopiedSize + BytesWritten);
+					LookupNextHole(Data, WriteSize - BytesWritten, _CopiedSize + BytesWritten);
 			DWORD LeadingNonzeroesWritten = NH.first ? PieceWrite(Data, NH.first) : 0;
 			BytesWritten+= LeadingNonzeroesWritten;
 			if (NH.second && LeadingNonzeroesWritten == NH.first) {
@@ -2814,6 +2899,144 @@ DWORD ShellFileTransfer::PieceWrite(const void *Data, DWORD Size)
 	return BytesWritten;
 }
 
+/*
+	Copies whole file keeping several pieces in flight, so reading of next pieces overlaps
+	with writing of previous ones. Returns false if io_uring not usable for this file,
+	so caller should do usual synchronous piece-by-piece copy.
+*/
+bool ShellFileTransfer::RingCopy()
+{
+	if (!Opt.CMOpt.UseIOUring || _SrcData.nFileSize <= COPY_BODY_MAXIMAL || _AppendPos != -1
+			|| _Flags.SPARSEFILES || _Flags.USECOW || (_DstFlags & FILE_FLAG_NO_BUFFERING) != 0)
+		return false;
+
+	IOUring *Ring = _CopyBuffer.GetRing();
+	if (!Ring)
+		return false;
+
+	struct Slot
+	{
+		uint64_t Offset;
+		DWORD Length;	// requested to read or to write
+		DWORD Done;
+		bool Busy;
+		bool Writing;
+	} Slots[COPY_RING_SLOTS]{};
+
+	const DWORD SlotSize = (_CopyBuffer.Capacity / COPY_RING_SLOTS) & ~(DWORD)(USE_PAGE_SIZE - 1);
+	uint64_t NextOffset = 0, EndOffset = (uint64_t)-1;
+	unsigned InFlight = 0;
+
+	auto Queue = [&](size_t i) {
+		Slot &S = Slots[i];
+		char *Data = _CopyBuffer.Ptr + i * SlotSize + S.Done;
+		return S.Writing
+			? Ring->QueueWrite(_DestFile.Descriptor(), Data, S.Length - S.Done, S.Offset + S.Done, i)
+			: Ring->QueueRead(_SrcFile.Descriptor(), Data, S.Length - S.Done, S.Offset + S.Done, i);
+	};
+
+	auto Issue = [&](size_t i) {
+		if (!Queue(i)) {	// submission queue is full: hand it to kernel and try again
+			if (!Ring->Submit(0))
+				throw ErrnoSaver();
+			if (!Queue(i)) {
+				errno = EBUSY;
+				throw ErrnoSaver();
+			}
+		}
+		++InFlight;
+	};
+
+	// buffer must not be reused and stale completions must not be reaped by next file,
+	// so requests that kernel accepted are waited for even if submitting fails
+	auto Drain = [&]() {
+		uint64_t i;
+		int Result;
+		while (InFlight) {
+			if (!Ring->Submit(InFlight)) {
+				fprintf(stderr, "RingCopy: drain errno=%d\n", errno);
+				InFlight-= Ring->Unqueue();
+				if (InFlight && !Ring->Wait(1)) {
+					fprintf(stderr, "RingCopy: wait errno=%d, %u in flight\n", errno, InFlight);
+					_CopyBuffer.DropRing();
+					break;
+				}
+			}
+			while (Ring->Reap(i, Result))
+				--InFlight;
+		}
+	};
+
+	try {
+		for (;;) {
+			if (!ProgressTick()) {
+				_Interrupted = true;
+				break;
+			}
+
+			for (size_t i = 0; i < COPY_RING_SLOTS && NextOffset < EndOffset; ++i) {
+				if (!Slots[i].Busy) {
+					Slots[i] = Slot{NextOffset, SlotSize, 0, true, false};
+					NextOffset+= SlotSize;
+					Issue(i);
+				}
+			}
+
+			if (!InFlight)
+				break;
+
+			if (!Ring->Submit(1))
+				throw ErrnoSaver();
+
+			uint64_t i;
+			int Result;
+			while (Ring->Reap(i, Result)) {
+				--InFlight;
+				Slot &S = Slots[i];
+				if (Result < 0 || (S.Writing && Result == 0)) {
+					errno = Result ? -Result : ENOSPC;
+					if (S.Writing)
+						RetryCancel(Msg::CopyWriteError, _strDestName);
+					else
+						RetryCancel(Msg::CopyReadError, _SrcName);
+					Issue(i);
+
+				} else if (S.Writing) {
+					S.Done+= Result;
+					CountCopied(Result);
+					if (S.Done < S.Length)
+						Issue(i);
+					else
+						S.Busy = false;
+
+				} else {
+					S.Done+= Result;
+					if (Result != 0 && S.Done < S.Length) {	// short read, EOF not reached yet
+						Issue(i);
+						continue;
+					}
+					if (Result == 0)
+						EndOffset = std::min(EndOffset, S.Offset + S.Done);
+					if (S.Done == 0 || S.Offset >= EndOffset) {		// nothing read or file has been grown
+						S.Busy = false;
+						continue;
+					}
+					S.Writing = true;
+					S.Length = S.Done;
+					S.Done = 0;
+					Issue(i);
+				}
+			}
+		}
+	} catch (...) {
+		Drain();
+		throw;
+	}
+
+	Drain();
+	return true;
+}
+
 /////////////////////////////////////////////////////////// END OF ShellFileTransfer
 
 static dev_t GetRDev(FARString SrcName)
@@ -2884,6 +3107,186 @@ int ShellCopy::ShellCopyFile(const wchar_t *SrcName, const FAR_FIND_DATA_EX &Src
 	return CP->Cancelled() ? COPY_CANCEL : COPY_FAILURE;
 }
 
+/////////////////////////////////////////////////////////// BEGIN OF FileBodyWorkItem
+
+struct ShellCopy::FileBodyWorkItem : IThreadedWorkItem
+{
+	ShellCopy &Owner;
+	FARString strSrcName, strDestName;
+	FAR_FIND_DATA_EX SrcData;
+	COPY_FLAGS Flags;
+	int CopyCode = COPY_FAILURE;
+	int Errno = EIO;
+	uint64_t CopiedSize = 0;
+
+	FileBodyWorkItem(ShellCopy &Owner_, const wchar_t *Src, const FAR_FIND_DATA_EX &SrcData_,
+			const FARString &strDest)
+		:
+		Owner(Owner_), strSrcName(Src), strDestName(strDest), SrcData(SrcData_), Flags(Owner_.Flags)
+	{}
+
+	// invoked in main thread, in same order as items were queued
+	virtual ~FileBodyWorkItem() { Owner.CompleteFileBody(*this); }
+
+	virtual void WorkProc()
+	{
+		if (FileBodiesCancel) {
+			CopyCode = COPY_CANCEL;
+			return;
+		}
+
+		// whole body fits into one piece, so buffer is per item and no adaptive sizing happens
+		ShellCopyBuffer Buffer(std::max((DWORD)SrcData.nFileSize, (DWORD)USE_PAGE_SIZE));
+		Buffer.Size = Buffer.Capacity;
+
+		std::unique_ptr<ShellFileTransfer> Transfer;
+		try {
+			Transfer.reset(new ShellFileTransfer(strSrcName, SrcData, strDestName, false, false, Buffer,
+					Flags, true));
+			Transfer->Do();
+			CopyCode = Transfer->Done() ? COPY_SUCCESS : COPY_CANCEL;
+		} catch (ErrnoSaver &ErSr) {
+			Errno = ErSr.Get();
+		}
+
+		if (Transfer)
+			CopiedSize = Transfer->CopiedSize();
+	}
+};
+
+void ShellCopy::StartFileBodies(const wchar_t *Dest)
+{
+	FileBodiesCancel = false;
+	FileBodiesCopiedSize = 0;
+
+	if (Opt.CMOpt.CopyThreads == 1 || Flags.MOVE || Flags.LINK || SrcPanelMode == PLUGIN_PANEL)
+		return;
+
+#if defined(COW_SUPPORTED) && defined(__APPLE__)
+	if (Flags.USECOW)	// clonefile() is done by ShellCopyFile only
+		return;
+#endif
+
+	FARString strSrcDir, strDestDir;
+	SrcPanel->GetCurDir(strSrcDir);
+	ConvertNameToFull(Dest, strDestDir);
+
+	const MountInfo mi;
+	if (!mi.IsMultiThreadFriendly(strSrcDir.GetMB()) || !mi.IsMultiThreadFriendly(strDestDir.GetMB()))
+		return;
+
+	FileBodyQueue.reset(new ThreadedWorkQueue((size_t)std::max(Opt.CMOpt.CopyThreads, 0)));
+}
+
+bool ShellCopy::QueueFileBody(const wchar_t *Src, const FAR_FIND_DATA_EX &SrcData, const FARString &strDestPath)
+{
+	if (!FileBodyQueue || SrcData.nFileSize > COPY_BODY_MAXIMAL
+			|| (SrcData.dwFileAttributes
+					& (FILE_ATTRIBUTE_DEVICE_FIFO | FILE_ATTRIBUTE_DEVICE_BLOCK | FILE_ATTRIBUTE_DEVICE_CHAR))
+					!= 0)
+		return false;
+
+	FileBodyWorkItem *wi = new (std::nothrow) FileBodyWorkItem(*this, Src, SrcData, strDestPath);
+	if (!wi)
+		return false;
+
+	FileBodyQueue->Queue(wi);
+	ProgressUpdate(false, SrcData, strDestPath);
+	return true;
+}
+
+bool ShellCopy::FinishFileBodies(bool Discard)
+{
+	if (FileBodyQueue) {
+		if (Discard)
+			FileBodiesCancel = true;	// not yet copied bodies are dropped by queue's d-tor
+		else
+			FileBodyQueue->Finalize();
+
+		FileBodyQueue.reset();
+	}
+
+	TotalCopiedSize+= FileBodiesCopiedSize.exchange(0);
+	return !FileBodiesCancel && !CP->Cancelled();
+}
+
+void ShellCopy::CompleteFileBody(FileBodyWorkItem &Item)
+{
+	TotalCopiedSize+= FileBodiesCopiedSize.exchange(0);
+
+	if (Item.CopyCode == COPY_SUCCESS) {
+		TotalFiles++;
+		return;
+	}
+
+	if (Item.CopyCode != COPY_FAILURE || FileBodiesCancel || CP->Cancelled())
+		return;
+
+	// worker doesn't ask anything, so ask here and copy synchronously if user wants to retry
+	uint64_t PartialSize = ShowTotalCopySize ? Item.CopiedSize : 0;
+
+	auto CopyHere = [&]() {
+		TotalCopiedSize-= PartialSize;
+		PartialSize = 0;
+
+		int CopyCode;
+		do {
+			CopyCode = ShellCopyFile(Item.strSrcName, Item.SrcData, Item.strDestName, 0, 0);
+		} while (CopyCode == COPY_RETRY);
+
+		if (CopyCode == COPY_SUCCESS)
+			TotalFiles++;
+		else if (CopyCode == COPY_CANCEL)
+			FileBodiesCancel = true;
+
+		return CopyCode == COPY_SUCCESS || CopyCode == COPY_CANCEL || CopyCode == COPY_NEXT;
+	};
+
+	errno = Item.Errno;
+	if (Item.Errno == EACCES || Item.Errno == EPERM) {
+		// workers are outside of main thread's sudo client region, so let it try again here with sudo
+		if (CopyHere())
+			return;
+	}
+
+	for (;;) {
+		FARString strMsg1 = Item.strSrcName, strMsg2 = Item.strDestName;
+		InsertQuote(strMsg1);
+		InsertQuote(strMsg2);
+
+		int MsgCode;
+
+		if (SkipMode != -1)
+			MsgCode = SkipMode;
+		else {
+			MsgCode = Message(Flags.ErrorMessageFlags, 4, Msg::Error, Msg::CannotCopy, strMsg1,
+					Msg::CannotCopyTo, strMsg2, Msg::CopyRetry, Msg::CopySkip, Msg::CopySkipAll,
+					Msg::CopyCancel);
+		}
+
+		switch (MsgCode) {
+			case -1:
+			case 1:
+			case 2:
+				if (MsgCode == 2)
+					SkipMode = 1;
+
+				TotalCopiedSize = TotalCopiedSize - PartialSize + Item.SrcData.nFileSize;
+				TotalSkippedSize = TotalSkippedSize + Item.SrcData.nFileSize - PartialSize;
+				return;
+			case -2:
+			case 3:
+				FileBodiesCancel = true;
+				return;
+		}
+
+		if (CopyHere())
+			return;
+	}
+}
+
+/////////////////////////////////////////////////////////// END OF FileBodyWorkItem
+
 void ShellCopy::SetDestDizPath(const wchar_t *DestPath)
 {
 	if (!Flags.DIZREAD) {
@@ -39,8 +39,12 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 class Panel;
 
 #include <WinCompat.h>
+#include <memory>
 #include "FARString.hpp"
 
+class ThreadedWorkQueue;
+class IOUring;
+
 enum COPY_CODES
 {
 	COPY_CANCEL,
@@ -94,7 +98,7 @@ public:
 
 struct ShellCopyBuffer
 {
-	ShellCopyBuffer();
+	ShellCopyBuffer(DWORD WantCapacity = 0);
 	~ShellCopyBuffer();
 
 	const DWORD Capacity;
@@ -103,9 +107,13 @@ struct ShellCopyBuffer
 
 private:
 	char *const Buffer;
+	std::unique_ptr<IOUring> Ring;	// created on first demand with this buffer registered
 
 public:
 	char *const Ptr;
+
+	IOUring *GetRing();
+	void DropRing();
 };
 
 class ShellFileTransfer
@@ -116,7 +124,9 @@ class ShellFileTransfer
 	COPY_FLAGS &_Flags;
 	const FAR_FIND_DATA_EX &_SrcData;
 
+	const bool _Background;		// runs on a copy worker thread: no UI, errors are thrown instead of asked about
 	clock_t _Stopwatch = 0;
+	uint64_t _CopiedSize = 0;
 	int64_t _AppendPos = -1;
 	DWORD _DstFlags    = 0;
 	DWORD _ModeToCreateWith = 0;
@@ -124,20 +134,27 @@ class ShellFileTransfer
 	File _SrcFile, _DestFile;
 	bool _LastWriteWasHole = false;
 	bool _Done             = false;
+	bool _Interrupted      = false;
 	std::unique_ptr<ShellCopyFileExtendedAttributes> _XAttrCopyPtr;
 
 	void Undo();
 	void RetryCancel(const wchar_t *Text, const wchar_t *Object);
+	bool ProgressTick();
+	void CountCopied(DWORD BytesWritten);
 	DWORD PieceWrite(const void *Data, DWORD Size);
 	DWORD PieceWriteHole(DWORD Size);
 	DWORD PieceCopy();
+	bool RingCopy();
 
 public:
 	ShellFileTransfer(const wchar_t *SrcName, const FAR_FIND_DATA_EX &SrcData, const FARString &strDestName,
-			bool Append, bool Resume, ShellCopyBuffer &CopyBuffer, COPY_FLAGS &Flags);
+			bool Append, bool Resume, ShellCopyBuffer &CopyBuffer, COPY_FLAGS &Flags, bool Background = false);
 	~ShellFileTransfer();
 
 	void Do();
+
+	bool Done() const { return _Done; }
+	uint64_t CopiedSize() const { return _CopiedSize; }
 };
 
 class ShellCopy
@@ -177,9 +194,18 @@ class ShellCopy
 	void EnqueueDirectoryAttributes(const FAR_FIND_DATA_EX &SrcData, FARString &strDest);
 	void SetEnqueuedDirectoriesAttributes();
 
+	// Bodies of small files copied by worker threads while the tree walk (directories, prompts) goes on
+	struct FileBodyWorkItem;
+	std::unique_ptr<ThreadedWorkQueue> FileBodyQueue;
+	void StartFileBodies(const wchar_t *Dest);
+	bool QueueFileBody(const wchar_t *Src, const FAR_FIND_DATA_EX &SrcData, const FARString &strDestPath);
+	bool FinishFileBodies(bool Discard);
+	void CompleteFileBody(FileBodyWorkItem &Item);
+
 	bool IsSymlinkTargetAlsoCopied(const wchar_t *SymLink);
 
 	COPY_CODES CopyFileTree(const wchar_t *Dest);
+	COPY_CODES CopyFileTreeItems(const wchar_t *Dest);
 	COPY_CODES ShellCopyOneFile(const wchar_t *Src, const FAR_FIND_DATA_EX &SrcData, FARString &strDest,
 			int KeepPathPos, int Rename);
 	COPY_CODES ShellCopyOneFileNoRetry(const wchar_t *Src, const FAR_FIND_DATA_EX &SrcData,
@@ -51,6 +51,386 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "strmix.hpp"
 #include "wakeful.hpp"
 #include "config.hpp"
+#include <map>
+#include <tuple>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <functional>
+
+/*
+	Sizes of folders scanned recently, keyed by folder's device, inode and modification time,
+	so measuring same unchanged folder again (or its subfolder measured as part of its parent)
+	doesn't need to walk it. Folder's mtime changes only when its own entries are added,
+	removed or renamed, so each record also lists all directories of its subtree and they
+	all are re-stat'ed before reusing record. Size change of some file that didn't touch
+	any directory still is not noticed: thats why records expire after Opt.DirInfoCacheTTL
+	seconds, 0 disables remembering at all.
+	Only subtrees that contain no hardlinks, no followed symlinks and no unreadable entries
+	are remembered, so their totals don't depend on what was scanned before them.
+	Used by GetDirInfo and background computation thread, so guarded by mutex.
+*/
+namespace DirInfoCache
+{
+	enum
+	{
+		MIN_ENTRIES = 0x400,	// don't remember smaller subfolders, they're fast to scan anyway
+		MAX_RECORDS = 0x10000
+	};
+
+	struct Key
+	{
+		uint64_t Device, Node, ModTime;
+		DWORD Flags;
+
+		bool operator<(const Key &other) const
+		{
+			return std::tie(Device, Node, ModTime, Flags)
+					< std::tie(other.Device, other.Node, other.ModTime, other.Flags);
+		}
+
+		bool operator==(const Key &other) const
+		{
+			return std::tie(Device, Node, ModTime, Flags)
+					== std::tie(other.Device, other.Node, other.ModTime, other.Flags);
+		}
+	};
+
+	struct Totals
+	{
+		uint32_t DirCount{}, FileCount{};
+		uint64_t FileSize{}, PhysicalSize{};
+		uint64_t Entries{};
+	};
+
+	// Directory inside remembered subtree. Linked one has own record, that is checked same way.
+	struct SubDir
+	{
+		std::string RelPath;
+		Key DirKey;
+		bool Linked;
+	};
+
+	struct Record : Totals
+	{
+		time_t Stored;
+		std::vector<SubDir> SubDirs;
+	};
+
+	static std::mutex s_mutex;
+	static std::map<Key, Record> s_records;
+
+	static Key MakeKey(uint64_t Device, uint64_t Node, const FILETIME &ModTime, DWORD Flags)
+	{
+		return Key{Device, Node, (uint64_t(ModTime.dwHighDateTime) << 32) | ModTime.dwLowDateTime, Flags};
+	}
+
+	static Key MakeKey(const struct stat &s, DWORD Flags)
+	{
+		FILETIME ft;
+		WINPORT(FileTime_UnixToWin32)(s.st_mtim, &ft);
+		return MakeKey(s.st_dev, s.st_ino, ft, Flags);
+	}
+
+	static void Forget(const Key &k)
+	{
+		std::lock_guard<std::mutex> lock(s_mutex);
+		s_records.erase(k);
+	}
+
+	// Path is folder's current full path, its subdirectories are checked relatively to it
+	static bool Lookup(const Key &k, const std::string &Path, Totals &t)
+	{
+		if (Opt.DirInfoCacheTTL <= 0)
+			return false;
+
+		std::vector<SubDir> SubDirs;
+		{
+			std::lock_guard<std::mutex> lock(s_mutex);
+			auto it = s_records.find(k);
+			if (it == s_records.end())
+				return false;
+
+			if (time(nullptr) - it->second.Stored > Opt.DirInfoCacheTTL) {
+				s_records.erase(it);
+				return false;
+			}
+
+			t = it->second;
+			SubDirs = it->second.SubDirs;
+		}
+
+		struct stat s;
+		Totals linked;
+		for (const auto &sd : SubDirs) {
+			const std::string &SubPath = Path + GOOD_SLASH + sd.RelPath;
+			if (sdc_lstat(SubPath.c_str(), &s) != 0 || !S_ISDIR(s.st_mode)
+					|| !(MakeKey(s, sd.DirKey.Flags) == sd.DirKey)
+					|| (sd.Linked && !Lookup(sd.DirKey, SubPath, linked))) {
+				Forget(k);
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// On success takes SubDirs away and returns true
+	static bool Store(const Key &k, const Totals &t, std::vector<SubDir> &SubDirs)
+	{
+		if (t.Entries < MIN_ENTRIES)
+			return false;
+
+		std::lock_guard<std::mutex> lock(s_mutex);
+		if (s_records.size() >= MAX_RECORDS) {
+			s_records.clear();
+		}
+
+		auto &r = s_records[k];
+		static_cast<Totals &>(r) = t;
+		r.Stored = time(nullptr);
+		r.SubDirs.swap(SubDirs);
+		SubDirs.clear();
+		return true;
+	}
+}
+
+/*
+	Walks folder's tree adding its contents to T. Poll invoked for each found entry,
+	its result other than 1 stops walk and returned, otherwise 1 returned when walk done.
+	DirName is passed to ScanTree as is, strFullDirName is its full path for cache.
+*/
+static int WalkDirInfo(const wchar_t *DirName, const FARString &strFullDirName, DirInfoCache::Totals &T,
+		uint32_t &ClusterSize, FileFilter *Filter, DWORD Flags, const std::function<int()> &Poll)
+{
+	FARString strFullName, strCurDirName, strLastDirName;
+	ScanTree ScTree(TRUE, TRUE,
+			((Flags & GETDIRINFO_SCANSYMLINKDEF) ? -1 : ((Flags & GETDIRINFO_SCANSYMLINK) != 0)));
+	FAR_FIND_DATA_EX FindData;
+	ScannedINodes scanned_inodes;
+	const bool count_dir_size = !Opt.OnlyFilesSize;
+	const bool use_filter = (Flags & GETDIRINFO_USEFILTER) != 0;
+	const bool scan_symlinks = ScTree.IsSymlinksScanEnabled();
+	const DWORD cache_flags = (scan_symlinks ? 1 : 0) | (count_dir_size ? 2 : 0);
+	bool use_cache = false;
+
+	auto SinceSnapshot = [&](const DirInfoCache::Totals &start) {
+		DirInfoCache::Totals t = T;
+		t.DirCount-= start.DirCount;
+		t.FileCount-= start.FileCount;
+		t.FileSize-= start.FileSize;
+		t.PhysicalSize-= start.PhysicalSize;
+		t.Entries-= start.Entries;
+		return t;
+	};
+
+	auto AddTotals = [&](const DirInfoCache::Totals &t) {
+		T.DirCount+= t.DirCount;
+		T.FileCount+= t.FileCount;
+		T.FileSize+= t.FileSize;
+		T.PhysicalSize+= t.PhysicalSize;
+		T.Entries+= t.Entries;
+	};
+
+	struct stat s = {0};
+	if (sdc_stat(Wide2MB(DirName).c_str(), &s) == 0) {
+		if (count_dir_size) {	// include size of root dir's node
+			T.FileSize+= s.st_size;
+			T.PhysicalSize+= ((DWORD64)s.st_blocks) * 512;
+		}
+		ClusterSize = s.st_blksize;		// TODO: check if its best thing to be used here
+		use_cache = !use_filter && Opt.DirInfoCacheTTL > 0;
+	}
+
+	// subfolders being scanned, to remember their totals when scan of each finished
+	struct CachingFrame
+	{
+		FARString Path;
+		DirInfoCache::Key Key;
+		DirInfoCache::Totals Start;
+		bool Cacheable;
+		std::vector<DirInfoCache::SubDir> SubDirs;
+	};
+	std::vector<CachingFrame> caching_frames;
+	DirInfoCache::Key root_key{};
+	const DirInfoCache::Totals root_start = T;
+	std::vector<DirInfoCache::SubDir> root_subdirs;
+	bool root_cacheable = true;
+
+	auto Uncacheable = [&]() {
+		if (caching_frames.empty()) {
+			root_cacheable = false;
+		} else {
+			caching_frames.back().Cacheable = false;
+		}
+	};
+
+	auto ParentSubDirs = [&]() -> std::vector<DirInfoCache::SubDir> & {
+		return caching_frames.empty() ? root_subdirs : caching_frames.back().SubDirs;
+	};
+
+	// finished subfolder becomes linked subdir of its parent if remembered, otherwise
+	// parent lists it and all its subdirectories itself
+	auto FinishFrame = [&](CachingFrame &f) {
+		const std::string &Name = Wide2MB(PointToName(f.Path));
+		auto &Parent = ParentSubDirs();
+		const bool Linked = DirInfoCache::Store(f.Key, SinceSnapshot(f.Start), f.SubDirs);
+		Parent.emplace_back(DirInfoCache::SubDir{Name, f.Key, Linked});
+		for (auto &sd : f.SubDirs) {
+			sd.RelPath.insert(0, 1, GOOD_SLASH);
+			sd.RelPath.insert(0, Name);
+			Parent.emplace_back(std::move(sd));
+		}
+	};
+
+	if (use_cache) {
+		root_key = DirInfoCache::MakeKey(s, cache_flags);
+		DirInfoCache::Totals t;
+		if (DirInfoCache::Lookup(root_key, strFullDirName.GetMB(), t)) {
+			AddTotals(t);
+			return 1;
+		}
+	}
+
+	ScTree.SetFindPath(DirName, L"*", FSCANTREE_PARALLEL);
+
+	while (ScTree.GetNextName(&FindData, strFullName)) {
+		const int PollResult = Poll();
+		if (PollResult != 1)
+			return PollResult;
+
+		if (ScTree.IsDirSearchDone()) {
+			// scan of some subfolder finished, frames of subfolders that were not entered are discarded
+			while (use_cache && !caching_frames.empty()) {
+				auto f = std::move(caching_frames.back());
+				caching_frames.pop_back();
+				const bool matched = (f.Path == strFullName);
+				if (matched && f.Cacheable) {
+					FinishFrame(f);
+				} else {
+					Uncacheable();
+				}
+				if (matched)
+					break;
+			}
+			continue;
+		}
+
+		++T.Entries;
+
+		const DWORD file_attributes = FindData.dwFileAttributes;
+		const bool is_directory = (file_attributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+		const bool is_reparse_point = (file_attributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0;
+		const bool is_entered = is_directory && (!is_reparse_point || scan_symlinks);
+
+		if (use_cache) {
+			if ((is_directory && is_reparse_point && scan_symlinks)
+					|| (!is_directory && FindData.nHardLinks > 1)
+					|| (file_attributes & (FILE_ATTRIBUTE_BROKEN | FILE_ATTRIBUTE_REPARSE_POINT))
+							== FILE_ATTRIBUTE_BROKEN) {
+				Uncacheable();
+			}
+		}
+
+		if (!is_directory || count_dir_size) {
+			T.PhysicalSize+= FindData.nPhysicalSize;
+		}
+
+		if (is_reparse_point) {
+			// include symlink's own size to total size
+			if (count_dir_size && sdc_lstat(strFullName.GetMB().c_str(), &s) == 0) {
+				T.FileSize+= s.st_size;
+			}
+
+			T.FileCount++;
+			if (!scan_symlinks)
+				continue;
+		}
+
+		if (!scanned_inodes.Put(FindData.UnixDevice, FindData.UnixNode)) {
+			if (use_cache) {
+				Uncacheable();
+				if (is_entered)
+					caching_frames.push_back(CachingFrame{strFullName, {}, {}, false, {}});
+			}
+			continue;
+		}
+
+		if (is_directory) {
+			/*
+				Счётчик каталогов наращиваем только если не включен фильтр,
+				в противном случае это будем делать в подсчёте количества файлов
+			*/
+			if (!use_filter) {
+				T.DirCount++;
+				if (count_dir_size)
+					T.FileSize+= FindData.nFileSize;
+			} else {
+				/*
+					Если каталог не попадает под фильтр то его надо полностью
+					пропустить - иначе при включенном подсчёте total
+					он учтётся (mantis 551)
+				*/
+				if (Filter->FileInFilter(FindData)) {
+					if (count_dir_size)
+						T.FileSize+= FindData.nFileSize;	// TODO: add size at same condifion as DirCount increment
+				} else
+					ScTree.SkipDir();
+			}
+
+			if (use_cache && is_entered) {
+				const auto key = DirInfoCache::MakeKey(FindData.UnixDevice, FindData.UnixNode,
+						FindData.ftLastWriteTime, cache_flags);
+				DirInfoCache::Totals t;
+				// reusing totals while following symlinks would miss inodes deduplication
+				if (!scan_symlinks && DirInfoCache::Lookup(key, strFullName.GetMB(), t)) {
+					AddTotals(t);
+					ParentSubDirs().emplace_back(
+							DirInfoCache::SubDir{Wide2MB(FindData.strFileName.CPtr()), key, true});
+					ScTree.SkipDir();
+				} else {
+					caching_frames.push_back(CachingFrame{strFullName, key, T, !is_reparse_point, {}});
+				}
+			}
+		} else {
+			/*
+				$ 17.04.2005 KM
+				Проверка попадания файла в условия фильра
+			*/
+			if (use_filter) {
+				if (!Filter->FileInFilter(FindData))
+					continue;
+			}
+
+			/*
+				Наращиваем счётчик каталогов при включенном фильтре только тогда,
+				когда в таком каталоге найден файл, удовлетворяющий условиям
+				фильтра.
+			*/
+			if (use_filter) {
+				strCurDirName = strFullName;
+				CutToSlash(strCurDirName);	//???
+
+				if (StrCmp(strCurDirName, strLastDirName)) {
+					T.DirCount++;
+					strLastDirName = strCurDirName;
+				}
+			}
+
+			T.FileCount++;
+			T.FileSize+= FindData.nFileSize;
+		}
+	}
+
+	if (use_cache && root_cacheable) {
+		DirInfoCache::Store(root_key, SinceSnapshot(root_start), root_subdirs);
+	}
+
+	return 1;
+}
 
 static void DrawGetDirInfoMsg(const wchar_t *Title, const wchar_t *Name, const UINT64 Size)
 {
@@ -82,15 +462,11 @@ int GetDirInfo(const wchar_t *Title, const wchar_t *DirName, uint32_t &DirCount,
 		FileFilter *Filter, DWORD Flags)
 {
 	FARString strFullDirName;
-	FARString strFullName, strCurDirName, strLastDirName;
 	ConvertNameToFull(DirName, strFullDirName);
 	SaveScreen SaveScr;
 	UndoGlobalSaveScrPtr UndSaveScr(&SaveScr);
 	TPreRedrawFuncGuard preRedrawFuncGuard(PR_DrawGetDirInfoMsg);
 	wakeful W;
-	ScanTree ScTree(FALSE, TRUE,
-			((Flags & GETDIRINFO_SCANSYMLINKDEF) ? -1 : ((Flags & GETDIRINFO_SCANSYMLINK) != 0)));
-	FAR_FIND_DATA_EX FindData;
 	clock_t StartTime = GetProcessUptimeMSec();
 	SetCursorType(FALSE, 0);
 	/*
@@ -110,29 +486,11 @@ int GetDirInfo(const wchar_t *Title, const wchar_t *DirName, uint32_t &DirCount,
 	RefreshFrameManager frref(ScrX, ScrY, MsgWaitTime, Flags & GETDIRINFO_DONTREDRAWFRAME);
 	// DWORD SectorsPerCluster=0,BytesPerSector=0,FreeClusters=0,Clusters=0;
 
-	// Временные хранилища имён каталогов
-	strLastDirName.Clear();
-	strCurDirName.Clear();
-	DirCount = FileCount = 0;
-	FileSize = PhysicalSize = 0;
-	ClusterSize = 0;
-	ScTree.SetFindPath(DirName, L"*", 0);
-	ScannedINodes scanned_inodes;
-	const bool count_dir_size = !Opt.OnlyFilesSize;
-	const bool use_filter = (Flags & GETDIRINFO_USEFILTER) != 0;
-	const bool scan_symlinks = ScTree.IsSymlinksScanEnabled();
 	const bool can_break = !CtrlObject->Macro.IsExecuting() && !WinPortTesting();
+	DirInfoCache::Totals T;
+	ClusterSize = 0;
 
-	struct stat s = {0};
-	if (sdc_stat(Wide2MB(DirName).c_str(), &s) == 0) {
-		if (count_dir_size) {	// include size of root dir's node
-			FileSize = s.st_size;
-			PhysicalSize = ((DWORD64)s.st_blocks) * 512;
-		}
-		ClusterSize = s.st_blksize;		// TODO: check if its best thing to be used here
-	}
-
-	while (ScTree.GetNextName(&FindData, strFullName)) {
+	auto Poll = [&]() -> int {
 		if (can_break) {
 			INPUT_RECORD rec;
 
@@ -171,85 +529,161 @@ int GetDirInfo(const wchar_t *Title, const wchar_t *DirName, uint32_t &DirCount,
 				MsgWaitTime = 500;
 				OldTitle.Set(L"%ls %ls", Msg::ScanningFolder.CPtr(), ShowDirName);	// покажем заголовок консоли
 				SetCursorType(FALSE, 0);
-				DrawGetDirInfoMsg(Title, ShowDirName, FileSize);
+				DrawGetDirInfoMsg(Title, ShowDirName, T.FileSize);
 			}
 		}
 
-		const DWORD file_attributes = FindData.dwFileAttributes;
-		const bool is_directory = (file_attributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
-		const bool is_reparse_point = (file_attributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0;
-
-		if (!is_directory || count_dir_size) {
-			PhysicalSize+= FindData.nPhysicalSize;
-		}
+		return 1;
+	};
 
-		if (is_reparse_point) {
-			// include symlink's own size to total size
-			if (count_dir_size && sdc_lstat(strFullName.GetMB().c_str(), &s) == 0) {
-				FileSize+= s.st_size;
-			}
+	const int Result = WalkDirInfo(DirName, strFullDirName, T, ClusterSize, Filter, Flags, Poll);
+	DirCount = T.DirCount;
+	FileCount = T.FileCount;
+	FileSize = T.FileSize;
+	PhysicalSize = T.PhysicalSize;
+	return Result;
+}
 
-			FileCount++;
-			if (!scan_symlinks)
+/*
+	Folders totals computed by single background thread one folder after another.
+	Results are keyed by requester and folder's full path, so panel finds them while
+	computation goes on and also after its items were rebuilt by rereading, while
+	other requester of same folder (like quick view) neither shares nor cancels them.
+	Thread doesn't enter sudo region, so folders that can't be read without sudo are
+	just not counted.
+*/
+class BackgroundDirInfo
+{
+	struct Job
+	{
+		FARString Path;
+		DirInfoTotals Totals;
+		bool Done = false;
+		std::atomic<bool> Cancelled{false};
+	};
+
+	std::mutex _mtx;
+	typedef std::pair<const void *, FARString> JobKey;	// owner and folder's full path
+	std::map<JobKey, std::shared_ptr<Job>> _jobs;
+	std::deque<std::shared_ptr<Job>> _queue;
+	std::thread _thread;
+	bool _thread_running = false;
+
+	void ThreadProc()
+	{
+		std::unique_lock<std::mutex> lock(_mtx);
+		while (!_queue.empty()) {
+			auto job = _queue.front();
+			_queue.pop_front();
+			if (job->Cancelled)
 				continue;
-		}
 
-		if (!scanned_inodes.Put(FindData.UnixDevice, FindData.UnixNode)) {
-			continue;
+			lock.unlock();
+			DirInfoCache::Totals T;
+			uint32_t ClusterSize = 0;
+			clock_t LastPublish = GetProcessUptimeMSec();
+			auto Publish = [&]() {
+				std::lock_guard<std::mutex> publish_lock(_mtx);
+				job->Totals.DirCount = T.DirCount;
+				job->Totals.FileCount = T.FileCount;
+				job->Totals.FileSize = T.FileSize;
+				job->Totals.PhysicalSize = T.PhysicalSize;
+				job->Totals.ClusterSize = ClusterSize;
+			};
+			auto Poll = [&]() -> int {
+				if (job->Cancelled)
+					return 0;
+
+				if ((T.Entries & 0xff) == 0) {
+					const clock_t Now = GetProcessUptimeMSec();
+					if (Now - LastPublish >= 100) {
+						LastPublish = Now;
+						Publish();
+					}
+				}
+				return 1;
+			};
+			const int Result = WalkDirInfo(job->Path, job->Path, T, ClusterSize, nullptr,
+					GETDIRINFO_SCANSYMLINKDEF, Poll);
+			Publish();
+			lock.lock();
+			if (Result == 1)
+				job->Done = true;
 		}
+		_thread_running = false;
+	}
 
-		if (is_directory) {
-			/*
-				Счётчик каталогов наращиваем только если не включен фильтр,
-				в противном случае это будем делать в подсчёте количества файлов
-			*/
-			if (!use_filter) {
-				DirCount++;
-				if (count_dir_size)
-					FileSize+= FindData.nFileSize;
-			} else {
-				/*
-					Если каталог не попадает под фильтр то его надо полностью
-					пропустить - иначе при включенном подсчёте total
-					он учтётся (mantis 551)
-				*/
-				if (Filter->FileInFilter(FindData)) {
-					if (count_dir_size)
-						FileSize+= FindData.nFileSize;	// TODO: add size at same condifion as DirCount increment
-				} else
-					ScTree.SkipDir();
-			}
-		} else {
-			/*
-				$ 17.04.2005 KM
-				Проверка попадания файла в условия фильра
-			*/
-			if (use_filter) {
-				if (!Filter->FileInFilter(FindData))
-					continue;
-			}
+public:
+	~BackgroundDirInfo()
+	{
+		std::unique_lock<std::mutex> lock(_mtx);
+		for (auto &job : _queue) {
+			job->Cancelled = true;
+		}
+		for (auto &it : _jobs) {
+			it.second->Cancelled = true;
+		}
+		lock.unlock();
+		if (_thread.joinable())
+			_thread.join();
+	}
 
-			/*
-				Наращиваем счётчик каталогов при включенном фильтре только тогда,
-				когда в таком каталоге найден файл, удовлетворяющий условиям
-				фильтра.
-			*/
-			if (use_filter) {
-				strCurDirName = strFullName;
-				CutToSlash(strCurDirName);	//???
+	void Start(const void *Owner, const FARString &strFullDirName)
+	{
+		std::lock_guard<std::mutex> lock(_mtx);
+		auto &job = _jobs[JobKey(Owner, strFullDirName)];
+		if (job && !job->Done && !job->Cancelled)
+			return;
+
+		job = std::make_shared<Job>();
+		job->Path = strFullDirName;
+		_queue.emplace_back(job);
+		if (!_thread_running) {
+			if (_thread.joinable())
+				_thread.join();
+			_thread_running = true;
+			_thread = std::thread(&BackgroundDirInfo::ThreadProc, this);
+		}
+	}
 
-				if (StrCmp(strCurDirName, strLastDirName)) {
-					DirCount++;
-					strLastDirName = strCurDirName;
-				}
-			}
+	bool Peek(const void *Owner, const FARString &strFullDirName, DirInfoTotals &Totals, bool &Done)
+	{
+		std::lock_guard<std::mutex> lock(_mtx);
+		auto it = _jobs.find(JobKey(Owner, strFullDirName));
+		if (it == _jobs.end())
+			return false;
+
+		Totals = it->second->Totals;
+		Done = it->second->Done;
+		return true;
+	}
 
-			FileCount++;
-			FileSize+= FindData.nFileSize;
+	void Forget(const void *Owner, const FARString &strFullDirName)
+	{
+		std::lock_guard<std::mutex> lock(_mtx);
+		auto it = _jobs.find(JobKey(Owner, strFullDirName));
+		if (it != _jobs.end()) {
+			it->second->Cancelled = true;
+			_jobs.erase(it);
 		}
 	}
+};
 
-	return 1;
+static BackgroundDirInfo s_background_dir_info;
+
+void StartBackgroundDirInfo(const void *Owner, const FARString &strFullDirName)
+{
+	s_background_dir_info.Start(Owner, strFullDirName);
+}
+
+bool PeekBackgroundDirInfo(const void *Owner, const FARString &strFullDirName, DirInfoTotals &Totals, bool &Done)
+{
+	return s_background_dir_info.Peek(Owner, strFullDirName, Totals, Done);
+}
+
+void ForgetBackgroundDirInfo(const void *Owner, const FARString &strFullDirName)
+{
+	s_background_dir_info.Forget(Owner, strFullDirName);
 }
 
 int GetPluginDirInfo(HANDLE hPlugin, const wchar_t *DirName, uint32_t &DirCount, uint32_t &FileCount,
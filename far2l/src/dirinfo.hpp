@@ -48,5 +48,21 @@ int GetDirInfo(const wchar_t *Title, const wchar_t *DirName, uint32_t &DirCount,
 		uint64_t &FileSize, uint64_t &PhysicalSize, uint32_t &ClusterSize, clock_t MsgWaitTime,
 		FileFilter *Filter, DWORD Flags = GETDIRINFO_SCANSYMLINKDEF);
 
+struct DirInfoTotals
+{
+	uint32_t DirCount{}, FileCount{}, ClusterSize{};
+	uint64_t FileSize{}, PhysicalSize{};
+};
+
+/*
+	Computing folder's totals by background thread, strFullDirName must be full path.
+	Computations are private to Owner (any pointer identifying requester, like panel).
+	Peek gives totals counted so far and returns false if there is no such computation,
+	Forget cancels computation if still running and drops its results.
+*/
+void StartBackgroundDirInfo(const void *Owner, const FARString &strFullDirName);
+bool PeekBackgroundDirInfo(const void *Owner, const FARString &strFullDirName, DirInfoTotals &Totals, bool &Done);
+void ForgetBackgroundDirInfo(const void *Owner, const FARString &strFullDirName);
+
 int GetPluginDirInfo(HANDLE hPlugin, const wchar_t *DirName, uint32_t &DirCount, uint32_t &FileCount,
 		uint64_t &FileSize, uint64_t &PhysicalSize);
@@ -2136,7 +2136,7 @@ static void DoScanTree(HANDLE hDlg, FARString &strRoot)
 			strCurRoot = strRoot;
 		}
 
-		ScTree.SetFindPath(strCurRoot, L"*");
+		ScTree.SetFindPath(strCurRoot, L"*", FSCANTREE_FILESFIRST | FSCANTREE_PARALLEL);
 		itd.SetFindMessage(strCurRoot);
 		FAR_FIND_DATA_EX FindData;
 		FARString strFullName;
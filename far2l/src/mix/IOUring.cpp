@@ -0,0 +1,257 @@
+#include "headers.hpp"
+
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include "IOUring.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+# include <sys/mman.h>
+# include <sys/uio.h>
+# include <sys/syscall.h>
+# include <linux/io_uring.h>
+# if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(__NR_io_uring_register) \
+		&& defined(IORING_FEAT_RW_CUR_POS)
+#  define IOURING_SUPPORTED
+# endif
+#endif
+
+#ifdef IOURING_SUPPORTED
+
+IOUring::IOUring(unsigned entries)
+{
+	struct io_uring_params p {};
+	int fd = (int)syscall(__NR_io_uring_setup, entries, &p);
+	if (fd == -1) {
+		fprintf(stderr, "IOUring: setup errno=%d\n", errno);
+		return;
+	}
+
+	// IORING_OP_READ/WRITE appeared together with IORING_FEAT_RW_CUR_POS (5.6)
+	if ((p.features & IORING_FEAT_RW_CUR_POS) == 0) {
+		fprintf(stderr, "IOUring: kernel too old, features=0x%x\n", p.features);
+		close(fd);
+		return;
+	}
+
+	_sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+	_cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+	if (p.features & IORING_FEAT_SINGLE_MMAP) {
+		_sq_ring_size = _cq_ring_size = std::max(_sq_ring_size, _cq_ring_size);
+	}
+
+	_sq_ring = mmap(nullptr, _sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+			IORING_OFF_SQ_RING);
+	if (_sq_ring == MAP_FAILED) {
+		_sq_ring = nullptr;
+		close(fd);
+		return;
+	}
+
+	if (p.features & IORING_FEAT_SINGLE_MMAP) {
+		_cq_ring = _sq_ring;
+	} else {
+		_cq_ring = mmap(nullptr, _cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+				IORING_OFF_CQ_RING);
+		if (_cq_ring == MAP_FAILED) {
+			_cq_ring = nullptr;
+			munmap(_sq_ring, _sq_ring_size);
+			_sq_ring = nullptr;
+			close(fd);
+			return;
+		}
+	}
+
+	_sqes_size = p.sq_entries * sizeof(io_uring_sqe);
+	void *sqes = mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+			IORING_OFF_SQES);
+	if (sqes == MAP_FAILED) {
+		if (_cq_ring != _sq_ring)
+			munmap(_cq_ring, _cq_ring_size);
+		munmap(_sq_ring, _sq_ring_size);
+		_sq_ring = _cq_ring = nullptr;
+		close(fd);
+		return;
+	}
+	_sqes = (io_uring_sqe *)sqes;
+
+	char *sq = (char *)_sq_ring, *cq = (char *)_cq_ring;
+	_sq_head = (unsigned *)(sq + p.sq_off.head);
+	_sq_tail = (unsigned *)(sq + p.sq_off.tail);
+	_sq_mask = (unsigned *)(sq + p.sq_off.ring_mask);
+	_sq_array = (unsigned *)(sq + p.sq_off.array);
+	_cq_head = (unsigned *)(cq + p.cq_off.head);
+	_cq_tail = (unsigned *)(cq + p.cq_off.tail);
+	_cq_mask = (unsigned *)(cq + p.cq_off.ring_mask);
+	_cqes = (io_uring_cqe *)(cq + p.cq_off.cqes);
+
+	_sq_tail_local = *_sq_tail;
+	_entries = p.sq_entries;
+	_fd = fd;
+}
+
+IOUring::~IOUring()
+{
+	if (_fd == -1)
+		return;
+
+	munmap(_sqes, _sqes_size);
+	if (_cq_ring != _sq_ring)
+		munmap(_cq_ring, _cq_ring_size);
+	munmap(_sq_ring, _sq_ring_size);
+	close(_fd);
+}
+
+bool IOUring::RegisterBuffer(void *buf, size_t len)
+{
+	struct iovec iov = {buf, len};
+	if (syscall(__NR_io_uring_register, _fd, IORING_REGISTER_BUFFERS, &iov, 1) == -1) {
+		fprintf(stderr, "IOUring: register %lu bytes errno=%d\n", (unsigned long)len, errno);
+		return false;
+	}
+
+	_fixed_buf = (const char *)buf;
+	_fixed_len = len;
+	return true;
+}
+
+io_uring_sqe *IOUring::NextSQE()
+{
+	const unsigned head = __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+	if (_sq_tail_local - head >= _entries)
+		return nullptr;
+
+	const unsigned index = _sq_tail_local & *_sq_mask;
+	io_uring_sqe *sqe = &_sqes[index];
+	memset(sqe, 0, sizeof(*sqe));
+	_sq_array[index] = index;
+	++_sq_tail_local;
+	++_to_submit;
+	return sqe;
+}
+
+bool IOUring::Queue(unsigned char opcode, int fd, const void *buf, unsigned len, uint64_t offset,
+		uint64_t user_data)
+{
+	io_uring_sqe *sqe = NextSQE();
+	if (!sqe)
+		return false;
+
+	if (_fixed_buf && (const char *)buf >= _fixed_buf && (const char *)buf + len <= _fixed_buf + _fixed_len) {
+		opcode = (opcode == IORING_OP_READ) ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+		sqe->buf_index = 0;
+	}
+
+	sqe->opcode = opcode;
+	sqe->fd = fd;
+	sqe->addr = (uint64_t)(uintptr_t)buf;
+	sqe->len = len;
+	sqe->off = offset;
+	sqe->user_data = user_data;
+	return true;
+}
+
+bool IOUring::QueueRead(int fd, void *buf, unsigned len, uint64_t offset, uint64_t user_data)
+{
+	return Queue(IORING_OP_READ, fd, buf, len, offset, user_data);
+}
+
+bool IOUring::QueueWrite(int fd, const void *buf, unsigned len, uint64_t offset, uint64_t user_data)
+{
+	return Queue(IORING_OP_WRITE, fd, buf, len, offset, user_data);
+}
+
+bool IOUring::Submit(unsigned wait_nr)
+{
+	__atomic_store_n(_sq_tail, _sq_tail_local, __ATOMIC_RELEASE);
+
+	for (;;) {
+		const int r = (int)syscall(__NR_io_uring_enter, _fd, _to_submit, wait_nr,
+				wait_nr ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+		if (r >= 0) {
+			_to_submit-= std::min((unsigned)r, _to_submit);
+			return true;
+		}
+		if (errno != EINTR)
+			return false;
+	}
+}
+
+unsigned IOUring::Unqueue()
+{
+	// without SQPOLL kernel reads submission queue only within io_uring_enter, so not yet submitted tail is ours
+	const unsigned out = _to_submit;
+	_sq_tail_local-= out;
+	_to_submit = 0;
+	__atomic_store_n(_sq_tail, _sq_tail_local, __ATOMIC_RELEASE);
+	return out;
+}
+
+bool IOUring::Wait(unsigned wait_nr)
+{
+	for (;;) {
+		const int r = (int)syscall(__NR_io_uring_enter, _fd, 0, wait_nr, IORING_ENTER_GETEVENTS, nullptr, 0);
+		if (r >= 0)
+			return true;
+		if (errno != EINTR)
+			return false;
+	}
+}
+
+bool IOUring::Reap(uint64_t &user_data, int &res)
+{
+	const unsigned head = *_cq_head;
+	if (head == __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE))
+		return false;
+
+	const io_uring_cqe &cqe = _cqes[head & *_cq_mask];
+	user_data = cqe.user_data;
+	res = cqe.res;
+	__atomic_store_n(_cq_head, head + 1, __ATOMIC_RELEASE);
+	return true;
+}
+
+#else
+
+IOUring::IOUring(unsigned entries) {}
+
+IOUring::~IOUring() {}
+
+bool IOUring::RegisterBuffer(void *buf, size_t len)
+{
+	return false;
+}
+
+bool IOUring::QueueRead(int fd, void *buf, unsigned len, uint64_t offset, uint64_t user_data)
+{
+	return false;
+}
+
+bool IOUring::QueueWrite(int fd, const void *buf, unsigned len, uint64_t offset, uint64_t user_data)
+{
+	return false;
+}
+
+bool IOUring::Submit(unsigned wait_nr)
+{
+	errno = ENOSYS;
+	return false;
+}
+
+unsigned IOUring::Unqueue()
+{
+	return 0;
+}
+
+bool IOUring::Wait(unsigned wait_nr)
+{
+	errno = ENOSYS;
+	return false;
+}
+
+bool IOUring::Reap(uint64_t &user_data, int &res)
+{
+	return false;
+}
+
+#endif
@@ -0,0 +1,67 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+/*
+	Minimal io_uring submission/completion ring, talks to kernel directly without liburing.
+	Provides only what file copying needs: reads and writes at explicit offsets (optionally
+	into single registered buffer), batched submission and completions reaping.
+	Valid() is false if kernel is too old or io_uring is disabled (sysctl, seccomp, non-Linux),
+	caller should use usual synchronous IO in such case.
+	Not thread-safe: each thread must use own instance.
+*/
+class IOUring
+{
+	int _fd = -1;
+	unsigned _entries = 0;
+
+	void *_sq_ring = nullptr, *_cq_ring = nullptr;
+	size_t _sq_ring_size = 0, _cq_ring_size = 0;
+	io_uring_sqe *_sqes = nullptr;
+	size_t _sqes_size = 0;
+
+	unsigned *_sq_head = nullptr, *_sq_tail = nullptr, *_sq_mask = nullptr, *_sq_array = nullptr;
+	unsigned *_cq_head = nullptr, *_cq_tail = nullptr, *_cq_mask = nullptr;
+	io_uring_cqe *_cqes = nullptr;
+	unsigned _sq_tail_local = 0, _to_submit = 0;
+
+	const char *_fixed_buf = nullptr;
+	size_t _fixed_len = 0;
+
+	io_uring_sqe *NextSQE();
+	bool Queue(unsigned char opcode, int fd, const void *buf, unsigned len, uint64_t offset, uint64_t user_data);
+
+public:
+	IOUring(unsigned entries);
+	~IOUring();
+
+	IOUring(const IOUring &) = delete;
+	IOUring &operator=(const IOUring &) = delete;
+
+	inline bool Valid() const { return _fd != -1; }
+
+	/// Registers buffer so reads/writes within it use fixed-buffer opcodes.
+	/// Returns false if kernel refused (like due to RLIMIT_MEMLOCK), ring remains usable anyway.
+	bool RegisterBuffer(void *buf, size_t len);
+
+	/// Returns false if submission queue is full, Submit() first then.
+	bool QueueRead(int fd, void *buf, unsigned len, uint64_t offset, uint64_t user_data);
+	bool QueueWrite(int fd, const void *buf, unsigned len, uint64_t offset, uint64_t user_data);
+
+	/// Submits queued requests and waits for at least <wait_nr> completions.
+	/// Returns false on error with errno set, some of queued requests may remain not submitted then.
+	bool Submit(unsigned wait_nr);
+
+	/// Takes back queued requests that kernel didn't accept yet, returns their count.
+	unsigned Unqueue();
+
+	/// Waits for at least <wait_nr> completions without submitting anything.
+	/// Returns false on error with errno set.
+	bool Wait(unsigned wait_nr);
+
+	/// Fetches next completion if any: <res> is bytes count or negated errno.
+	bool Reap(uint64_t &user_data, int &res);
+};
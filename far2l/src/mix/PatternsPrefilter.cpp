@@ -0,0 +1,191 @@
+#include <string.h>
+#include "PatternsPrefilter.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+# include <immintrin.h>
+# define PREFILTER_X86
+#elif defined(__aarch64__)
+# include <arm_neon.h>
+# define PREFILTER_NEON
+#endif
+
+static inline uint8_t ExactBuckets(const PatternsPrefilter::Tables &t, const uint8_t *data, size_t len, size_t pos)
+{
+	return (pos + 1 < len) ? (t.first[data[pos]] & t.second[data[pos + 1]]) : (t.first[data[pos]] & t.single);
+}
+
+static size_t KernelScalar(const PatternsPrefilter::Tables &t, const uint8_t *data, size_t len, size_t pos, uint8_t &buckets)
+{
+	for (; pos < len; ++pos) {
+		buckets = ExactBuckets(t, data, len, pos);
+		if (buckets) {
+			return pos;
+		}
+	}
+	return len;
+}
+
+// SIMD kernels find candidates by nibbles masks that may give false positives,
+// so each candidate rechecked by exact tables before returning it
+static inline bool RecheckHits(const PatternsPrefilter::Tables &t, const uint8_t *data, size_t len,
+	size_t &pos, uint32_t hits, uint8_t &buckets)
+{
+	while (hits) {
+		const size_t candidate = pos + __builtin_ctz(hits);
+		buckets = ExactBuckets(t, data, len, candidate);
+		if (buckets) {
+			pos = candidate;
+			return true;
+		}
+		hits&= hits - 1;
+	}
+	return false;
+}
+
+#ifdef PREFILTER_X86
+__attribute__((target("ssse3")))
+static size_t KernelSSSE3(const PatternsPrefilter::Tables &t, const uint8_t *data, size_t len, size_t pos, uint8_t &buckets)
+{
+	const __m128i first_lo = _mm_load_si128((const __m128i *)t.first_lo);
+	const __m128i first_hi = _mm_load_si128((const __m128i *)t.first_hi);
+	const __m128i second_lo = _mm_load_si128((const __m128i *)t.second_lo);
+	const __m128i second_hi = _mm_load_si128((const __m128i *)t.second_hi);
+	const __m128i nibble = _mm_set1_epi8(0x0f);
+	const __m128i zero = _mm_setzero_si128();
+
+	for (; pos + 17 <= len; pos+= 16) {
+		const __m128i b0 = _mm_loadu_si128((const __m128i *)(data + pos));
+		const __m128i b1 = _mm_loadu_si128((const __m128i *)(data + pos + 1));
+		__m128i m = _mm_and_si128(
+			_mm_shuffle_epi8(first_lo, _mm_and_si128(b0, nibble)),
+			_mm_shuffle_epi8(first_hi, _mm_and_si128(_mm_srli_epi16(b0, 4), nibble)));
+		m = _mm_and_si128(m, _mm_shuffle_epi8(second_lo, _mm_and_si128(b1, nibble)));
+		m = _mm_and_si128(m, _mm_shuffle_epi8(second_hi, _mm_and_si128(_mm_srli_epi16(b1, 4), nibble)));
+		const uint32_t hits = (~(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(m, zero))) & 0xffff;
+		if (hits && RecheckHits(t, data, len, pos, hits, buckets)) {
+			return pos;
+		}
+	}
+
+	return KernelScalar(t, data, len, pos, buckets);
+}
+
+__attribute__((target("avx2")))
+static size_t KernelAVX2(const PatternsPrefilter::Tables &t, const uint8_t *data, size_t len, size_t pos, uint8_t &buckets)
+{
+	const __m256i first_lo = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)t.first_lo));
+	const __m256i first_hi = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)t.first_hi));
+	const __m256i second_lo = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)t.second_lo));
+	const __m256i second_hi = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)t.second_hi));
+	const __m256i nibble = _mm256_set1_epi8(0x0f);
+	const __m256i zero = _mm256_setzero_si256();
+
+	for (; pos + 33 <= len; pos+= 32) {
+		const __m256i b0 = _mm256_loadu_si256((const __m256i *)(data + pos));
+		const __m256i b1 = _mm256_loadu_si256((const __m256i *)(data + pos + 1));
+		__m256i m = _mm256_and_si256(
+			_mm256_shuffle_epi8(first_lo, _mm256_and_si256(b0, nibble)),
+			_mm256_shuffle_epi8(first_hi, _mm256_and_si256(_mm256_srli_epi16(b0, 4), nibble)));
+		m = _mm256_and_si256(m, _mm256_shuffle_epi8(second_lo, _mm256_and_si256(b1, nibble)));
+		m = _mm256_and_si256(m, _mm256_shuffle_epi8(second_hi, _mm256_and_si256(_mm256_srli_epi16(b1, 4), nibble)));
+		const uint32_t hits = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(m, zero));
+		if (hits && RecheckHits(t, data, len, pos, hits, buckets)) {
+			return pos;
+		}
+	}
+
+	return KernelSSSE3(t, data, len, pos, buckets);
+}
+#endif
+
+#ifdef PREFILTER_NEON
+static size_t KernelNEON(const PatternsPrefilter::Tables &t, const uint8_t *data, size_t len, size_t pos, uint8_t &buckets)
+{
+	const uint8x16_t first_lo = vld1q_u8(t.first_lo);
+	const uint8x16_t first_hi = vld1q_u8(t.first_hi);
+	const uint8x16_t second_lo = vld1q_u8(t.second_lo);
+	const uint8x16_t second_hi = vld1q_u8(t.second_hi);
+	const uint8x16_t nibble = vdupq_n_u8(0x0f);
+
+	for (; pos + 17 <= len; pos+= 16) {
+		const uint8x16_t b0 = vld1q_u8(data + pos);
+		const uint8x16_t b1 = vld1q_u8(data + pos + 1);
+		uint8x16_t m = vandq_u8(vqtbl1q_u8(first_lo, vandq_u8(b0, nibble)), vqtbl1q_u8(first_hi, vshrq_n_u8(b0, 4)));
+		m = vandq_u8(m, vqtbl1q_u8(second_lo, vandq_u8(b1, nibble)));
+		m = vandq_u8(m, vqtbl1q_u8(second_hi, vshrq_n_u8(b1, 4)));
+		if (vmaxvq_u8(m) != 0) {
+			uint8_t masks[16];
+			vst1q_u8(masks, m);
+			uint32_t hits = 0;
+			for (unsigned i = 0; i < 16; ++i) {
+				if (masks[i]) {
+					hits|= 1u << i;
+				}
+			}
+			if (RecheckHits(t, data, len, pos, hits, buckets)) {
+				return pos;
+			}
+		}
+	}
+
+	return KernelScalar(t, data, len, pos, buckets);
+}
+#endif
+
+PatternsPrefilter::PatternsPrefilter()
+	: _kernel(KernelScalar), _kernel_name("scalar")
+{
+	memset(&_t, 0, sizeof(_t));
+}
+
+void PatternsPrefilter::AddLeadingPair(unsigned bucket, uint8_t first, int second)
+{
+	const uint8_t bit = uint8_t(1u << (bucket % BUCKETS));
+	_t.first[first]|= bit;
+	_t.first_lo[first & 0xf]|= bit;
+	_t.first_hi[first >> 4]|= bit;
+	if (second < 0) {
+		_t.single|= bit;
+		for (unsigned i = 0; i < 256; ++i) {
+			_t.second[i]|= bit;
+		}
+		for (unsigned i = 0; i < 16; ++i) {
+			_t.second_lo[i]|= bit;
+			_t.second_hi[i]|= bit;
+		}
+	} else {
+		_t.second[second]|= bit;
+		_t.second_lo[second & 0xf]|= bit;
+		_t.second_hi[second >> 4]|= bit;
+	}
+}
+
+void PatternsPrefilter::GetReady(bool simd)
+{
+	unsigned first_values = 0;
+	for (unsigned i = 0; i < 256; ++i) {
+		if (_t.first[i]) {
+			++first_values;
+		}
+	}
+	_usable = (first_values != 0 && first_values <= 64);
+
+	_kernel = KernelScalar;
+	_kernel_name = "scalar";
+	if (!simd) {
+		return;
+	}
+#if defined(PREFILTER_X86)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		_kernel = KernelAVX2;
+		_kernel_name = "avx2";
+	} else if (__builtin_cpu_supports("ssse3")) {
+		_kernel = KernelSSSE3;
+		_kernel_name = "ssse3";
+	}
+#elif defined(PREFILTER_NEON)
+	_kernel = KernelNEON;
+	_kernel_name = "neon";
+#endif
+}
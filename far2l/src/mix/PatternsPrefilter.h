@@ -0,0 +1,56 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+	Finds positions in data where any of several patterns may start by checking two leading
+	bytes of each pattern at once for all of them (Teddy-like: each pattern belongs to one of
+	BUCKETS buckets and each byte value maps to mask of buckets it may belong to).
+	Uses SSSE3/AVX2 (detected at runtime) or NEON if available, otherwise plain table lookups.
+	Returned candidates must be confirmed by actual matcher, but no pattern's match is missed.
+*/
+class PatternsPrefilter
+{
+public:
+	enum { BUCKETS = 8 };
+
+	struct Tables
+	{
+		// exact masks of buckets per value of first and second byte
+		uint8_t first[256], second[256];
+		// masks of buckets per low and high nibbles of first and second byte, used by SIMD kernels
+		alignas(16) uint8_t first_lo[16], first_hi[16], second_lo[16], second_hi[16];
+		// buckets having single byte patterns that may match at the very last byte
+		uint8_t single;
+	};
+
+	typedef size_t (*Kernel)(const Tables &t, const uint8_t *data, size_t len, size_t pos, uint8_t &buckets);
+
+private:
+	Tables _t;
+	Kernel _kernel;
+	const char *_kernel_name;
+	bool _usable{false};
+
+public:
+	PatternsPrefilter();
+
+	/// Adds two leading bytes that some pattern from given bucket may start with,
+	/// negative <second> means that pattern is single byte long and any byte may follow it.
+	void AddLeadingPair(unsigned bucket, uint8_t first, int second);
+
+	/// Call after all pairs added. <simd> false forces plain table lookups kernel.
+	void GetReady(bool simd = true);
+
+	/// False if so many byte values may start a pattern that prefiltering would only slow down search.
+	inline bool Usable() const noexcept { return _usable; }
+
+	inline const char *KernelName() const noexcept { return _kernel_name; }
+
+	/// Returns first position at or after <pos> where some pattern may start and sets <buckets> to
+	/// mask of buckets of such patterns. Returns <len> if there is no such position.
+	inline size_t NextCandidate(const uint8_t *data, size_t len, size_t pos, uint8_t &buckets) const noexcept
+	{
+		return _kernel(_t, data, len, pos, buckets);
+	}
+};
@@ -180,6 +180,7 @@ FileList::~FileList()
 {
 	_OT(SysLog(L"[%p] FileList::~FileList()", this));
 	CloseChangeNotification();
+	ForgetBackgroundFolderSizes();
 
 	for (PrevDataItem **i = PrevDataList.First(); i; i = PrevDataList.Next(i))
 		delete *i;
@@ -4294,7 +4295,10 @@ void FileList::CountDirSize(DWORD PluginFlags)
 		if (Item->Selected && (Item->FileAttr & FILE_ATTRIBUTE_DIRECTORY)) {
 			SelDirCount++;
 
-			if ((PanelMode == PLUGIN_PANEL && !(PluginFlags & OPIF_REALNAMES)
+			if (PanelMode == NORMAL_PANEL) {
+				ToggleBackgroundFolderSize(Item);
+
+			} else if ((PanelMode == PLUGIN_PANEL && !(PluginFlags & OPIF_REALNAMES)
 						&& GetPluginDirInfo(hPlugin, Item->strName, DirCount, DirFileCount, FileSize,
 								PhysicalSize))
 					|| ((PanelMode != PLUGIN_PANEL || (PluginFlags & OPIF_REALNAMES))
@@ -4317,7 +4321,10 @@ void FileList::CountDirSize(DWORD PluginFlags)
 
 	if (!SelDirCount) {
 		ASSERT(CurFile < ListData.Count());
-		if ((PanelMode == PLUGIN_PANEL && !(PluginFlags & OPIF_REALNAMES)
+		if (PanelMode == NORMAL_PANEL) {
+			ToggleBackgroundFolderSize(ListData[CurFile]);
+
+		} else if ((PanelMode == PLUGIN_PANEL && !(PluginFlags & OPIF_REALNAMES)
 					&& GetPluginDirInfo(hPlugin, ListData[CurFile]->strName, DirCount, DirFileCount, FileSize,
 							PhysicalSize))
 				|| ((PanelMode != PLUGIN_PANEL || (PluginFlags & OPIF_REALNAMES))
@@ -4344,6 +4351,105 @@ void FileList::CountDirSize(DWORD PluginFlags)
 	CreateChangeNotification(FALSE);	// initially here was TRUE, but size is actually NOT recalculated recursively on deep change, so changing this to FALSE should not break anything, however give MUCH better performance due to inotify is slow on multiple directories
 }
 
+FARString FileList::BackgroundSizeFullName(const FARString &strName)
+{
+	FARString strFullName = strCurDir;
+	if (!TestParentFolderName(strName)) {
+		AddEndSlash(strFullName);
+		strFullName+= strName;
+	}
+	return strFullName;
+}
+
+// Starts computing folder's size in background or cancels computation if its already going on,
+// panel shows size computed so far with '~' prefix until computation done
+void FileList::ToggleBackgroundFolderSize(FileListItem *Item)
+{
+	auto it = BackgroundSizes.find(Item->strName);
+	if (it != BackgroundSizes.end()) {
+		ForgetBackgroundDirInfo(this, it->second.strFullName);
+		BackgroundSizes.erase(it);
+		Item->ShowFolderSize = 0;
+		return;
+	}
+
+	const FARString &strFullName = BackgroundSizeFullName(Item->strName);
+	StartBackgroundDirInfo(this, strFullName);
+	BackgroundSizes.emplace(Item->strName, BackgroundSize{strFullName, {}, false, false});
+	Item->ShowFolderSize = 2;
+	BackgroundSizesTime = 0;
+}
+
+void FileList::UpdateBackgroundFolderSizes()
+{
+	const clock_t Now = GetProcessUptimeMSec();
+	if (Now - BackgroundSizesTime < 300)
+		return;
+
+	BackgroundSizesTime = Now;
+	for (auto &it : BackgroundSizes) {
+		it.second.Known = PeekBackgroundDirInfo(this, it.second.strFullName, it.second.Totals, it.second.Done);
+		// computation vanished or belongs to folder that panel left, so its size won't ever be known here
+		if (PanelMode != NORMAL_PANEL || BackgroundSizeFullName(it.first) != it.second.strFullName)
+			it.second.Known = false;
+	}
+
+	// items are looked up by names as they could be recreated by rereading since computation started
+	bool AnyDone = false;
+	for (auto &Item : ListData) {
+		if (!(Item->FileAttr & FILE_ATTRIBUTE_DIRECTORY))
+			continue;
+
+		auto it = BackgroundSizes.find(Item->strName);
+		if (it == BackgroundSizes.end())
+			continue;
+
+		if (!it->second.Known) {
+			Item->ShowFolderSize = 0;
+			continue;
+		}
+
+		const auto &Totals = it->second.Totals;
+		if (Item->Selected) {
+			SelFileSize-= Item->FileSize;
+			SelFileSize+= Totals.FileSize;
+		}
+		Item->FileSize = Totals.FileSize;
+		Item->PhysicalSize = Totals.PhysicalSize;
+		Item->ShowFolderSize = it->second.Done ? 1 : 2;
+		LargestFilSize = std::max(Totals.FileSize, LargestFilSize);
+		LargestFilSizeL = std::max(Totals.FileSize, LargestFilSizeL);
+		LargestFilPhysSize = std::max(Totals.PhysicalSize, LargestFilPhysSize);
+		if (it->second.Done)
+			AnyDone = true;
+	}
+
+	// finished computations are not needed anymore, as well as unknown ones
+	for (auto it = BackgroundSizes.begin(); it != BackgroundSizes.end();) {
+		if (!it->second.Known || it->second.Done) {
+			ForgetBackgroundDirInfo(this, it->second.strFullName);
+			it = BackgroundSizes.erase(it);
+		} else
+			++it;
+	}
+
+	if (AnyDone) {
+		UpdateAutoColumnWidth();
+		SortFileList(TRUE);
+	}
+
+	if (IsVisible())
+		ShowFileList(TRUE);
+}
+
+void FileList::ForgetBackgroundFolderSizes()
+{
+	for (const auto &it : BackgroundSizes) {
+		ForgetBackgroundDirInfo(this, it.second.strFullName);
+	}
+	BackgroundSizes.clear();
+}
+
 int FileList::GetPrevViewMode()
 {
 	return (PanelMode == PLUGIN_PANEL && !PluginsList.Empty())
@@ -41,6 +41,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "plugins.hpp"
 #include "ConfigRW.hpp"
 #include "FSNotify.h"
+#include "dirinfo.hpp"
 #include <memory>
 #include <map>
 #include <vector>
@@ -221,6 +222,15 @@ private:
 	long CacheSelIndex, CacheSelPos;
 	long CacheSelClearIndex, CacheSelClearPos;
 
+	struct BackgroundSize
+	{
+		FARString strFullName;
+		DirInfoTotals Totals;
+		bool Known, Done;
+	};
+	std::map<FARString, BackgroundSize> BackgroundSizes;	// items names -> their folder sizes computed in background
+	clock_t BackgroundSizesTime{};
+
 private:
 	virtual void SetSelectedFirstMode(int Mode);
 	virtual int GetSelectedFirstMode() { return SelectedFirst; }
@@ -247,6 +257,10 @@ private:
 	// ChangeDir возвращает FALSE, eсли не смогла выставить заданный путь
 	BOOL ChangeDir(const wchar_t *NewDir, BOOL IsUpdated = TRUE);
 	void CountDirSize(DWORD PluginFlags);
+	FARString BackgroundSizeFullName(const FARString &strName);
+	void ToggleBackgroundFolderSize(FileListItem *Item);
+	void UpdateBackgroundFolderSizes();
+	void ForgetBackgroundFolderSizes();
 	/*
 		$ 19.03.2002 DJ
 		IgnoreVisible - обновить, даже если панель невидима
@@ -446,6 +446,9 @@ void FileList::ReadFileNames(int KeepSelection, int IgnoreVisible, int DrawMessa
 */
 int FileList::UpdateIfChanged(int UpdateMode)
 {
+	if (!BackgroundSizes.empty())
+		UpdateBackgroundFolderSizes();
+
 	//_SVS(SysLog(L"CurDir='%ls' Opt.AutoUpdateLimit=%d <= FileCount=%d",CurDir,Opt.AutoUpdateLimit,ListData.Count()));
 	if (!Opt.AutoUpdateLimit || DWORD(ListData.Count()) <= Opt.AutoUpdateLimit) {
 		/*
@@ -67,6 +67,7 @@ QuickView::QuickView()
 
 QuickView::~QuickView()
 {
+	ForgetBackgroundDir();
 	CloseFile();
 	SetMacroMode(TRUE);
 }
@@ -158,7 +159,7 @@ void QuickView::DisplayObject()
 			}
 		}*/
 
-		if (Directory == 1 || Directory == 4) {
+		if (Directory == 1 || Directory == 4 || Directory == 5) {
 			GotoXY(X1 + 2, Y1 + 4);
 			PrintText(Msg::QuickViewContains);
 			GotoXY(X1 + 2, Y1 + 6);
@@ -195,7 +196,7 @@ void QuickView::DisplayObject()
 			FString << ToPercent64(PhysicalSize, FileSize) << L"%";
 			PrintText(FString);
 
-			if (Directory == 1 && ClusterSize) {
+			if ((Directory == 1 || Directory == 5) && ClusterSize) {
 				SetFarColor(COL_PANELTEXT);
 				GotoXY(X1 + 2, Y1 + 12);
 				PrintText(Msg::QuickViewCluster);
@@ -316,10 +317,13 @@ void QuickView::ShowFile(const wchar_t *FileName, int TempFile, HANDLE hDirPlugi
 	CloseFile();
 	QView = nullptr;
 
-	if (!IsVisible())
+	if (!IsVisible()) {
+		ForgetBackgroundDir();
 		return;
+	}
 
 	if (!FileName) {
+		ForgetBackgroundDir();
 		ProcessingPluginCommand++;
 		Show();
 		ProcessingPluginCommand--;
@@ -335,6 +339,8 @@ void QuickView::ShowFile(const wchar_t *FileName, int TempFile, HANDLE hDirPlugi
 
 	bool SameFile = !StrCmp(strCurFileName, FileName);
 	strCurFileName = FileName;
+	if (!SameFile || hDirPlugin)
+		ForgetBackgroundDir();
 	//	size_t pos;
 
 	if (hDirPlugin || (FileAttr != INVALID_FILE_ATTRIBUTES && (FileAttr & FILE_ATTRIBUTE_DIRECTORY))) {
@@ -342,7 +348,7 @@ void QuickView::ShowFile(const wchar_t *FileName, int TempFile, HANDLE hDirPlugi
 		strCurFileType.Clear();
 
 		if (SameFile && !hDirPlugin) {
-			Directory = 1;
+			Directory = strBackgroundDir.IsEmpty() ? 1 : 5;
 		} else if (hDirPlugin) {
 			int ExitCode =
 					GetPluginDirInfo(hDirPlugin, strCurFileName, DirCount, FileCount, FileSize, PhysicalSize);
@@ -350,17 +356,13 @@ void QuickView::ShowFile(const wchar_t *FileName, int TempFile, HANDLE hDirPlugi
 				Directory = 4;
 			else
 				Directory = 3;
-		} else {
-			int ExitCode = GetDirInfo(Msg::QuickViewTitle, strCurFileName, DirCount, FileCount, FileSize,
-					PhysicalSize, ClusterSize, 500, nullptr,
-					GETDIRINFO_ENHBREAK | GETDIRINFO_SCANSYMLINKDEF | GETDIRINFO_DONTREDRAWFRAME);
-
-			if (ExitCode == 1)
-				Directory = 1;
-			else if (ExitCode == -1)
-				Directory = 2;
-			else
-				Directory = 3;
+		} else {	// totals are computed in background and shown as they grow, see UpdateIfChanged
+			ConvertNameToFull(strCurFileName, strBackgroundDir);
+			StartBackgroundDirInfo(this, strBackgroundDir);
+			DirCount = FileCount = ClusterSize = 0;
+			FileSize = PhysicalSize = 0;
+			BackgroundDirTime = 0;
+			Directory = 5;
 		}
 	} else {
 		if (!strCurFileName.IsEmpty()) {
@@ -432,6 +434,14 @@ void QuickView::PrintText(const wchar_t *Str)
 	FS << fmt::Cells() << fmt::Truncate(X2 - 2 - WhereX() + 1) << Str;
 }
 
+void QuickView::ForgetBackgroundDir()
+{
+	if (!strBackgroundDir.IsEmpty()) {
+		ForgetBackgroundDirInfo(this, strBackgroundDir);
+		strBackgroundDir.Clear();
+	}
+}
+
 int QuickView::UpdateIfChanged(int UpdateMode)
 {
 	if (IsVisible() && !strCurFileName.IsEmpty() && Directory == 2) {
@@ -440,6 +450,28 @@ int QuickView::UpdateIfChanged(int UpdateMode)
 		return TRUE;
 	}
 
+	if (Directory == 5 && GetProcessUptimeMSec() - BackgroundDirTime >= 300) {
+		BackgroundDirTime = GetProcessUptimeMSec();
+		DirInfoTotals Totals;
+		bool Done = false;
+		if (!PeekBackgroundDirInfo(this, strBackgroundDir, Totals, Done)) {
+			Directory = 3;
+		} else {
+			DirCount = Totals.DirCount;
+			FileCount = Totals.FileCount;
+			FileSize = Totals.FileSize;
+			PhysicalSize = Totals.PhysicalSize;
+			ClusterSize = Totals.ClusterSize;
+			if (Done) {
+				ForgetBackgroundDir();
+				Directory = 1;
+			}
+		}
+		if (IsVisible())
+			Redraw();
+		return TRUE;
+	}
+
 	return FALSE;
 }
 
@@ -51,6 +51,8 @@ private:
 	CriticalSection CS;
 
 	int Directory;
+	FARString strBackgroundDir;	// full path of folder which totals are computed in background
+	clock_t BackgroundDirTime{};
 	int PrevMacroMode;
 	uint32_t DirCount, FileCount, ClusterSize;
 	uint64_t FileSize, PhysicalSize;
@@ -64,6 +66,7 @@ private:
 	void SetMacroMode(int Restore = FALSE);
 
 	void DynamicUpdateKeyBar();
+	void ForgetBackgroundDir();
 
 public:
 	QuickView();
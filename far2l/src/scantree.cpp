@@ -39,6 +39,239 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "config.hpp"
 #include "pathmix.hpp"
 #include "processname.hpp"
+#include "MountInfo.h"
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <map>
+#include <vector>
+
+struct ScanTreeListing
+{
+	std::vector<FAR_FIND_DATA_EX> Items;
+	std::unique_ptr<FindFile> Rest;		// if directory has more entries: enumeration to continue with
+};
+
+/*
+	Lists directories ahead of ScanTree's depth-first walk by several worker threads.
+	Each listed directory's subdirectories are pushed to the front of pending deque,
+	so idle workers always pick directory that walk will need soonest, going deeper
+	first and spreading siblings of wide directories across all workers.
+	Walk takes ready listings in its own order so results order remains the same as
+	without prefetching. Symlinked subdirectories are never prefetched: they need
+	recursion checks that only walk can do, also workers never ask sudo for anything:
+	such directories are listed by walk itself. Worker lists at most LISTING_CHUNK entries
+	of directory and hands rest of enumeration over to walk that reads it chunk by chunk,
+	so memory use stays bounded while subdirectories of each chunk still get prefetched.
+*/
+class ScanTreePrefetch
+{
+	enum {
+		THREADS = 4,
+		READY_ENTRIES_LIMIT = 0x10000	// pause prefetching when that many entries wait for walk
+	};
+
+public:
+	enum {
+		LISTING_CHUNK = 0x400	// entries read at once, larger directories are read by walk chunk by chunk
+	};
+
+private:
+
+	struct Job
+	{
+		std::wstring Path;	// with trailing slash
+		size_t Depth;
+		bool Running = false, Done = false, Abandoned = false;
+		std::shared_ptr<ScanTreeListing> Listing;
+	};
+
+	std::mutex _mtx;
+	std::condition_variable _cond;
+	std::map<std::wstring, std::shared_ptr<Job>> _jobs;
+	std::deque<std::shared_ptr<Job>> _pending;
+	std::vector<std::thread> _threads;
+	size_t _ready_entries = 0;
+	int _max_depth;
+	const DWORD _find_flags;
+	bool _stop = false;
+
+	void ScheduleLocked(const std::wstring &Path, const ScanTreeListing &Listing, size_t Depth)
+	{
+		if (_max_depth > 0 && Depth > static_cast<size_t>(_max_depth))
+			return;
+
+		auto insert_pos = _pending.begin();
+		for (const auto &Item : Listing.Items) {
+			if ((Item.dwFileAttributes & (FILE_ATTRIBUTE_DIRECTORY | FILE_ATTRIBUTE_REPARSE_POINT))
+					!= FILE_ATTRIBUTE_DIRECTORY)
+				continue;
+
+			auto job = std::make_shared<Job>();
+			job->Path = Path;
+			job->Path.append(Item.strFileName.CPtr(), Item.strFileName.GetLength());
+			job->Path+= LGOOD_SLASH;
+			job->Depth = Depth + 1;
+			if (_jobs.emplace(job->Path, job).second) {
+				insert_pos = _pending.insert(insert_pos, job);
+				++insert_pos;
+			}
+		}
+	}
+
+	void WorkerThread()
+	{
+		std::unique_lock<std::mutex> lock(_mtx);
+		for (;;) {
+			if (_stop)
+				break;
+
+			if (_pending.empty() || (!_pending.front()->Abandoned && _ready_entries >= READY_ENTRIES_LIMIT)) {
+				_cond.wait(lock);
+				continue;
+			}
+
+			auto job = _pending.front();
+			_pending.pop_front();
+			if (job->Abandoned)
+				continue;
+
+			job->Running = true;
+			lock.unlock();
+			auto Listing = List(job->Path, _find_flags);
+			lock.lock();
+			job->Running = false;
+			job->Done = true;
+			if (Listing && !job->Abandoned) {
+				job->Listing = Listing;
+				_ready_entries+= Listing->Items.size();
+				ScheduleLocked(job->Path, *Listing, job->Depth);
+			}
+			_cond.notify_all();
+		}
+	}
+
+public:
+	ScanTreePrefetch(int MaxDepth, DWORD FindFlags) : _max_depth(MaxDepth), _find_flags(FindFlags) {}
+
+	~ScanTreePrefetch()
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mtx);
+			_stop = true;
+		}
+		_cond.notify_all();
+		for (auto &t : _threads) {
+			t.join();
+		}
+	}
+
+	void SetMaxDepth(int MaxDepth)
+	{
+		std::lock_guard<std::mutex> lock(_mtx);
+		_max_depth = MaxDepth;
+	}
+
+	// Returns first LISTING_CHUNK entries of directory with its enumeration to be continued if
+	// there are more of them. Returns nullptr if directory is empty or can't be listed without
+	// help from caller's thread like if it requires sudo or has entries that can't be stat'ed.
+	static std::shared_ptr<ScanTreeListing> List(const std::wstring &Path, DWORD FindFlags)
+	{
+		std::unique_ptr<FindFile> Enumer(new FindFile((Path + L'*').c_str(), false, FindFlags));
+		auto Listing = std::make_shared<ScanTreeListing>();
+		FAR_FIND_DATA_EX fdata;
+		while (Listing->Items.size() < LISTING_CHUNK) {
+			if (!Enumer->Get(fdata)) {
+				Enumer.reset();
+				break;
+			}
+			if ((fdata.dwFileAttributes & (FILE_ATTRIBUTE_BROKEN | FILE_ATTRIBUTE_REPARSE_POINT))
+					== FILE_ATTRIBUTE_BROKEN)
+				return nullptr;
+
+			Listing->Items.emplace_back(std::move(fdata));
+		}
+		if (Listing->Items.empty())
+			return nullptr;
+
+		Listing->Rest = std::move(Enumer);
+		return Listing;
+	}
+
+	// Reads next chunk of directory being enumerated by walk, nullptr if nothing left
+	static std::shared_ptr<ScanTreeListing> ListChunk(FindFile &Enumer)
+	{
+		auto Listing = std::make_shared<ScanTreeListing>();
+		FAR_FIND_DATA_EX fdata;
+		while (Listing->Items.size() < LISTING_CHUNK && Enumer.Get(fdata)) {
+			Listing->Items.emplace_back(std::move(fdata));
+		}
+		if (Listing->Items.empty())
+			return nullptr;
+
+		return Listing;
+	}
+
+	// Returns prefetched listing of given directory, waiting for it if its listing in progress.
+	// If listing not yet started or failed - returns nullptr, caller should list it by itself.
+	std::shared_ptr<ScanTreeListing> Take(const std::wstring &Path)
+	{
+		std::unique_lock<std::mutex> lock(_mtx);
+		auto it = _jobs.find(Path);
+		if (it == _jobs.end())
+			return nullptr;
+
+		auto job = it->second;
+		_jobs.erase(it);
+		if (!job->Running && !job->Done) {
+			job->Abandoned = true;
+			return nullptr;
+		}
+
+		while (!job->Done) {
+			_cond.wait(lock);
+		}
+
+		if (job->Listing) {
+			_ready_entries-= job->Listing->Items.size();
+			_cond.notify_all();
+		}
+		return job->Listing;
+	}
+
+	// Called with listing caller obtained by itself to prefetch its subdirectories
+	void Schedule(const std::wstring &Path, const ScanTreeListing &Listing, size_t Depth)
+	{
+		std::lock_guard<std::mutex> lock(_mtx);
+		ScheduleLocked(Path, Listing, Depth);
+		if (_pending.empty())
+			return;
+
+		if (_threads.empty()) {
+			for (int i = 0; i < THREADS; ++i) {
+				_threads.emplace_back(&ScanTreePrefetch::WorkerThread, this);
+			}
+		}
+		_cond.notify_all();
+	}
+
+	// Walk left given directory, so nothing beneath it will be needed
+	void Purge(const std::wstring &Path)
+	{
+		std::lock_guard<std::mutex> lock(_mtx);
+		for (auto it = _jobs.lower_bound(Path); it != _jobs.end() && StrStartsFrom(it->first, Path.c_str());) {
+			auto &job = *it->second;
+			job.Abandoned = true;
+			if (job.Listing) {
+				_ready_entries-= job.Listing->Items.size();
+				job.Listing.reset();
+			}
+			it = _jobs.erase(it);
+		}
+		_cond.notify_all();
+	}
+};
 
 ScanTree::ScanTree(int RetUpDir, int Recurse, int ScanJunction)
 {
@@ -47,6 +280,17 @@ ScanTree::ScanTree(int RetUpDir, int Recurse, int ScanJunction)
 	Flags.Change(FSCANTREE_SCANSYMLINK, (ScanJunction == -1 ? Opt.ScanJunction : ScanJunction));
 }
 
+ScanTree::~ScanTree()
+{
+}
+
+void ScanTree::SetMaxDepth(int depth)
+{
+	MaxDepth = depth;
+	if (Prefetch)
+		Prefetch->SetMaxDepth(depth);
+}
+
 void ScanTree::SetFindPath(const wchar_t *Path, const wchar_t *Mask, const DWORD NewScanFlags, const wchar_t *ExcludeSubDirMask)
 {
 	Flags.Flags = (Flags.Flags & 0x0000FFFF) | (NewScanFlags & 0xFFFF0000);
@@ -59,6 +303,7 @@ void ScanTree::SetFindPath(const wchar_t *Path, const wchar_t *Mask, const DWORD
 	}
 
 	ScanDirStack.clear();
+	Prefetch.reset();
 
 	if (strFindPath != WGOOD_SLASH) {
 		DeleteEndSlash(strFindPath);
@@ -67,6 +312,12 @@ void ScanTree::SetFindPath(const wchar_t *Path, const wchar_t *Mask, const DWORD
 	ScanDirStack.emplace_back();
 	ConvertNameToReal(strFindPath.c_str(), ScanDirStack.back().RealPath);
 
+	if (Flags.Check(FSCANTREE_PARALLEL) && Flags.Check(FSCANTREE_RECUR)
+			&& !(ExcludeSubDirMask && *ExcludeSubDirMask)
+			&& MountInfo().IsMultiThreadFriendly(ScanDirStack.back().RealPath.GetMB())) {
+		Prefetch.reset(new ScanTreePrefetch(MaxDepth, WinPortFindFlags()));
+	}
+
 	StartEnumSubdir();
 }
 
@@ -128,25 +379,34 @@ void ScanTree::CheckForEnterSubdir(FAR_FIND_DATA_EX *fdata)
 	StartEnumSubdir();
 }
 
-void ScanTree::StartEnumSubdir()
+DWORD ScanTree::WinPortFindFlags() const
 {
-	if (!strFindPath.empty() && strFindPath.back() != LGOOD_SLASH)
-		strFindPath+= LGOOD_SLASH;
-
-	DWORD WinPortFindFlags = 0;
+	DWORD out = 0;
 	if (Flags.Check(FSCANTREE_NOLINKS))
-		WinPortFindFlags|= FIND_FILE_FLAG_NO_LINKS;
+		out|= FIND_FILE_FLAG_NO_LINKS;
 	if (Flags.Check(FSCANTREE_NOFILES))
-		WinPortFindFlags|= FIND_FILE_FLAG_NO_FILES;
+		out|= FIND_FILE_FLAG_NO_FILES;
 	if (Flags.Check(FSCANTREE_NODEVICES))
-		WinPortFindFlags|= FIND_FILE_FLAG_NO_DEVICES;
+		out|= FIND_FILE_FLAG_NO_DEVICES;
 	if (Flags.Check(FSCANTREE_CASE_INSENSITIVE))
-		WinPortFindFlags|= FIND_FILE_FLAG_CASE_INSENSITIVE;
+		out|= FIND_FILE_FLAG_CASE_INSENSITIVE;
+	return out;
+}
+
+void ScanTree::StartEnumSubdir()
+{
+	if (!strFindPath.empty() && strFindPath.back() != LGOOD_SLASH)
+		strFindPath+= LGOOD_SLASH;
+
+	if (Prefetch) {	// listing is taken by first GetNextName() so SkipDir() right after entering costs nothing
+		ScanDirStack.back().Untouched = true;
+		return;
+	}
 
 	strFindPath+= L'*';		// append temporary asterisk
 
 	ScanDirStack.back().Enumer.reset(
-			new FindFile(strFindPath.c_str(), Flags.Check(FSCANTREE_SCANSYMLINK), WinPortFindFlags));
+			new FindFile(strFindPath.c_str(), Flags.Check(FSCANTREE_SCANSYMLINK), WinPortFindFlags()));
 
 	strFindPath.pop_back();		// strip asterisk
 }
@@ -154,6 +414,8 @@ void ScanTree::StartEnumSubdir()
 void ScanTree::LeaveSubdir()
 {
 	if (!ScanDirStack.empty()) {
+		if (Prefetch)
+			Prefetch->Purge(strFindPath);
 		ScanDirStack.pop_back();
 		size_t p = strFindPath.rfind(GOOD_SLASH, strFindPath.size() - 2);
 		if (p != std::string::npos) {
@@ -164,23 +426,75 @@ void ScanTree::LeaveSubdir()
 		fprintf(stderr, "ScanTree::LeaveSubdir() invoked on empty stack!\n");
 }
 
-bool ScanTree::ScanDir::GetNext(FAR_FIND_DATA_EX *fdata, bool FilesFirst)
+// Provides next listing piece of current directory if prefetching: ready one if workers
+// already listed it or next chunk read by walk itself
+bool ScanTree::NextListing()
 {
-	if (Enumer)
+	auto &sd = ScanDirStack.back();
+	if (sd.Untouched) {
+		sd.Untouched = false;
+		sd.Listing = Prefetch->Take(strFindPath);
+		if (sd.Listing) {
+			sd.Enumer = std::move(sd.Listing->Rest);
+			sd.ListingPos = 0;
+			return true;
+		}
+
+		strFindPath+= L'*';
+		sd.Enumer.reset(new FindFile(strFindPath.c_str(), Flags.Check(FSCANTREE_SCANSYMLINK), WinPortFindFlags()));
+		strFindPath.pop_back();
+	}
+
+	if (!sd.Enumer)
+		return false;
+
+	sd.Listing = ScanTreePrefetch::ListChunk(*sd.Enumer);
+	if (!sd.Listing) {
+		sd.Enumer.reset();
+		return false;
+	}
+
+	sd.ListingPos = 0;
+	Prefetch->Schedule(strFindPath, *sd.Listing, ScanDirStack.size());
+	return true;
+}
+
+bool ScanTree::GetNextEntry(FAR_FIND_DATA_EX *fdata)
+{
+	auto &sd = ScanDirStack.back();
+	const bool FilesFirst = Flags.Check(FSCANTREE_FILESFIRST);
+
+	if (Prefetch) {
 		for (;;) {
-			if (!Enumer->Get(*fdata)) {
-				Enumer.reset();
+			if (!sd.Listing || sd.ListingPos == sd.Listing->Items.size()) {
+				sd.Listing.reset();
+				if (!NextListing())
+					break;
+			}
+			auto &Item = sd.Listing->Items[sd.ListingPos++];
+			if (!FilesFirst || (Item.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0) {
+				*fdata = std::move(Item);
+				return true;
+			}
+			sd.Postponed.emplace_back(std::move(Item));
+		}
+
+	} else if (sd.Enumer) {
+		for (;;) {
+			if (!sd.Enumer->Get(*fdata)) {
+				sd.Enumer.reset();
 				break;
 			}
 			if (!FilesFirst || (fdata->dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
 				return true;
 
-			Postponed.emplace_back(std::move(*fdata));
+			sd.Postponed.emplace_back(std::move(*fdata));
 		}
+	}
 
-	if (!Postponed.empty()) {
-		*fdata = std::move(Postponed.front());
-		Postponed.pop_front();
+	if (!sd.Postponed.empty()) {
+		*fdata = std::move(sd.Postponed.front());
+		sd.Postponed.pop_front();
 		return true;
 	}
 
@@ -195,7 +509,7 @@ bool ScanTree::GetNextName(FAR_FIND_DATA_EX *fdata, FARString &strFullName)
 		if (ScanDirStack.empty())
 			return false;
 
-		if (!ScanDirStack.back().GetNext(fdata, Flags.Check(FSCANTREE_FILESFIRST))) {
+		if (!GetNextEntry(fdata)) {
 			if (!Flags.Check(FSCANTREE_RETUPDIR) || ScanDirStack.size() == 1) {
 				LeaveSubdir();
 				continue;
@@ -40,6 +40,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <sys/stat.h>
 #include <unistd.h>
 #include <list>
+#include <memory>
 #include <unordered_set>
 #include <WinCompat.h>
 #include "FARString.hpp"
@@ -61,7 +62,8 @@ enum
 	FSCANTREE_NOFILES          = 0x00020000,	// Don't return files
 	FSCANTREE_NODEVICES        = 0x00040000,	// Don't return devices
 	FSCANTREE_NOLINKS          = 0x00080000,	// Don't return symlinks
-	FSCANTREE_CASE_INSENSITIVE = 0x00100000		// Currently affects only english characters
+	FSCANTREE_CASE_INSENSITIVE = 0x00100000,	// Currently affects only english characters
+	FSCANTREE_PARALLEL         = 0x00200000		// Prefetch subdirectories listings by worker threads if FS allows
 };
 
 class ScannedINodes
@@ -85,6 +87,9 @@ public:
 	inline bool Put(uint64_t d, uint64_t ino) { return _s.emplace(d, ino).second; }
 };
 
+struct ScanTreeListing;
+class ScanTreePrefetch;
+
 class ScanTree
 {
 	BitFlags Flags;
@@ -95,27 +100,33 @@ class ScanTree
 	struct ScanDir
 	{
 		std::unique_ptr<FindFile> Enumer;
+		std::shared_ptr<ScanTreeListing> Listing;	// if prefetching: entries are returned from here
+		size_t ListingPos = 0;
 		std::list<FAR_FIND_DATA_EX> Postponed;
 		FARString RealPath;
 		uint64_t UnixDevice{};
 		uint64_t UnixNode{};
 		bool InsideSymlink = false;
-
-		bool GetNext(FAR_FIND_DATA_EX *fdata, bool FilesFirst);
+		bool Untouched = false;		// if prefetching: neither listing taken nor enumeration started yet
 	};
 	std::list<ScanDir> ScanDirStack;
+	std::unique_ptr<ScanTreePrefetch> Prefetch;
 
+	DWORD WinPortFindFlags() const;
 	void CheckForEnterSubdir(FAR_FIND_DATA_EX *fdata);
 	void StartEnumSubdir();
 	void LeaveSubdir();
+	bool NextListing();
+	bool GetNextEntry(FAR_FIND_DATA_EX *fdata);
 
 public:
 	ScanTree(int RetUpDir, int Recurse = 1, int ScanJunction = -1);
+	~ScanTree();
 
 	// 3-й параметр - флаги из старшего слова
 	void
 	SetFindPath(const wchar_t *Path, const wchar_t *Mask, const DWORD NewScanFlags = FSCANTREE_FILESFIRST, const wchar_t *ExcludeSubDirMask = nullptr);
-	inline void SetMaxDepth(int depth) { MaxDepth = depth;}
+	void SetMaxDepth(int depth);
 	bool GetNextName(FAR_FIND_DATA_EX *fdata, FARString &strFullName);
 
 	void SkipDir();
@@ -0,0 +1,150 @@
+// dirinfo_test: folder totals computed by background thread with remembering of folders sizes enabled
+// must be taken from remembered ones while no directory inside changed, and must count file added deep
+// inside already measured subtree, even though top folder itself is unchanged.
+// Also checks that computations of different owners don't interfere.
+//
+//   dirinfo_test
+
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "headers.hpp"
+#include "dirinfo.hpp"
+#include "config.hpp"
+
+namespace {
+
+int g_failures = 0;
+
+// more than DirInfoCache::MIN_ENTRIES in total, so subtree gets remembered
+const int DEEP_DIRS = 4, DEEP_FILES = 0x200;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+		++g_failures; \
+	} \
+} while (0)
+
+void WriteFile(const std::string &path, const char *body)
+{
+	int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd != -1) {
+		if (write(fd, body, strlen(body)) < 0)
+			perror("write");
+		close(fd);
+	}
+}
+
+void MakeTree(const std::string &root)
+{
+	mkdir(root.c_str(), 0755);
+	mkdir((root + "/big").c_str(), 0755);
+	mkdir((root + "/big/deep").c_str(), 0755);
+	for (int i = 0; i < DEEP_DIRS; ++i) {
+		const std::string d = root + "/big/deep/d" + std::to_string(i);
+		mkdir(d.c_str(), 0755);
+		for (int j = 0; j < DEEP_FILES; ++j) {
+			WriteFile(d + "/f" + std::to_string(j), "x");
+		}
+	}
+	WriteFile(root + "/top", "xyz");
+}
+
+void AppendFile(const std::string &path, const char *body)
+{
+	int fd = open(path.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+	if (fd != -1) {
+		if (write(fd, body, strlen(body)) < 0)
+			perror("write");
+		close(fd);
+	}
+}
+
+bool Compute(const std::string &root, DirInfoTotals &Totals)
+{
+	const FARString strRoot(root);
+	StartBackgroundDirInfo(&Totals, strRoot);
+	for (int i = 0; i < 60000; ++i) {
+		bool Done = false;
+		if (!PeekBackgroundDirInfo(&Totals, strRoot, Totals, Done))
+			break;
+		if (Done) {
+			ForgetBackgroundDirInfo(&Totals, strRoot);
+			return true;
+		}
+		usleep(1000);
+	}
+	fprintf(stderr, "computation of %s not done\n", root.c_str());
+	ForgetBackgroundDirInfo(&Totals, strRoot);
+	return false;
+}
+
+} // namespace
+
+int main()
+{
+	char tmpl[] = "/tmp/dirinfo_test.XXXXXX";
+	if (!mkdtemp(tmpl)) {
+		perror("mkdtemp");
+		return 2;
+	}
+	const std::string root = std::string(tmpl) + "/tree";
+	MakeTree(root);
+
+	Opt.OnlyFilesSize = 1;
+	Opt.DirInfoCacheTTL = 600;
+
+	DirInfoTotals first, second, third, fourth;
+	CHECK(Compute(root, first));
+	CHECK(first.FileCount == DEEP_DIRS * DEEP_FILES + 1);
+	CHECK(first.DirCount == DEEP_DIRS + 2);
+	CHECK(first.FileSize == DEEP_DIRS * DEEP_FILES + 3);
+
+	// file grown in place changes no directory, so remembered totals are given as is
+	AppendFile(root + "/big/deep/d1/f0", "0123456789");
+	CHECK(Compute(root, second));
+	CHECK(second.FileCount == first.FileCount);
+	CHECK(second.FileSize == first.FileSize);
+
+	// modifies only mtime of big/deep/d2, not of root or big: whole tree rescanned
+	WriteFile(root + "/big/deep/d2/new", "12345");
+	CHECK(Compute(root, third));
+	CHECK(third.FileCount == first.FileCount + 1);
+	CHECK(third.FileSize == first.FileSize + 10 + 5);
+	CHECK(third.DirCount == first.DirCount);
+
+	// nothing remembered
+	Opt.DirInfoCacheTTL = 0;
+	AppendFile(root + "/big/deep/d1/f1", "0123456789");
+	CHECK(Compute(root, fourth));
+	CHECK(fourth.FileSize == third.FileSize + 10);
+
+	// forgetting one owner's computation leaves other's one of same folder
+	const FARString strRoot(root);
+	int OwnerA, OwnerB;
+	DirInfoTotals Totals;
+	bool Done = false;
+	StartBackgroundDirInfo(&OwnerA, strRoot);
+	StartBackgroundDirInfo(&OwnerB, strRoot);
+	ForgetBackgroundDirInfo(&OwnerA, strRoot);
+	CHECK(!PeekBackgroundDirInfo(&OwnerA, strRoot, Totals, Done));
+	CHECK(PeekBackgroundDirInfo(&OwnerB, strRoot, Totals, Done));
+	ForgetBackgroundDirInfo(&OwnerB, strRoot);
+
+	const std::string cleanup = std::string("rm -rf '") + tmpl + "'";
+	if (system(cleanup.c_str()) != 0)
+		fprintf(stderr, "cannot remove %s\n", tmpl);
+
+	if (g_failures) {
+		fprintf(stderr, "%d check(s) failed\n", g_failures);
+		return 1;
+	}
+	printf("OK\n");
+	return 0;
+}
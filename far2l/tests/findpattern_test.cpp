@@ -0,0 +1,176 @@
+// findpattern_test: FindPattern::FindMatch with prefilter must find match in exactly same contents as without it,
+// for case-insensitive and whole-words text patterns set up like Find File does for "all codepages" search.
+// As prefiltered scan reports leftmost match of all patterns it also must not be after unprefiltered one.
+//
+//   findpattern_test
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+
+#include "headers.hpp"
+#include "FindPattern.hpp"
+#include "config.hpp"
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+		++g_failures; \
+	} \
+} while (0)
+
+typedef std::vector<uint8_t> Bytes;
+
+// same set as InitInFileSearchText() uses when no codepages selected
+const unsigned int s_codepages[] = {866, 1251, CP_KOI8R, CP_UTF7, CP_UTF8,
+	CP_UTF16LE, CP_UTF16BE, CP_UTF32LE, CP_UTF32BE};
+
+const wchar_t *s_patterns[] = {L"needle", L"Ёлка", L"x", L"wörd-ß"};
+
+// Tokens resembling patterns in different cases, glued to words or split by divisors
+const wchar_t *s_tokens[] = {L"needle", L"NEEDLE", L"NeEdLe", L"needles", L"xneedle", L"needle_", L"nee dle",
+	L"ёлка", L"Ёлка", L"ЁЛКА", L"Ёлкам", L"елка", L"x", L"X", L"xx", L"wörd-ß", L"WÖRD-ß", L"wörd", L"hay", L"stack",
+	L"Иголка", L"0", L"ё"};
+const wchar_t *s_separators[] = {L" ", L"", L",", L".", L"\n", L"\t", L"(", L")", L"_", L"-", L"\r\n"};
+
+Bytes Encode(const std::wstring &text, unsigned int codepage)
+{
+	Bytes out;
+	switch (codepage) {
+		case CP_UTF16LE: case CP_UTF16BE: case CP_UTF32LE: case CP_UTF32BE: {
+			const bool wide = (codepage == CP_UTF32LE || codepage == CP_UTF32BE);
+			const bool be = (codepage == CP_UTF16BE || codepage == CP_UTF32BE);
+			const size_t unit = wide ? 4 : 2;
+			for (wchar_t wc : text) {
+				const uint32_t c = (uint32_t)wc;
+				for (size_t i = 0; i < unit; ++i) {
+					out.emplace_back(uint8_t(c >> (8 * (be ? unit - 1 - i : i))));
+				}
+			}
+		} break;
+
+		default: {
+			const int len = WINPORT(WideCharToMultiByte)(codepage, 0, text.c_str(), (int)text.size(),
+				nullptr, 0, nullptr, nullptr);
+			if (len > 0) {
+				out.resize(len);
+				WINPORT(WideCharToMultiByte)(codepage, 0, text.c_str(), (int)text.size(),
+					(char *)out.data(), len, nullptr, nullptr);
+			}
+		}
+	}
+	return out;
+}
+
+std::wstring MakeText(uint32_t &seed, size_t tokens)
+{
+	std::wstring out;
+	for (size_t i = 0; i < tokens; ++i) {
+		seed = seed * 1103515245 + 12345;
+		out+= s_tokens[(seed >> 16) % ARRAYSIZE(s_tokens)];
+		seed = seed * 1103515245 + 12345;
+		out+= s_separators[(seed >> 16) % ARRAYSIZE(s_separators)];
+	}
+	return out;
+}
+
+std::pair<size_t, size_t> Match(const FindPattern &fp, const Bytes &data, size_t ofs, size_t len, bool first, bool last)
+{
+	// FindMatch expects data aligned by largest codeunit, so copy it into such storage
+	std::vector<uint32_t> aligned((len + 3) / 4 + 1);
+	memcpy(aligned.data(), data.data() + ofs, len);
+	return fp.FindMatch(aligned.data(), len, first, last);
+}
+
+size_t Compare(const FindPattern &plain, const FindPattern &prefiltered, const Bytes &data,
+	size_t ofs, size_t len, bool first, bool last, const char *what)
+{
+	const auto &a = Match(plain, data, ofs, len, first, last);
+	const auto &b = Match(prefiltered, data, ofs, len, first, last);
+	const bool found_a = (a.first != (size_t)-1), found_b = (b.first != (size_t)-1);
+	if (found_a != found_b || (found_a && b.first > a.first)) {
+		fprintf(stderr, "%s: mismatch at ofs=%lu len=%lu first=%d last=%d: {%ld, %lu} vs {%ld, %lu}\n",
+			what, (unsigned long)ofs, (unsigned long)len, first, last,
+			(long)a.first, (unsigned long)a.second, (long)b.first, (unsigned long)b.second);
+		++g_failures;
+	}
+	return found_a ? 1 : 0;
+}
+
+void TestPattern(const wchar_t *pattern, bool case_sensitive, bool whole_words)
+{
+	FindPattern plain(case_sensitive, whole_words), prefiltered(case_sensitive, whole_words);
+	for (auto codepage : s_codepages) {
+		try {	// like InitInFileSearchText() skip codepages that can't represent pattern
+			plain.AddTextPattern(pattern, codepage);
+			prefiltered.AddTextPattern(pattern, codepage);
+
+		} catch (std::exception &e) {
+			fprintf(stderr, "codepage=%u pattern='%ls': %s\n", codepage, pattern, e.what());
+		}
+	}
+	plain.GetReady(false);
+	prefiltered.GetReady(true);
+	CHECK(!plain.Prefiltered());
+	CHECK(prefiltered.Prefiltered());
+
+	char what[128];
+	snprintf(what, sizeof(what), "'%s' case_sensitive=%d whole_words=%d",
+		Wide2MB(pattern).c_str(), case_sensitive, whole_words);
+
+	size_t found = 0, checked = 0;
+	uint32_t seed = 0x1234567;
+	for (auto codepage : s_codepages) {
+		for (int round = 0; round < 40; ++round) {
+			const Bytes &data = Encode(MakeText(seed, 1 + round % 13), codepage);
+			// whole content, then scan windows like ScanFileByMapping() gives: aligned start and
+			// look behind prepended from previous window, so pieces may be not first and/or not last
+			found+= Compare(plain, prefiltered, data, 0, data.size(), true, true, what);
+			++checked;
+			for (size_t ofs = 0; ofs < data.size(); ofs+= 4) {
+				for (size_t len = 1; ofs + len <= data.size(); len+= 1 + len / 3) {
+					const bool last = (ofs + len == data.size());
+					Compare(plain, prefiltered, data, ofs, len, ofs == 0, last, what);
+					if (!last) {
+						Compare(plain, prefiltered, data, ofs, len, ofs == 0, true, what);
+					}
+					++checked;
+				}
+			}
+		}
+	}
+	// make sure corpus isn't degenerate: both matching and not matching contents are there
+	CHECK(found > 0);
+	CHECK(found < ARRAYSIZE(s_codepages) * 40);
+	printf("%s: %lu checks, %lu whole contents matched\n", what, (unsigned long)checked, (unsigned long)found);
+}
+
+} // namespace
+
+int main()
+{
+	// whole words search uses editor's word divisors, so set same as default config has
+	Opt.strWordDiv = L"~!%^&*()+|{}:\"<>?`-=\\[];',./";
+
+	for (auto pattern : s_patterns) {
+		for (bool case_sensitive : {false, true}) {
+			for (bool whole_words : {false, true}) {
+				TestPattern(pattern, case_sensitive, whole_words);
+			}
+		}
+	}
+
+	if (g_failures) {
+		fprintf(stderr, "%d check(s) failed\n", g_failures);
+		return 1;
+	}
+	printf("OK\n");
+	return 0;
+}
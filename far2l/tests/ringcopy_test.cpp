@@ -0,0 +1,139 @@
+// ringcopy_test: file copied by io_uring path (Opt.CMOpt.UseIOUring) must be exactly same as copied by
+// usual piece-by-piece path and as source itself, for small files that never use ring and for large
+// ones that end on, right after and in the middle of ring slots.
+//
+//   ringcopy_test
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <stdint.h>
+
+#include "headers.hpp"
+#include "copy.hpp"
+#include "config.hpp"
+#include "IOUring.h"
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+		++g_failures; \
+	} \
+} while (0)
+
+// around COPY_BODY_MAXIMAL (1 MB) and ring slot size (2 MB: 8 MB buffer / 4 slots)
+const size_t s_sizes[] = {0, 1, 4095, 0x10000, 0x100000, 0x100001, 0x200000 * 4, 0x200000 * 5 + 1,
+	0x300000 + 12345, 0x1400000 + 777};
+
+typedef std::vector<uint8_t> Bytes;
+
+// Pseudo-random contents with zero runs, so sparse-looking pieces are there too
+Bytes MakeContents(size_t size, uint32_t seed)
+{
+	Bytes out(size);
+	for (size_t i = 0; i < size; ++i) {
+		seed = seed * 1103515245 + 12345;
+		out[i] = ((i >> 13) % 5 == 3) ? 0 : uint8_t(seed >> 16);
+	}
+	return out;
+}
+
+bool WriteFile(const std::string &path, const Bytes &body)
+{
+	int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd == -1)
+		return false;
+	const bool ok = body.empty() || write(fd, body.data(), body.size()) == (ssize_t)body.size();
+	close(fd);
+	return ok;
+}
+
+Bytes ReadFile(const std::string &path)
+{
+	Bytes out;
+	int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd != -1) {
+		uint8_t buf[0x10000];
+		for (;;) {
+			const ssize_t r = read(fd, buf, sizeof(buf));
+			if (r <= 0)
+				break;
+			out.insert(out.end(), buf, buf + r);
+		}
+		close(fd);
+	}
+	return out;
+}
+
+bool Copy(const std::string &src, const std::string &dst, bool ring)
+{
+	Opt.CMOpt.UseIOUring = ring ? 1 : 0;
+	const FARString strSrc(src), strDst(dst);
+	FAR_FIND_DATA_EX SrcData;
+	if (!apiGetFindDataEx(strSrc, SrcData))
+		return false;
+
+	ShellCopyBuffer Buffer;
+	COPY_FLAGS Flags;
+	try {
+		ShellFileTransfer Transfer(strSrc, SrcData, strDst, false, false, Buffer, Flags, true);
+		Transfer.Do();
+		return Transfer.Done();
+
+	} catch (std::exception &e) {
+		fprintf(stderr, "copy of %s: %s\n", src.c_str(), e.what());
+	}
+	return false;
+}
+
+} // namespace
+
+int main()
+{
+	char tmpl[] = "/tmp/ringcopy_test.XXXXXX";
+	if (!mkdtemp(tmpl)) {
+		perror("mkdtemp");
+		return 2;
+	}
+	const std::string work = tmpl;
+
+	IOUring probe(2);
+	printf("io_uring %s\n", probe.Valid() ? "available" : "unavailable, only usual copy is checked");
+
+	uint32_t seed = 0x7654321;
+	for (size_t size : s_sizes) {
+		const std::string src = work + "/src", ring = work + "/ring", plain = work + "/plain";
+		const Bytes &body = MakeContents(size, seed++);
+		CHECK(WriteFile(src, body));
+		CHECK(Copy(src, ring, true));
+		CHECK(Copy(src, plain, false));
+
+		const Bytes &ring_body = ReadFile(ring), &plain_body = ReadFile(plain);
+		if (ring_body != body || plain_body != body) {
+			fprintf(stderr, "size=%lu: ring copy %s, usual copy %s\n", (unsigned long)size,
+				ring_body == body ? "OK" : "differs", plain_body == body ? "OK" : "differs");
+			++g_failures;
+		}
+		unlink(src.c_str());
+		unlink(ring.c_str());
+		unlink(plain.c_str());
+	}
+
+	rmdir(work.c_str());
+
+	if (g_failures) {
+		fprintf(stderr, "%d check(s) failed\n", g_failures);
+		return 1;
+	}
+	printf("OK\n");
+	return 0;
+}
@@ -0,0 +1,164 @@
+// scantree_test: ScanTree with FSCANTREE_PARALLEL (prefetching subdirectories listings by worker threads)
+// must return exactly same names in exactly same order as plain scan, also when SkipDir() used, with
+// FSCANTREE_RETUPDIR and FSCANTREE_FILESFIRST and for directories listed in several chunks.
+//
+//   scantree_test
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "headers.hpp"
+#include "scantree.hpp"
+#include "MountInfo.h"
+
+namespace {
+
+int g_failures = 0;
+
+// few times more than ScanTreePrefetch::LISTING_CHUNK
+const int WIDE_ENTRIES = 0x1000 + 17;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+		++g_failures; \
+	} \
+} while (0)
+
+void WriteFile(const std::string &path, const char *body)
+{
+	int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd != -1) {
+		if (write(fd, body, strlen(body)) < 0)
+			perror("write");
+		close(fd);
+	}
+}
+
+// Few levels of nested directories, empty ones, ones to be skipped and
+// one having more entries than walk takes from single listing chunk.
+void MakeTree(const std::string &root)
+{
+	mkdir(root.c_str(), 0755);
+	for (int i = 0; i < 4; ++i) {
+		const std::string d = root + "/d" + std::to_string(i);
+		mkdir(d.c_str(), 0755);
+		WriteFile(d + "/f", "x");
+		mkdir((d + "/empty").c_str(), 0755);
+		mkdir((d + "/skip" + std::to_string(i)).c_str(), 0755);
+		WriteFile(d + "/skip" + std::to_string(i) + "/hidden", "x");
+		mkdir((d + "/skip" + std::to_string(i) + "/deeper").c_str(), 0755);
+		for (int j = 0; j < 3; ++j) {
+			const std::string dd = d + "/n" + std::to_string(j);
+			mkdir(dd.c_str(), 0755);
+			WriteFile(dd + "/g" + std::to_string(j), "x");
+			mkdir((dd + "/m").c_str(), 0755);
+			WriteFile(dd + "/m/h", "x");
+		}
+	}
+	const std::string wide = root + "/wide";
+	mkdir(wide.c_str(), 0755);
+	for (int i = 0; i < WIDE_ENTRIES; ++i) {
+		const std::string name = wide + "/e" + std::to_string(i);
+		if (i % 97 == 0) {
+			mkdir(name.c_str(), 0755);
+			WriteFile(name + "/inner", "x");
+		} else if (i % 211 == 0) {
+			mkdir((wide + "/skip" + std::to_string(i)).c_str(), 0755);
+		} else {
+			WriteFile(name, "x");
+		}
+	}
+	WriteFile(root + "/top", "x");
+}
+
+std::vector<std::string> Scan(const std::string &root, DWORD flags, bool ret_up_dir, bool skip)
+{
+	std::vector<std::string> out;
+	ScanTree st(ret_up_dir ? TRUE : FALSE, TRUE);
+	FAR_FIND_DATA_EX fdata;
+	FARString strFullName;
+	st.SetFindPath(StrMB2Wide(root).c_str(), L"*", flags);
+	while (st.GetNextName(&fdata, strFullName)) {
+		const bool second = st.IsDirSearchDone();
+		std::string line = strFullName.GetMB();
+		if (second)
+			line+= " <up>";
+		out.emplace_back(line);
+		if (skip && !second && (fdata.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0
+				&& fdata.strFileName.Begins(L"skip")) {
+			st.SkipDir();
+		}
+	}
+	return out;
+}
+
+void Compare(const std::string &root, DWORD flags, bool ret_up_dir, bool skip)
+{
+	const auto &plain = Scan(root, flags, ret_up_dir, skip);
+	const auto &parallel = Scan(root, flags | FSCANTREE_PARALLEL, ret_up_dir, skip);
+	CHECK(plain.size() > WIDE_ENTRIES / 2);
+	CHECK(plain.size() == parallel.size());
+	for (size_t i = 0; i != plain.size() && i != parallel.size(); ++i) {
+		if (plain[i] != parallel[i]) {
+			fprintf(stderr, "flags=0x%x retupdir=%d skip=%d: #%lu '%s' vs '%s'\n",
+				(unsigned)flags, ret_up_dir, skip, (unsigned long)i, plain[i].c_str(), parallel[i].c_str());
+			++g_failures;
+			break;
+		}
+	}
+	if (skip) {
+		for (const auto &line : plain) {
+			CHECK(line.find("/hidden") == std::string::npos);
+		}
+	}
+}
+
+} // namespace
+
+int main()
+{
+	char tmpl[] = "/tmp/scantree_test.XXXXXX";
+	if (!mkdtemp(tmpl)) {
+		perror("mkdtemp");
+		return 2;
+	}
+	const std::string work = tmpl;
+
+	// prefetching happens only on multi-thread friendly FS, so force it like user can do
+	const std::string config = work + "/config";
+	mkdir(config.c_str(), 0755);
+	mkdir((config + "/far2l").c_str(), 0755);
+	WriteFile(config + "/far2l/mtfs", "e");
+	setenv("XDG_CONFIG_HOME", config.c_str(), 1);
+	InMyPathChanged();
+
+	const std::string root = work + "/tree";
+	MakeTree(root);
+	CHECK(MountInfo().IsMultiThreadFriendly(root));
+
+	for (DWORD flags : {(DWORD)0, (DWORD)FSCANTREE_FILESFIRST}) {
+		for (bool ret_up_dir : {false, true}) {
+			for (bool skip : {false, true}) {
+				Compare(root, flags, ret_up_dir, skip);
+			}
+		}
+	}
+
+	const std::string cleanup = "rm -rf '" + work + "'";
+	if (system(cleanup.c_str()) != 0)
+		fprintf(stderr, "cannot remove %s\n", work.c_str());
+
+	if (g_failures) {
+		fprintf(stderr, "%d check(s) failed\n", g_failures);
+		return 1;
+	}
+	printf("OK\n");
+	return 0;
+}
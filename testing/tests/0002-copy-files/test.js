@@ -3,16 +3,26 @@ profile=mydir + "/profile"
 left=mydir + "/left"
 left_sub1=mydir + "/left/sub1"
 left_sub2=mydir + "/left/sub2"
+left_many=mydir + "/left/many"
 right=mydir + "/right"
-MkdirsAll([profile, left, left_sub1, left_sub2, right], 0700)
+MkdirsAll([profile, profile + "/.config", left, left_sub1, left_sub2, left_many, right], 0700)
+
+// force multi-threaded disk access, so small files bodies are copied by worker threads whatever filesystem is here
+SaveTextFile(profile + "/.config/mtfs", ["e"])
 
 left_files = [left + "/file1", left + "/file2", left + "/file3"]
 left_sub_files = [left + "/sub1/aaa", left + "/sub1/bbb", left + "/sub1/ccc", left + "/sub2/ddd"]
 Mkfiles(left_files, 0666, 0, 1024)
 Mkfiles(left_sub_files, 0752, 10 * 1024 * 1024, 20 * 1024 * 1024)
 
-left_items = [left + "/file1", left + "/file2", left + "/file3", left + "/sub1", left + "/sub2"]
-right_items = [right + "/file1", right + "/file2", right + "/file3", right + "/sub1", right + "/sub2"]
+left_many_files = []
+for (i = 0; i < 300; ++i) {
+	left_many_files.push(left_many + "/small" + i)
+}
+Mkfiles(left_many_files, 0640, 0, 64 * 1024)
+
+left_items = [left + "/file1", left + "/file2", left + "/file3", left + "/many", left + "/sub1", left + "/sub2"]
+right_items = [right + "/file1", right + "/file2", right + "/file3", right + "/many", right + "/sub1", right + "/sub2"]
 left_hash = HashPathes(left_items, true, true, true, true, true)
 
 StartApp(["--tty", "--nodetect", "--mortal", "-u", profile, "-cd", left, "-cd", right]);
@@ -27,6 +37,7 @@ TypeIns()
 TypeIns()
 TypeIns()
 TypeIns()
+TypeIns()
 TypeFKey(5)
 ExpectString("════ Copy ═════", 0, 0, -1, -1, 10000)
 TypeEnter()